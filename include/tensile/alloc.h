@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Tensile {
+
+// Tensor storage helpers. Linux places a page on the NUMA node of the thread that first writes it, so buffers are
+// initialized with the same static eight-thread split the parallel kernels use: each thread then finds its slice of a
+// fresh tensor in local memory.
+
+// Tensors of at least this many bytes are zeroed lazily by the kernel instead of by a fill.
+static constexpr size_t LAZY_ZERO_BYTES = size_t(1) << 22;
+
+// Below this many bytes the fill stays on the calling thread.
+static constexpr size_t PARALLEL_FILL_BYTES = size_t(1) << 18;
+
+// Anonymous private mapping of `bytes` zero bytes. Nothing is touched here, so each page is zeroed and placed by
+// whichever thread writes or reads it first. Throws std::bad_alloc on failure.
+void* map_zeroed(size_t bytes);
+
+// Releases a region obtained from map_zeroed(). Matches the signature of Tensor's storage release hook.
+void unmap(void* data, size_t bytes);
+
+// Maps the first `bytes` bytes of the file at `path`. With `writable` the mapping is shared and stores reach the file;
+// otherwise they stay private to the process. `create` makes the file (or truncates an existing one) at `bytes` zero
+// bytes first. Pages are read on first access and can be dropped again under memory pressure, so the mapping may be
+// larger than RAM. Release it with unmap(). Throws std::runtime_error if the file cannot be opened or is too short.
+void* map_file(const std::string& path, size_t bytes, bool writable, bool create);
+
+// Paging hints for code that streams over mapped storage. Ranges are widened to whole pages, and failures are
+// ignored since the hints never change results.
+
+// Starts reading the pages in [data, data + bytes) in the background (MADV_WILLNEED).
+void prefetch_pages(const void* data, size_t bytes);
+
+// Marks the pages as the first to reclaim once they are no longer needed (MADV_COLD). Nothing is discarded.
+void evict_pages(const void* data, size_t bytes);
+
+// Starts writing dirty pages of a shared file mapping back to the file without waiting (msync MS_ASYNC).
+void flush_pages(void* data, size_t bytes);
+
+// data[0, n) = value, split over threads in contiguous static slices.
+template <typename T> void first_touch_fill(T* data, size_t n, T value)
+{
+#pragma omp parallel for num_threads(8) schedule(static) if (n * sizeof(T) >= PARALLEL_FILL_BYTES)
+    for (size_t i = 0; i < n; i++)
+        data[i] = value;
+}
+
+}
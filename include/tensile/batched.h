@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Tensile {
+
+// Kernels behind Tensor::inverse/det/transform and the float matmul of [B, N, N] batches, for square matrices of order
+// n up to BATCHED_MAX_ORDER. Matrices are row-major and `stride` floats apart; a stride of 0 repeats one matrix for the
+// whole batch. Outputs are packed.
+//
+// Eight matrices at a time are transposed into struct-of-arrays form, element e of matrix l in lane l of register e,
+// so every arithmetic instruction works on eight matrices. The code for each order is unrolled at compile time.
+inline constexpr size_t BATCHED_MAX_ORDER = 8;
+
+// c[i] = a[i] · b[i]
+void batched_matmul_f32(size_t batch, size_t n, const float* a, size_t a_stride, const float* b, size_t b_stride,
+                        float* c);
+
+// Gauss-Jordan elimination with partial pivoting. Singular matrices give non-finite entries.
+void batched_inverse_f32(size_t batch, size_t n, const float* a, size_t a_stride, float* out);
+
+// LU elimination with partial pivoting.
+void batched_det_f32(size_t batch, size_t n, const float* a, size_t a_stride, float* out);
+
+// out[i] = m[i] · v[i] for vectors of length n. Vectors of length n - 1 are points: they are extended with w = 1 and
+// the result is divided by its w, so an n x n matrix applies a projective (or affine) transform.
+void batched_transform_f32(size_t batch, size_t n, const float* m, size_t m_stride, const float* v, size_t v_stride,
+                           size_t v_len, float* out);
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "half.h"
+
+namespace Tensile {
+
+// How a conversion to a narrower integer type handles values out of its range: keep the low bits (what static_cast
+// does) or clamp to the nearest representable value. Floating-point values converted to integers are always
+// truncated toward zero and clamped, with NaN becoming 0, since the plain cast is undefined out of range.
+enum class CastMode { WRAP, SATURATE };
+
+// Conversions with an AVX2 kernel. Tensor::astype uses these through cast() and falls back to element-by-element
+// conversion for every other pair of types.
+void cast_kernel(const int32_t* src, float* dst, size_t n, CastMode mode);
+void cast_kernel(const float* src, int32_t* dst, size_t n, CastMode mode);
+void cast_kernel(const uint8_t* src, float* dst, size_t n, CastMode mode);
+void cast_kernel(const float* src, uint8_t* dst, size_t n, CastMode mode);
+void cast_kernel(const double* src, float* dst, size_t n, CastMode mode);
+void cast_kernel(const float* src, double* dst, size_t n, CastMode mode);
+void cast_kernel(const int32_t* src, double* dst, size_t n, CastMode mode);
+void cast_kernel(const double* src, int32_t* dst, size_t n, CastMode mode);
+void cast_kernel(const int32_t* src, int16_t* dst, size_t n, CastMode mode);
+void cast_kernel(const int32_t* src, uint16_t* dst, size_t n, CastMode mode);
+void cast_kernel(const int32_t* src, int8_t* dst, size_t n, CastMode mode);
+void cast_kernel(const int32_t* src, uint8_t* dst, size_t n, CastMode mode);
+void cast_kernel(const int64_t* src, int32_t* dst, size_t n, CastMode mode);
+void cast_kernel(const int32_t* src, int64_t* dst, size_t n, CastMode mode);
+
+static constexpr size_t CAST_PARALLEL = 1 << 18;
+
+template <typename D, typename S> inline D cast_value(S x, CastMode mode)
+{
+    if constexpr (HalfType<S>) {
+        return cast_value<D>((float)x, mode);
+    } else if constexpr (HalfType<D>) {
+        return D(x);
+    } else if constexpr (std::integral<D> && !std::same_as<D, bool> && std::floating_point<S>) {
+        if (std::isnan(x))
+            return 0;
+        // Both limits of every integer type are exact doubles, or (the largest ones) round up to a power of two.
+        double v = std::trunc((double)x);
+        if (v <= (double)std::numeric_limits<D>::min())
+            return std::numeric_limits<D>::min();
+        if (v >= (double)std::numeric_limits<D>::max())
+            return std::numeric_limits<D>::max();
+        return (D)v;
+    } else if constexpr (std::integral<D> && !std::same_as<D, bool> && std::integral<S> && !std::same_as<S, bool>) {
+        if (mode == CastMode::SATURATE && !std::in_range<D>(x))
+            return std::cmp_less(x, 0) ? std::numeric_limits<D>::min() : std::numeric_limits<D>::max();
+        return static_cast<D>(x);
+    } else {
+        return static_cast<D>(x);
+    }
+}
+
+// dst[i] = src[i] converted to D, in parallel for large n.
+template <typename S, typename D> void cast(const S* src, D* dst, size_t n, CastMode mode = CastMode::WRAP)
+{
+    if constexpr (std::same_as<S, D>) {
+        std::copy(src, src + n, dst);
+    } else if constexpr (requires { cast_kernel(src, dst, n, mode); }) {
+        cast_kernel(src, dst, n, mode);
+    } else if constexpr ((HalfType<S> && std::same_as<D, float>) || (std::same_as<S, float> && HalfType<D>)) {
+        convert(src, dst, n);
+    } else {
+#pragma omp parallel for num_threads(8) if (n >= CAST_PARALLEL)
+        for (size_t i = 0; i < n; i++)
+            dst[i] = cast_value<D>(src[i], mode);
+    }
+}
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Tensile {
+
+enum class CompareOp { EQ, NE, LT, LE, GT, GE };
+
+// Float kernels behind Tensor's comparisons, allclose, where and masked_select. Masks are one byte per element, 1 for
+// true and 0 for false; any nonzero byte reads as true.
+
+// out[i] = a[i] <op> b[i]. Comparisons with NaN are false, except NE which is true.
+void compare_f32(const float* a, const float* b, uint8_t* out, size_t n, CompareOp op);
+
+// out[i] = a[i] <op> b.
+void compare_scalar_f32(const float* a, float b, uint8_t* out, size_t n, CompareOp op);
+
+// True when |a[i] - b[i]| <= atol + rtol * |b[i]| for every i (or a[i] == b[i], which covers infinities). NaNs only
+// match NaNs, and only with `equal_nan`. Stops at the first chunk that contains a mismatch.
+bool allclose_f32(const float* a, const float* b, size_t n, float rtol, float atol, bool equal_nan);
+
+// out[i] = mask[i] ? a[i] : b[i].
+void where_f32(const uint8_t* mask, const float* a, const float* b, float* out, size_t n);
+
+// Number of nonzero bytes in mask[0, n).
+size_t count_mask(const uint8_t* mask, size_t n);
+
+// Writes the x[i] with mask[i] set to `out` in order and returns how many there were. `out` needs room for
+// count_mask(mask, n) elements.
+size_t masked_select_f32(const float* x, const uint8_t* mask, size_t n, float* out);
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+
+#include "tensor.h"
+
+namespace Tensile {
+
+// Memory order of a 4D image batch: [batch, channels, height, width] or [batch, height, width, channels]. Outputs
+// keep the layout of their input, so neither needs a transpose.
+enum class Layout { NCHW, NHWC };
+
+struct Conv2dParams {
+    size_t stride_h { 1 };
+    size_t stride_w { 1 };
+    size_t pad_h { 0 };
+    size_t pad_w { 0 };
+    size_t dilation_h { 1 };
+    size_t dilation_w { 1 };
+    size_t groups { 1 };
+    Layout layout { Layout::NCHW };
+};
+
+// 2D cross-correlation (the "convolution" of deep learning frameworks) of `input` with `weight`, which is
+// [out_channels, in_channels / groups, kernel_h, kernel_w] in either layout. `bias` ([out_channels]) may be null.
+//
+// Depthwise convolutions (one input channel per group), and in NHWC also small-channel ones (at most 4 input channels
+// per group, e.g. an RGB input layer), run a direct kernel vectorized along the contiguous axis. Everything else is
+// lowered to GEMM through im2col (skipped for 1x1 kernels), with the bias added in the GEMM epilogue; for small-channel
+// NCHW inputs the GEMM, which reuses each input row across output channels, measured faster than the direct kernel.
+Tensor<float> conv2d(const Tensor<float>& input, const Tensor<float>& weight, const Tensor<float>* bias,
+                     const Conv2dParams& params = {});
+
+struct Pool2dParams {
+    size_t kernel_h { 2 };
+    size_t kernel_w { 2 };
+    size_t stride_h { 2 };
+    size_t stride_w { 2 };
+    size_t pad_h { 0 };
+    size_t pad_w { 0 };
+    Layout layout { Layout::NCHW };
+};
+
+// Maximum over each window. Padding never wins.
+Tensor<float> max_pool2d(const Tensor<float>& input, const Pool2dParams& params = {});
+
+// Mean over each window. Padded positions are not counted.
+Tensor<float> avg_pool2d(const Tensor<float>& input, const Pool2dParams& params = {});
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "tensor.h"
+
+namespace Tensile {
+
+// Einstein summation over float tensors: "ij,jk->ik" is a matrix product, "bij,bjk->bik" a batched one, "ii->i" a
+// diagonal and "ij->" a full sum. Labels are single letters. Without "->" the output takes the labels that appear
+// exactly once, in alphabetical order. A full reduction gives a [1] tensor.
+//
+// With more than two operands, pairs are contracted greedily: each step takes the pair with the fewest FLOPs, then
+// the smallest intermediate. Every pairwise contraction is a batched sgemm over strided views of its operands; only
+// an operand whose grouped axes cannot share one stride is copied first.
+Tensor<float> einsum(std::string_view spec, const std::vector<Tensor<float>>& operands);
+
+template <typename... Rest>
+Tensor<float> einsum(std::string_view spec, const Tensor<float>& first, const Rest&... rest)
+{
+    return einsum(spec, std::vector<Tensor<float>> { first, rest... });
+}
+
+// Sums the products of `a` and `b` over the axis pairs (a_axes[i], b_axes[i]). The result has the remaining axes of
+// `a` followed by those of `b`.
+Tensor<float> tensordot(const Tensor<float>& a, const Tensor<float>& b, const std::vector<size_t>& a_axes,
+                        const std::vector<size_t>& b_axes);
+
+// Contracts the last `n` axes of `a` with the first `n` axes of `b`.
+Tensor<float> tensordot(const Tensor<float>& a, const Tensor<float>& b, size_t n);
+
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Tensile {
+
+struct FormatOptions {
+    // Digits after the decimal point for floating types (std::to_string uses 6).
+    int precision { 6 };
+    // Tensors with more elements than this are summarized: each dimension longer than 2 * edge_items shows only its
+    // first and last edge_items entries, with "..." in between.
+    size_t threshold { 1000 };
+    size_t edge_items { 3 };
+};
+
+// Text output that goes either to a string, reserved once up front, or to a stream through a fixed buffer that is
+// flushed whenever it fills. Numbers are written with std::to_chars straight into the buffer.
+class TextWriter {
+public:
+    explicit TextWriter(size_t reserve) { buf_.reserve(reserve); }
+
+    explicit TextWriter(std::ostream& os)
+        : os_(&os)
+    {
+        buf_.reserve(FLUSH_BYTES + MAX_ITEM);
+    }
+
+    TextWriter(const TextWriter&) = delete;
+    TextWriter& operator=(const TextWriter&) = delete;
+
+    ~TextWriter() { flush(); }
+
+    void put(char c)
+    {
+        buf_.push_back(c);
+        maybe_flush();
+    }
+
+    void put(std::string_view s)
+    {
+        buf_.append(s);
+        maybe_flush();
+    }
+
+    void indent(size_t n)
+    {
+        buf_.append(n, ' ');
+        maybe_flush();
+    }
+
+    template <typename T> void number(T value, int precision)
+    {
+        char tmp[MAX_ITEM];
+        std::to_chars_result res;
+        if constexpr (std::is_integral_v<T>) {
+            res = std::to_chars(tmp, tmp + MAX_ITEM, value);
+        } else {
+            using F = std::conditional_t<std::is_same_v<T, double> || std::is_same_v<T, long double>, T, float>;
+            res = std::to_chars(tmp, tmp + MAX_ITEM, (F)value, std::chars_format::fixed, precision);
+            if (res.ec != std::errc())
+                res = std::to_chars(tmp, tmp + MAX_ITEM, (F)value, std::chars_format::general, precision);
+        }
+        buf_.append(tmp, res.ptr);
+        maybe_flush();
+    }
+
+    void flush()
+    {
+        if (os_ && !buf_.empty()) {
+            os_->write(buf_.data(), (std::streamsize)buf_.size());
+            buf_.clear();
+        }
+    }
+
+    std::string take() { return std::move(buf_); }
+
+private:
+    static constexpr size_t FLUSH_BYTES = 1 << 16;
+    // Longest single number: a double in fixed notation with a large precision still fits.
+    static constexpr size_t MAX_ITEM = 512;
+
+    void maybe_flush()
+    {
+        if (os_ && buf_.size() >= FLUSH_BYTES)
+            flush();
+    }
+
+    std::string buf_;
+    std::ostream* os_ { nullptr };
+};
+
+namespace Format {
+
+    // Upper bound on the characters one element takes, used to size the output up front.
+    template <typename T> constexpr size_t element_width(int precision)
+    {
+        if constexpr (std::is_integral_v<T>)
+            return std::numeric_limits<T>::digits10 + 2;
+        else
+            return (size_t)std::max(precision, 0) + 12;
+    }
+
+    // Number of entries of a dimension of length `len` that get printed.
+    inline size_t shown(size_t len, bool summarize, size_t edge)
+    {
+        return summarize && len > 2 * edge ? 2 * edge : len;
+    }
+
+    // Index of the k-th printed entry of a dimension.
+    inline size_t entry(size_t k, size_t len, bool summarize, size_t edge)
+    {
+        return summarize && len > 2 * edge && k >= edge ? len - 2 * edge + k : k;
+    }
+
+    template <typename T> struct View {
+        const T* data;
+        std::array<size_t, 4> shape;
+        std::array<size_t, 4> strides;
+        size_t n_dims;
+        size_t size;
+    };
+
+    template <typename T> size_t printed_elements(const View<T>& v, bool summarize, size_t edge)
+    {
+        size_t n = 1;
+        for (size_t d = 0; d < std::max(v.n_dims, (size_t)1); d++)
+            n *= shown(v.shape[d], summarize, edge);
+        return n;
+    }
+
+    // Nested form, one line per row of the innermost-but-one dimension:
+    //   [
+    //     [1, 2],
+    //     [3, 4]
+    //   ]
+    template <typename T>
+    void write_nested(TextWriter& out, const View<T>& v, size_t dim, const T* base, bool summarize,
+                      const FormatOptions& opts)
+    {
+        size_t len = v.shape[dim], n_shown = shown(len, summarize, opts.edge_items);
+        bool last_dim = dim + 1 == v.n_dims;
+
+        out.put('[');
+        for (size_t k = 0; k < n_shown; k++) {
+            if (summarize && k == opts.edge_items && n_shown < len) {
+                if (!last_dim) {
+                    out.put('\n');
+                    out.indent((dim + 1) * 2);
+                }
+                out.put("..., ");
+            }
+
+            const T* p = base + entry(k, len, summarize, opts.edge_items) * v.strides[dim];
+            if (last_dim) {
+                out.number(*p, opts.precision);
+            } else {
+                out.put('\n');
+                out.indent((dim + 1) * 2);
+                write_nested(out, v, dim + 1, p, summarize, opts);
+            }
+            if (k + 1 < n_shown)
+                out.put(", ");
+        }
+        if (!last_dim) {
+            out.put('\n');
+            out.indent(dim * 2);
+        }
+        out.put(']');
+    }
+
+    // Row-major elements each followed by ", ", e.g. "[0, 1, 2, ]". When summarized, the first and last edge_items
+    // elements of the flattened tensor are kept.
+    template <typename T> void write_flat(TextWriter& out, const View<T>& v, const FormatOptions& opts)
+    {
+        bool summarize = v.size > opts.threshold && v.size > 2 * opts.edge_items;
+        size_t dims = std::max(v.n_dims, (size_t)1);
+        std::array<size_t, 4> idx {};
+
+        out.put('[');
+        for (size_t flat = 0; flat < v.size; flat++) {
+            if (summarize && flat == opts.edge_items) {
+                out.put("..., ");
+                flat = v.size - opts.edge_items;
+                for (size_t d = dims, rem = flat; d-- > 0;) {
+                    idx[d] = rem % v.shape[d];
+                    rem /= v.shape[d];
+                }
+            }
+
+            const T* p = v.data;
+            for (size_t d = 0; d < dims; d++)
+                p += idx[d] * v.strides[d];
+            out.number(*p, opts.precision);
+            out.put(", ");
+
+            for (size_t d = dims; d-- > 0;) {
+                if (++idx[d] < v.shape[d])
+                    break;
+                idx[d] = 0;
+            }
+        }
+        out.put(']');
+    }
+
+}
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Tensile {
+
+// Float kernels behind Tensor::take/index_select/gather. Indices are already bounds-checked. Element gathers use
+// AVX2 gather instructions, eight elements per instruction.
+
+// out[i] = x[index[i]] for i in [0, n).
+void take_f32(const float* x, const int32_t* index, size_t n, float* out);
+
+// Gather along the middle axis of a contiguous [outer, len, inner] block: out[o, j, k] = x[o, index[o, j, k], k],
+// with index and out of shape [outer, n_index, inner].
+void gather_f32(const float* x, size_t outer, size_t len, size_t inner, const int32_t* index, size_t n_index,
+                float* out);
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "gemm_kernel.h"
+#include "gemm_tune.h"
+#include "tensor.h"
+
+namespace Tensile {
+
+// The right-hand side of a GEMM stored in the blocked layout the micro-kernel reads: KC x NR panels, row-major inside
+// each panel and zero-padded to NR columns, with all the panels of one NC-wide column block stored together. Weights
+// that are multiplied many times are packed once here instead of on every product. KC and NC are fixed when packing;
+// the rest of the blocking is still chosen per product.
+class PackedMatrix {
+public:
+    PackedMatrix() = default;
+
+    // Packs a [K, N] matrix with the blocking recorded for products with about `expected_m` rows.
+    explicit PackedMatrix(const Tensor<float>& b, size_t expected_m = 256);
+
+    PackedMatrix(const Tensor<float>& b, const GemmConfig& config);
+
+    [[nodiscard]] size_t rows() const { return k_; }
+
+    [[nodiscard]] size_t cols() const { return n_; }
+
+    [[nodiscard]] const GemmConfig& config() const { return config_; }
+
+    // The panels of the KC x NC block starting at row pc and column jc.
+    [[nodiscard]] const float* block(size_t pc, size_t jc) const;
+
+    // Back to a row-major [K, N] tensor.
+    [[nodiscard]] Tensor<float> unpack() const;
+
+private:
+    [[nodiscard]] size_t offset(size_t pc, size_t jc) const;
+
+    size_t k_ { 0 };
+    size_t n_ { 0 };
+    GemmConfig config_;
+    std::vector<float> panels_;
+};
+
+// sgemm against pre-packed weights, which skips packing B.
+void sgemm_packed(size_t m, MatrixRef a, const PackedMatrix& b, float* c, size_t ldc, const Epilogue& epilogue,
+                  MatrixRef bias = {});
+
+// Matrix product of [M, K] and [K, N] tensors with the epilogue fused into the store. `bias` must be broadcastable to
+// [M, N]: a [N] or [1, N] row bias, a [M, 1] column bias or a full [M, N] matrix.
+Tensor<float> matmul_fused(const Tensor<float>& a, const Tensor<float>& b, const Epilogue& epilogue = {});
+
+Tensor<float> matmul_fused(const Tensor<float>& a, const Tensor<float>& b, const Tensor<float>& bias,
+                           const Epilogue& epilogue = {});
+
+// Writes the product into an existing [M, N] tensor whose rows are contiguous, reading it back when epilogue.beta is
+// non-zero (e.g. to accumulate a residual). `bias` may be null.
+void matmul_fused_into(const Tensor<float>& a, const Tensor<float>& b, const Tensor<float>* bias, Tensor<float>& c,
+                       const Epilogue& epilogue = {});
+
+// The same products with pre-packed [K, N] weights.
+Tensor<float> matmul_fused(const Tensor<float>& a, const PackedMatrix& b, const Epilogue& epilogue = {});
+
+Tensor<float> matmul_fused(const Tensor<float>& a, const PackedMatrix& b, const Tensor<float>& bias,
+                           const Epilogue& epilogue = {});
+
+void matmul_fused_into(const Tensor<float>& a, const PackedMatrix& b, const Tensor<float>* bias, Tensor<float>& c,
+                       const Epilogue& epilogue = {});
+
+}
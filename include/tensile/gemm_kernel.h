@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+
+#include "gemm_tune.h"
+
+namespace Tensile {
+
+// The raw-pointer sgemm interface, kept apart from gemm.h so that tensor.h can call it without including the
+// Tensor-based API built on top of it.
+
+enum class Activation { NONE, RELU, GELU, SIGMOID };
+
+// Work applied to each output tile of a GEMM while it is still in registers, before it is stored:
+//     C = activation(alpha * A·B + beta * C + bias)
+// With beta == 0 the previous contents of C are never read.
+struct Epilogue {
+    float alpha { 1 };
+    float beta { 0 };
+    Activation activation { Activation::NONE };
+};
+
+// A strided [rows, cols] float matrix: element (i, j) is at data[i * row_stride + j * col_stride]. A zero stride
+// broadcasts along that axis, and transposing is just swapping the strides.
+struct MatrixRef {
+    const float* data { nullptr };
+    size_t row_stride { 0 };
+    size_t col_stride { 0 };
+};
+
+// C[m, n] = epilogue(A[m, k] · B[k, n]) with a row-major C of leading dimension `ldc`. A and B are packed into
+// cache-sized panels, so any strides are accepted at the same speed. `bias` may be left empty.
+void sgemm(size_t m, size_t n, size_t k, MatrixRef a, MatrixRef b, float* c, size_t ldc, const Epilogue& epilogue,
+           MatrixRef bias = {});
+
+// sgemm with an explicit blocking rather than the one recorded for the shape, e.g. to benchmark it.
+void sgemm_with(const GemmConfig& config, size_t m, size_t n, size_t k, MatrixRef a, MatrixRef b, float* c,
+                size_t ldc, const Epilogue& epilogue, MatrixRef bias = {});
+
+}
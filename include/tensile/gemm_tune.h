@@ -0,0 +1,70 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Tensile {
+
+// Register tile of the sgemm micro-kernel. Cache blocks must be multiples of it.
+inline constexpr size_t GEMM_MR = 6;
+inline constexpr size_t GEMM_NR = 16;
+
+// Blocking and threading of sgemm around its fixed register tile. The defaults suit Zen2: kc x 16 panels of B stay
+// in L1, mc x kc blocks of A in L2 and kc x nc panels of B in L3.
+struct GemmConfig {
+    size_t mc { 120 };            // rows of A per packed block, a multiple of GEMM_MR
+    size_t kc { 256 };            // depth of each packed block
+    size_t nc { 3072 };           // columns of B per packed panel, a multiple of GEMM_NR
+    size_t panels_per_task { 4 }; // 16-column panels handed to a thread at a time
+    int threads { 8 };
+
+    [[nodiscard]] bool valid() const
+    {
+        return mc > 0 && mc % GEMM_MR == 0 && kc > 0 && nc > 0 && nc % GEMM_NR == 0 && panels_per_task > 0
+            && threads > 0;
+    }
+
+    bool operator==(const GemmConfig&) const = default;
+};
+
+// Products are grouped by the power of two at or above each of m, n and k. One configuration serves a whole bucket.
+struct ShapeBucket {
+    uint8_t m, n, k;
+
+    auto operator<=>(const ShapeBucket&) const = default;
+};
+
+ShapeBucket shape_bucket(size_t m, size_t n, size_t k);
+
+// The CPUID brand string of this machine, which keys the tuning cache.
+const std::string& cpu_model();
+
+// The configuration for an m x n x k product on this CPU: the tuned one for its bucket if there is one, otherwise
+// the defaults. The cache file is read on first use. If TENSILE_GEMM_AUTOTUNE is set (and not "0"), a bucket without
+// an entry is tuned on the spot, outside of parallel regions, and the cache file is rewritten.
+GemmConfig gemm_config(size_t m, size_t n, size_t k);
+
+// Benchmarks candidate configurations on random m x n x k operands, records the fastest for this CPU and bucket and
+// returns it. Starting from the current configuration, the thread count, kc, mc, nc and panels per task are swept
+// one at a time with the others held at their best value so far.
+GemmConfig tune_gemm(size_t m, size_t n, size_t k);
+
+// Records `config` for the bucket of m x n x k on this CPU. Invalid blockings throw std::invalid_argument.
+void set_gemm_config(size_t m, size_t n, size_t k, const GemmConfig& config);
+
+// Forgets every recorded configuration.
+void clear_gemm_tuning();
+
+// $TENSILE_GEMM_CACHE if set, otherwise $HOME/.cache/tensile/gemm_tuning.txt.
+std::string gemm_cache_path();
+
+// The cache is a text file with one tab-separated line per entry:
+//     <cpu model>  <m bucket> <n bucket> <k bucket>  <mc> <kc> <nc> <panels per task> <threads>
+// Loading merges its entries over the recorded ones, keeping those of other CPUs so that one file can serve several
+// hosts. Both return false if the file cannot be read or written.
+bool load_gemm_tuning(const std::string& path);
+bool save_gemm_tuning(const std::string& path);
+
+}
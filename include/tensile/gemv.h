@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Tensile {
+
+// Level-2 float kernels behind Tensor::dot/matvec/vecmat. They are memory bound, so each reads every matrix element
+// exactly once with unit stride and splits the work over threads in fixed chunks, which keeps the results independent
+// of the thread count.
+
+// Sum of x[i * incx] * y[i * incy] for i in [0, n).
+float sdot(size_t n, const float* x, size_t incx, const float* y, size_t incy);
+
+// y[m] = A[m, n] · x[n] for a matrix whose rows are contiguous and `lda` elements apart.
+void sgemv(size_t m, size_t n, const float* a, size_t lda, const float* x, float* y);
+
+// y[n] = A[m, n]ᵀ · x[m], i.e. x used as a row vector on the left of A, with the same storage for A as sgemv().
+void sgemv_t(size_t m, size_t n, const float* a, size_t lda, const float* x, float* y);
+
+}
@@ -0,0 +1,743 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <omp.h>
+#include <stdexcept>
+#include <vector>
+
+#include "tensor.h"
+
+namespace Tensile {
+
+enum class GraphOp { INPUT, CONSTANT, ADD, SUB, MUL, NEG, EXP, RECIPROCAL, SCALE, SHIFT, MATMUL, SUM, TRANSPOSE };
+
+template <typename DataType>
+requires TensorType<DataType>
+class Plan;
+
+// Records tensor operations into a DAG instead of executing them. Nodes are built with the same operators as Tensor
+// (`x * w + b`, `.exp()`, `.sum(axis, keepdims)`, `.transpose()`), then compile() turns the graph into a Plan that
+// can be replayed on new inputs without allocating.
+//
+//     Graph<float> g;
+//     auto x = g.input({ batch, 8 });
+//     auto y = (x * g.constant(w) + g.constant(b)).exp().sum(1, false);
+//     auto plan = g.compile({ y });
+//     plan.run({ x_tensor });
+//     auto result = plan.output(0);
+template <typename DataType>
+requires TensorType<DataType>
+class Graph {
+public:
+    class Node {
+    public:
+        Node operator+(const Node& other) const { return graph_->binary(GraphOp::ADD, id_, other.id_); }
+
+        Node operator-(const Node& other) const { return graph_->binary(GraphOp::SUB, id_, other.id_); }
+
+        Node elementwise_mul(const Node& other) const { return graph_->binary(GraphOp::MUL, id_, other.id_); }
+
+        Node operator*(const Node& other) const { return graph_->matmul(id_, other.id_); }
+
+        Node operator*(DataType scalar) const { return graph_->unary(GraphOp::SCALE, id_, scalar); }
+
+        Node operator+(DataType scalar) const { return graph_->unary(GraphOp::SHIFT, id_, scalar); }
+
+        Node operator-() const { return graph_->unary(GraphOp::NEG, id_); }
+
+        Node exp() const { return graph_->unary(GraphOp::EXP, id_); }
+
+        Node reciprocal() const { return graph_->unary(GraphOp::RECIPROCAL, id_); }
+
+        Node sum(size_t axis, bool keepdims) const { return graph_->sum(id_, axis, keepdims); }
+
+        Node transpose() const { return graph_->transpose(id_); }
+
+        [[nodiscard]] std::array<size_t, MAX_DIM> shape() const { return graph_->nodes_[id_].shape; }
+
+        [[nodiscard]] size_t n_dims() const { return graph_->nodes_[id_].n_dims; }
+
+    private:
+        friend class Graph;
+
+        Node(Graph* graph, size_t id)
+            : graph_(graph)
+            , id_(id)
+        {
+        }
+
+        Graph* graph_;
+        size_t id_;
+    };
+
+    // A placeholder bound, in declaration order, to the tensors passed to Plan::run().
+    Node input(const std::vector<size_t>& shape)
+    {
+        if (shape.empty() || shape.size() > MAX_DIM)
+            throw std::invalid_argument("Graph input must have between 1 and 4 dimensions");
+
+        NodeInfo info { GraphOp::INPUT };
+        info.n_dims = shape.size();
+        std::copy(shape.begin(), shape.end(), info.shape.begin());
+        info.slot = n_inputs_++;
+        return push(info);
+    }
+
+    // Captures `tensor` by view: it must outlive every Plan compiled from this graph.
+    Node constant(const Tensor<DataType>& tensor)
+    {
+        NodeInfo info { GraphOp::CONSTANT };
+        info.n_dims = tensor.n_dims();
+        info.shape = tensor.shape();
+        info.slot = constants_.size();
+        constants_.push_back(tensor);
+        return push(info);
+    }
+
+    Plan<DataType> compile(const std::vector<Node>& outputs) const;
+
+private:
+    struct NodeInfo {
+        GraphOp op;
+        size_t a { 0 };
+        size_t b { 0 };
+        DataType scalar { 0 };
+        size_t axis { 0 };
+        std::array<size_t, MAX_DIM> shape {};
+        size_t n_dims { 0 };
+        size_t slot { 0 };
+    };
+
+    Node push(const NodeInfo& info)
+    {
+        nodes_.push_back(info);
+        return Node(this, nodes_.size() - 1);
+    }
+
+    Node unary(GraphOp op, size_t a, DataType scalar = 0)
+    {
+        NodeInfo info = nodes_[a];
+        info.op = op;
+        info.a = a;
+        info.scalar = scalar;
+        return push(info);
+    }
+
+    Node binary(GraphOp op, size_t a, size_t b)
+    {
+        const auto &lhs = nodes_[a], &rhs = nodes_[b];
+        if (lhs.n_dims != rhs.n_dims)
+            throw std::invalid_argument("Incompatible shapes for element-wise operation");
+
+        NodeInfo info { op, a, b };
+        info.n_dims = lhs.n_dims;
+        for (size_t d = 0; d < lhs.n_dims; d++) {
+            if (lhs.shape[d] != rhs.shape[d] && lhs.shape[d] != 1 && rhs.shape[d] != 1)
+                throw std::invalid_argument("Incompatible shapes for element-wise operation");
+            info.shape[d] = std::max(lhs.shape[d], rhs.shape[d]);
+        }
+        return push(info);
+    }
+
+    Node matmul(size_t a, size_t b)
+    {
+        const auto &lhs = nodes_[a], &rhs = nodes_[b];
+        if (lhs.n_dims != 2 || rhs.n_dims != 2 || lhs.shape[1] != rhs.shape[0])
+            throw std::invalid_argument("Incompatible shapes for matrix multiplication");
+
+        NodeInfo info { GraphOp::MATMUL, a, b };
+        info.n_dims = 2;
+        info.shape = { lhs.shape[0], rhs.shape[1], 0, 0 };
+        return push(info);
+    }
+
+    Node sum(size_t a, size_t axis, bool keepdims)
+    {
+        const auto& in = nodes_[a];
+        if (axis >= in.n_dims)
+            throw std::invalid_argument("Axis out of bounds");
+
+        NodeInfo info { GraphOp::SUM, a };
+        info.axis = axis;
+        info.shape = in.shape;
+        info.n_dims = in.n_dims;
+        if (keepdims) {
+            info.shape[axis] = 1;
+        } else {
+            std::copy(in.shape.begin() + axis + 1, in.shape.end(), info.shape.begin() + axis);
+            info.shape[MAX_DIM - 1] = 0;
+            info.n_dims--;
+        }
+        return push(info);
+    }
+
+    Node transpose(size_t a)
+    {
+        if (nodes_[a].n_dims != 2)
+            throw std::invalid_argument("Transpose is only implemented for 2D tensors");
+
+        NodeInfo info = nodes_[a];
+        info.op = GraphOp::TRANSPOSE;
+        info.a = a;
+        std::swap(info.shape[0], info.shape[1]);
+        return push(info);
+    }
+
+private:
+    std::vector<NodeInfo> nodes_;
+    std::vector<Tensor<DataType>> constants_;
+    size_t n_inputs_ { 0 };
+};
+
+// An executable schedule produced by Graph::compile(). Chains of elementwise nodes are fused into a single kernel
+// (together with a trailing sum, if any), transposes become strided reads, and every intermediate lives at a fixed
+// offset of one arena whose regions are shared by buffers with disjoint lifetimes. run() performs no allocation.
+template <typename DataType>
+requires TensorType<DataType>
+class Plan {
+public:
+    // Owns its arena, so it can be moved but not copied.
+    Plan(const Plan&) = delete;
+    Plan& operator=(const Plan&) = delete;
+    Plan(Plan&&) noexcept = default;
+    Plan& operator=(Plan&&) noexcept = default;
+
+    // Binds `inputs` to the graph's inputs (in declaration order) and executes every kernel. Inputs must be contiguous
+    // and have the declared shapes.
+    void run(std::initializer_list<std::reference_wrapper<const Tensor<DataType>>> inputs)
+    {
+        if (inputs.size() != input_shapes_.size())
+            throw std::invalid_argument("Number of inputs does not match the graph");
+
+        size_t slot = 0;
+        for (const Tensor<DataType>& input : inputs) {
+            if (input.shape() != input_shapes_[slot])
+                throw std::invalid_argument("Input shape does not match the graph");
+            if (!input.is_contiguous())
+                throw std::invalid_argument("Graph inputs must be contiguous");
+            input_ptrs_[slot++] = input.data();
+        }
+
+        for (const auto& kernel : kernels_) {
+            switch (kernel.kind) {
+            case KernelKind::MATMUL:
+                run_matmul(kernel);
+                break;
+            case KernelKind::ELEMENTWISE:
+                run_elementwise(kernel);
+                break;
+            case KernelKind::REDUCE:
+                run_reduce(kernel);
+                break;
+            }
+        }
+    }
+
+    // A view of the i-th output inside the arena. Valid until the next run().
+    [[nodiscard]] Tensor<DataType> output(size_t i) const
+    {
+        const auto& out = outputs_.at(i);
+        size_t n = element_count(out.shape, out.n_dims);
+        auto flat = arena_[std::vector<std::pair<size_t, size_t>> { { out.index, out.index + n } }];
+        return flat.view({ out.shape.begin(), out.shape.begin() + out.n_dims });
+    }
+
+    [[nodiscard]] size_t n_kernels() const { return kernels_.size(); }
+
+    // Elements in the shared arena, versus the elements the same intermediates would need without buffer reuse.
+    [[nodiscard]] size_t arena_size() const { return arena_.size(); }
+
+    [[nodiscard]] size_t intermediate_size() const { return intermediate_size_; }
+
+private:
+    friend class Graph<DataType>;
+
+    Plan() = default;
+
+    static constexpr size_t BLOCK = 256;
+    static constexpr size_t N_THREADS = 8;
+
+    enum class BufferKind { INPUT, CONSTANT, ARENA };
+    enum class KernelKind { MATMUL, ELEMENTWISE, REDUCE };
+
+    // Where a value lives (input slot, constant slot or arena offset) and how to address it.
+    struct ValueRef {
+        BufferKind kind { BufferKind::ARENA };
+        size_t index { 0 };
+        std::array<size_t, MAX_DIM> shape {};
+        std::array<size_t, MAX_DIM> strides {};
+        size_t n_dims { 0 };
+        bool dense { false }; // contiguous and not broadcast within its kernel: read in place
+    };
+
+    // One step of a fused elementwise program. Step i writes slot i; `load` steps read a leaf value.
+    struct Instr {
+        GraphOp op;
+        bool load { false };
+        size_t a { 0 };
+        size_t b { 0 };
+        DataType scalar { 0 };
+        ValueRef leaf {};
+    };
+
+    struct Kernel {
+        KernelKind kind;
+        std::vector<Instr> program;
+        ValueRef a {}, b {};
+        ValueRef out {};
+        std::array<size_t, MAX_DIM> iter_shape {};
+        std::array<size_t, MAX_DIM> out_strides {}; // reduce kernels: output strides with 0 on the summed axis
+        size_t iter_n_dims { 0 };
+    };
+
+    static size_t element_count(const std::array<size_t, MAX_DIM>& shape, size_t n_dims)
+    {
+        return std::accumulate(shape.begin(), shape.begin() + n_dims, (size_t)1, std::multiplies<>());
+    }
+
+    static std::array<size_t, MAX_DIM> contiguous_strides(const std::array<size_t, MAX_DIM>& shape, size_t n_dims)
+    {
+        std::array<size_t, MAX_DIM> strides {};
+        size_t stride = 1;
+        for (int d = (int)n_dims - 1; d >= 0; d--) {
+            strides[d] = stride;
+            stride *= shape[d];
+        }
+        return strides;
+    }
+
+    const DataType* base(const ValueRef& ref) const
+    {
+        switch (ref.kind) {
+        case BufferKind::INPUT:
+            return input_ptrs_[ref.index];
+        case BufferKind::CONSTANT:
+            return constants_[ref.index].data();
+        default:
+            return arena_.data() + ref.index;
+        }
+    }
+
+    DataType* arena_ptr(const ValueRef& ref) { return arena_.data() + ref.index; }
+
+    // Evaluates elements [start, start + len) of a fused program and returns a pointer to the result.
+    const DataType* eval_block(const Kernel& kernel, size_t start, size_t len, DataType* scratch,
+                               const DataType** slots) const
+    {
+        for (size_t s = 0; s < kernel.program.size(); s++) {
+            const Instr& ins = kernel.program[s];
+            DataType* dst = scratch + s * BLOCK;
+
+            if (ins.load) {
+                if (ins.leaf.dense) {
+                    slots[s] = base(ins.leaf) + start;
+                    continue;
+                }
+                gather(kernel, ins.leaf, start, len, dst);
+                slots[s] = dst;
+                continue;
+            }
+
+            const DataType* x = slots[ins.a];
+            const DataType* y = slots[ins.b];
+            DataType scalar = ins.scalar;
+            switch (ins.op) {
+            case GraphOp::ADD:
+                for (size_t e = 0; e < len; e++)
+                    dst[e] = x[e] + y[e];
+                break;
+            case GraphOp::SUB:
+                for (size_t e = 0; e < len; e++)
+                    dst[e] = x[e] - y[e];
+                break;
+            case GraphOp::MUL:
+                for (size_t e = 0; e < len; e++)
+                    dst[e] = x[e] * y[e];
+                break;
+            case GraphOp::NEG:
+                for (size_t e = 0; e < len; e++)
+                    dst[e] = -x[e];
+                break;
+            case GraphOp::EXP:
+                for (size_t e = 0; e < len; e++)
+                    dst[e] = (DataType)std::exp(x[e]);
+                break;
+            case GraphOp::RECIPROCAL:
+                for (size_t e = 0; e < len; e++)
+                    dst[e] = 1 / x[e];
+                break;
+            case GraphOp::SCALE:
+                for (size_t e = 0; e < len; e++)
+                    dst[e] = x[e] * scalar;
+                break;
+            case GraphOp::SHIFT:
+                for (size_t e = 0; e < len; e++)
+                    dst[e] = x[e] + scalar;
+                break;
+            default:
+                UNIMPLEMENTED("Unexpected operation in a fused elementwise kernel");
+            }
+            slots[s] = dst;
+        }
+
+        return slots[kernel.program.size() - 1];
+    }
+
+    // Walks elements [start, start + len) of the kernel's iteration space in row-major order, calling
+    // visit(e, offset) with the element's offset under `strides`.
+    template <typename Visit>
+    static void walk(const Kernel& kernel, const std::array<size_t, MAX_DIM>& strides, size_t start, size_t len,
+                     Visit visit)
+    {
+        std::array<size_t, MAX_DIM> idx {};
+        size_t rest = start, offset = 0;
+        for (int d = (int)kernel.iter_n_dims - 1; d >= 0; d--) {
+            idx[d] = rest % kernel.iter_shape[d];
+            rest /= kernel.iter_shape[d];
+            offset += idx[d] * strides[d];
+        }
+
+        for (size_t e = 0; e < len; e++) {
+            visit(e, offset);
+            for (int d = (int)kernel.iter_n_dims - 1; d >= 0; d--) {
+                offset += strides[d];
+                if (++idx[d] < kernel.iter_shape[d])
+                    break;
+                offset -= idx[d] * strides[d];
+                idx[d] = 0;
+            }
+        }
+    }
+
+    void gather(const Kernel& kernel, const ValueRef& leaf, size_t start, size_t len, DataType* dst) const
+    {
+        const DataType* src = base(leaf);
+        walk(kernel, leaf.strides, start, len, [&](size_t e, size_t offset) { dst[e] = src[offset]; });
+    }
+
+    void run_elementwise(const Kernel& kernel)
+    {
+        size_t total = element_count(kernel.iter_shape, kernel.iter_n_dims);
+        size_t n_blocks = (total + BLOCK - 1) / BLOCK;
+        DataType* out = arena_ptr(kernel.out);
+
+#pragma omp parallel for num_threads(N_THREADS) if (n_blocks > 4)
+        for (size_t blk = 0; blk < n_blocks; blk++) {
+            size_t tid = omp_get_thread_num();
+            DataType* scratch = scratch_.data() + tid * BLOCK * max_program_;
+            const DataType** slots = slots_.data() + tid * max_program_;
+
+            size_t start = blk * BLOCK, len = std::min(BLOCK, total - start);
+            const DataType* result = eval_block(kernel, start, len, scratch, slots);
+            std::copy(result, result + len, out + start);
+        }
+    }
+
+    // Sums the fused program's values into the output. Different elements of a block can land on the same output
+    // element, so this runs on one thread to stay deterministic.
+    void run_reduce(const Kernel& kernel)
+    {
+        size_t total = element_count(kernel.iter_shape, kernel.iter_n_dims);
+        DataType* out = arena_ptr(kernel.out);
+        std::fill(out, out + element_count(kernel.out.shape, kernel.out.n_dims), DataType(0));
+
+        for (size_t start = 0; start < total; start += BLOCK) {
+            size_t len = std::min(BLOCK, total - start);
+            const DataType* result = eval_block(kernel, start, len, scratch_.data(), slots_.data());
+            walk(kernel, kernel.out_strides, start, len, [&](size_t e, size_t offset) { out[offset] += result[e]; });
+        }
+    }
+
+    void run_matmul(const Kernel& kernel)
+    {
+        const DataType* a = base(kernel.a);
+        const DataType* b = base(kernel.b);
+        DataType* c = arena_ptr(kernel.out);
+        size_t m = kernel.a.shape[0], k = kernel.a.shape[1], n = kernel.b.shape[1];
+        size_t sa0 = kernel.a.strides[0], sa1 = kernel.a.strides[1];
+        size_t sb0 = kernel.b.strides[0], sb1 = kernel.b.strides[1];
+
+#pragma omp parallel for num_threads(N_THREADS)
+        for (size_t i = 0; i < m; i++) {
+            DataType* c_row = c + i * n;
+            std::fill(c_row, c_row + n, DataType(0));
+            for (size_t p = 0; p < k; p++) {
+                DataType a_val = a[i * sa0 + p * sa1];
+                const DataType* b_row = b + p * sb0;
+                if (sb1 == 1) {
+#pragma omp simd
+                    for (size_t j = 0; j < n; j++)
+                        c_row[j] += a_val * b_row[j];
+                } else {
+                    for (size_t j = 0; j < n; j++)
+                        c_row[j] += a_val * b_row[j * sb1];
+                }
+            }
+        }
+    }
+
+private:
+    std::vector<Kernel> kernels_;
+    std::vector<ValueRef> outputs_;
+    std::vector<std::array<size_t, MAX_DIM>> input_shapes_;
+    std::vector<const DataType*> input_ptrs_;
+    std::vector<Tensor<DataType>> constants_;
+    Tensor<DataType> arena_;
+    std::vector<DataType> scratch_;
+    std::vector<const DataType*> slots_;
+    size_t max_program_ { 1 };
+    size_t intermediate_size_ { 0 };
+};
+
+template <typename DataType>
+requires TensorType<DataType>
+Plan<DataType> Graph<DataType>::compile(const std::vector<Node>& outputs) const
+{
+    using P = Plan<DataType>;
+    using ValueRef = typename P::ValueRef;
+    using Kernel = typename P::Kernel;
+    using Instr = typename P::Instr;
+
+    auto is_elementwise = [](GraphOp op) { return op >= GraphOp::ADD && op <= GraphOp::SHIFT; };
+    auto is_binary = [](GraphOp op) {
+        return op == GraphOp::ADD || op == GraphOp::SUB || op == GraphOp::MUL || op == GraphOp::MATMUL;
+    };
+    auto has_operand = [](GraphOp op) { return op != GraphOp::INPUT && op != GraphOp::CONSTANT; };
+
+    size_t n = nodes_.size();
+    std::vector<bool> reachable(n, false), is_output(n, false);
+    std::vector<size_t> stack;
+    for (const auto& out : outputs) {
+        if (out.graph_ != this)
+            throw std::invalid_argument("Output node belongs to a different graph");
+        is_output[out.id_] = true;
+        stack.push_back(out.id_);
+    }
+    while (!stack.empty()) {
+        size_t id = stack.back();
+        stack.pop_back();
+        if (reachable[id])
+            continue;
+        reachable[id] = true;
+        if (has_operand(nodes_[id].op))
+            stack.push_back(nodes_[id].a);
+        if (is_binary(nodes_[id].op))
+            stack.push_back(nodes_[id].b);
+    }
+
+    std::vector<size_t> uses(n, 0), consumer(n, SIZE_MAX);
+    for (size_t id = 0; id < n; id++) {
+        if (!reachable[id] || !has_operand(nodes_[id].op))
+            continue;
+        uses[nodes_[id].a]++;
+        consumer[nodes_[id].a] = id;
+        if (is_binary(nodes_[id].op)) {
+            uses[nodes_[id].b]++;
+            consumer[nodes_[id].b] = id;
+        }
+    }
+
+    // An elementwise node is evaluated inside its consumer's kernel when nothing else needs its value and the
+    // consumer iterates over exactly its shape (an elementwise node of the same shape, or a sum over it).
+    std::vector<bool> fused(n, false);
+    for (size_t id = 0; id < n; id++) {
+        if (!reachable[id] || !is_elementwise(nodes_[id].op) || uses[id] != 1 || is_output[id])
+            continue;
+        const auto& c = nodes_[consumer[id]];
+        fused[id] = c.op == GraphOp::SUM
+            || (is_elementwise(c.op) && c.shape == nodes_[id].shape && c.n_dims == nodes_[id].n_dims);
+    }
+
+    P plan;
+    plan.constants_ = constants_;
+    plan.input_shapes_.resize(n_inputs_);
+    plan.input_ptrs_.resize(n_inputs_, nullptr);
+
+    std::vector<ValueRef> values(n);
+    auto arena_value = [&](const NodeInfo& info) {
+        ValueRef ref { P::BufferKind::ARENA, plan.kernels_.size(), info.shape };
+        ref.n_dims = info.n_dims;
+        ref.strides = P::contiguous_strides(info.shape, info.n_dims);
+        return ref;
+    };
+
+    // Emits the program computing `id` into `kernel`, descending into fused producers; returns the result's slot.
+    std::function<size_t(Kernel&, size_t, bool)> emit = [&](Kernel& kernel, size_t id, bool root) -> size_t {
+        const auto& info = nodes_[id];
+        Instr ins { info.op };
+        if (root || fused[id]) {
+            ins.a = emit(kernel, info.a, false);
+            if (is_binary(info.op))
+                ins.b = emit(kernel, info.b, false);
+            ins.scalar = info.scalar;
+        } else {
+            ins.load = true;
+            ins.leaf = values[id];
+            bool broadcast = false;
+            for (size_t d = 0; d < kernel.iter_n_dims; d++) {
+                if (ins.leaf.shape[d] == 1 && kernel.iter_shape[d] != 1) {
+                    ins.leaf.strides[d] = 0;
+                    broadcast = true;
+                }
+            }
+            ins.leaf.dense
+                = !broadcast && ins.leaf.strides == P::contiguous_strides(kernel.iter_shape, kernel.iter_n_dims);
+        }
+        kernel.program.push_back(ins);
+        return kernel.program.size() - 1;
+    };
+
+    auto add_kernel = [&](Kernel kernel, size_t id) {
+        values[id] = arena_value(nodes_[id]);
+        kernel.out = values[id];
+        plan.kernels_.push_back(std::move(kernel));
+    };
+
+    for (size_t id = 0; id < n; id++) {
+        if (!reachable[id] || fused[id])
+            continue;
+
+        const auto& info = nodes_[id];
+        switch (info.op) {
+        case GraphOp::INPUT:
+            values[id] = { P::BufferKind::INPUT, info.slot, info.shape };
+            values[id].n_dims = info.n_dims;
+            values[id].strides = P::contiguous_strides(info.shape, info.n_dims);
+            plan.input_shapes_[info.slot] = info.shape;
+            break;
+        case GraphOp::CONSTANT:
+            values[id] = { P::BufferKind::CONSTANT, info.slot, info.shape, constants_[info.slot].strides() };
+            values[id].n_dims = info.n_dims;
+            break;
+        case GraphOp::TRANSPOSE:
+            values[id] = values[info.a];
+            std::swap(values[id].shape[0], values[id].shape[1]);
+            std::swap(values[id].strides[0], values[id].strides[1]);
+            break;
+        case GraphOp::MATMUL: {
+            Kernel kernel { P::KernelKind::MATMUL, {} };
+            kernel.a = values[info.a];
+            kernel.b = values[info.b];
+            add_kernel(std::move(kernel), id);
+            break;
+        }
+        case GraphOp::SUM: {
+            const auto& in = nodes_[info.a];
+            Kernel kernel { P::KernelKind::REDUCE, {} };
+            kernel.iter_shape = in.shape;
+            kernel.iter_n_dims = in.n_dims;
+            emit(kernel, info.a, false);
+
+            std::array<size_t, MAX_DIM> reduced = in.shape;
+            reduced[info.axis] = 1;
+            kernel.out_strides = P::contiguous_strides(reduced, in.n_dims);
+            kernel.out_strides[info.axis] = 0;
+            add_kernel(std::move(kernel), id);
+            break;
+        }
+        default: {
+            Kernel kernel { P::KernelKind::ELEMENTWISE, {} };
+            kernel.iter_shape = info.shape;
+            kernel.iter_n_dims = info.n_dims;
+            emit(kernel, id, true);
+            add_kernel(std::move(kernel), id);
+            break;
+        }
+        }
+    }
+
+    // Outputs that are views of inputs, constants or transposes get a copy so every output owns an arena region.
+    for (const auto& out : outputs) {
+        size_t id = out.id_;
+        if (values[id].kind != P::BufferKind::ARENA || values[id].strides
+                != P::contiguous_strides(nodes_[id].shape, nodes_[id].n_dims)) {
+            Kernel kernel { P::KernelKind::ELEMENTWISE, {} };
+            kernel.iter_shape = nodes_[id].shape;
+            kernel.iter_n_dims = nodes_[id].n_dims;
+            emit(kernel, id, false);
+            add_kernel(std::move(kernel), id);
+        }
+        plan.outputs_.push_back(values[id]);
+    }
+
+    // Liveness: kernel k defines arena buffer k, which stays live until the last kernel reading it (or forever, for
+    // outputs). Buffers are placed largest first at the lowest offset not overlapping a buffer whose lifetime
+    // intersects theirs.
+    size_t n_kernels = plan.kernels_.size();
+    std::vector<size_t> last_use(n_kernels), sizes(n_kernels);
+    for (size_t k = 0; k < n_kernels; k++) {
+        last_use[k] = k;
+        const auto& out = plan.kernels_[k].out;
+        sizes[k] = (P::element_count(out.shape, out.n_dims) + 7) / 8 * 8;
+        plan.intermediate_size_ += sizes[k];
+    }
+
+    auto note_read = [&](const ValueRef& ref, size_t k) {
+        if (ref.kind == P::BufferKind::ARENA)
+            last_use[ref.index] = std::max(last_use[ref.index], k);
+    };
+    for (size_t k = 0; k < n_kernels; k++) {
+        const auto& kernel = plan.kernels_[k];
+        if (kernel.kind == P::KernelKind::MATMUL) {
+            note_read(kernel.a, k);
+            note_read(kernel.b, k);
+        }
+        for (const auto& ins : kernel.program)
+            if (ins.load)
+                note_read(ins.leaf, k);
+    }
+    for (const auto& out : plan.outputs_)
+        last_use[out.index] = std::numeric_limits<size_t>::max();
+
+    std::vector<size_t> order(n_kernels), offsets(n_kernels, 0);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t x, size_t y) { return sizes[x] > sizes[y]; });
+
+    size_t arena_size = 0;
+    std::vector<size_t> placed;
+    for (size_t buf : order) {
+        std::vector<std::pair<size_t, size_t>> busy;
+        for (size_t other : placed)
+            if (buf <= last_use[other] && other <= last_use[buf])
+                busy.emplace_back(offsets[other], offsets[other] + sizes[other]);
+        std::sort(busy.begin(), busy.end());
+
+        size_t offset = 0;
+        for (auto [begin, end] : busy) {
+            if (offset + sizes[buf] <= begin)
+                break;
+            offset = std::max(offset, end);
+        }
+        offsets[buf] = offset;
+        arena_size = std::max(arena_size, offset + sizes[buf]);
+        placed.push_back(buf);
+    }
+
+    auto relocate = [&](ValueRef& ref) {
+        if (ref.kind == P::BufferKind::ARENA)
+            ref.index = offsets[ref.index];
+    };
+    for (auto& kernel : plan.kernels_) {
+        relocate(kernel.a);
+        relocate(kernel.b);
+        relocate(kernel.out);
+        for (auto& ins : kernel.program)
+            if (ins.load)
+                relocate(ins.leaf);
+        plan.max_program_ = std::max(plan.max_program_, kernel.program.size());
+    }
+    for (auto& out : plan.outputs_)
+        relocate(out);
+
+    plan.arena_ = Tensor<DataType>(new DataType[std::max(arena_size, (size_t)1)], { std::max(arena_size, (size_t)1) });
+    plan.scratch_.resize(P::N_THREADS * P::BLOCK * plan.max_program_);
+    plan.slots_.resize(P::N_THREADS * plan.max_program_);
+
+    return plan;
+}
+
+}
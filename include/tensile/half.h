@@ -0,0 +1,130 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <immintrin.h>
+
+namespace Tensile {
+
+// IEEE 754 binary16. Stored as raw bits; arithmetic is carried out in fp32 and rounded back to nearest-even.
+struct float16 {
+    uint16_t bits;
+
+    float16() = default;
+
+    explicit float16(float value)
+        : bits(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT))
+    {
+    }
+
+    template <typename T>
+    requires std::integral<T> || std::same_as<T, double>
+    explicit float16(T value)
+        : float16((float)value)
+    {
+    }
+
+    static float16 from_bits(uint16_t bits)
+    {
+        float16 result;
+        result.bits = bits;
+        return result;
+    }
+
+    operator float() const { return _cvtsh_ss(bits); }
+};
+
+// Brain floating point: the upper half of an fp32, i.e. fp32 range with an 8-bit mantissa.
+struct bfloat16 {
+    uint16_t bits;
+
+    bfloat16() = default;
+
+    explicit bfloat16(float value)
+    {
+        auto u = std::bit_cast<uint32_t>(value);
+        if ((u & 0x7FFFFFFF) > 0x7F800000)
+            bits = (uint16_t)((u >> 16) | 0x0040); // keep NaNs quiet instead of rounding them into infinities
+        else
+            bits = (uint16_t)((u + 0x7FFF + ((u >> 16) & 1)) >> 16);
+    }
+
+    template <typename T>
+    requires std::integral<T> || std::same_as<T, double>
+    explicit bfloat16(T value)
+        : bfloat16((float)value)
+    {
+    }
+
+    static bfloat16 from_bits(uint16_t bits)
+    {
+        bfloat16 result;
+        result.bits = bits;
+        return result;
+    }
+
+    operator float() const { return std::bit_cast<float>((uint32_t)bits << 16); }
+};
+
+template <typename D>
+concept HalfType = std::same_as<D, float16> || std::same_as<D, bfloat16>;
+
+template <HalfType H> inline H operator+(H a, H b) { return H((float)a + (float)b); }
+template <HalfType H> inline H operator-(H a, H b) { return H((float)a - (float)b); }
+template <HalfType H> inline H operator*(H a, H b) { return H((float)a * (float)b); }
+template <HalfType H> inline H operator/(H a, H b) { return H((float)a / (float)b); }
+template <HalfType H> inline H operator-(H a) { return H::from_bits(a.bits ^ 0x8000); }
+template <HalfType H> inline H& operator+=(H& a, H b) { return a = a + b; }
+
+// Loads eight elements and widens them to fp32 in a register. The float overload lets kernels be written once for
+// every storage type.
+inline __m256 cvt_load_ps(const float* src) { return _mm256_loadu_ps(src); }
+
+inline __m256 cvt_load_ps(const float16* src)
+{
+    return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+}
+
+inline __m256 cvt_load_ps(const bfloat16* src)
+{
+    __m256i widened = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(widened, 16));
+}
+
+// Narrows eight fp32 lanes to the storage type (round to nearest-even) and stores them.
+inline void cvt_store_ps(float* dst, __m256 value) { _mm256_storeu_ps(dst, value); }
+
+inline void cvt_store_ps(float16* dst, __m256 value)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT));
+}
+
+inline void cvt_store_ps(bfloat16* dst, __m256 value)
+{
+    __m256i u = _mm256_castps_si256(value);
+    __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(u, 16), _mm256_set1_epi32(1));
+    __m256i rounded = _mm256_add_epi32(u, _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7FFF)));
+    __m256i quiet_nan = _mm256_or_si256(u, _mm256_set1_epi32(0x00400000));
+    __m256 is_nan = _mm256_cmp_ps(value, value, _CMP_UNORD_Q);
+    __m256i bits = _mm256_castps_si256(
+        _mm256_blendv_ps(_mm256_castsi256_ps(rounded), _mm256_castsi256_ps(quiet_nan), is_nan));
+    bits = _mm256_srli_epi32(bits, 16);
+
+    __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(bits), _mm256_extracti128_si256(bits, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), packed);
+}
+
+// Converts `n` elements between fp32 and a half-precision storage type, eight at a time.
+template <typename S, typename D>
+requires(HalfType<S> && std::same_as<D, float>) || (std::same_as<S, float> && HalfType<D>)
+void convert(const S* src, D* dst, size_t n)
+{
+    size_t i = 0;
+    for (; i + 7 < n; i += 8)
+        cvt_store_ps(dst + i, cvt_load_ps(src + i));
+    for (; i < n; i++)
+        dst[i] = D((float)src[i]);
+}
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Tensile {
+
+// Fused float kernels behind Tensor::softmax/log_softmax/layer_norm/rms_norm. The input is viewed as a contiguous
+// [outer, len, inner] block and each of the outer * inner lines of `len` elements (stride `inner`) is normalized
+// independently. Each line is read twice (statistics, then output) while it is still in cache and written once, with
+// no temporaries.
+
+// y = softmax(x) (or log_softmax when `log` is set) along the `len` axis. The maximum and the sum of exponentials are
+// tracked together in one online pass, so large inputs do not overflow.
+void softmax_f32(const float* x, float* y, size_t outer, size_t len, size_t inner, bool log);
+
+// y = (x - mean) / sqrt(var + eps) * gamma + beta over rows of length `len`. gamma and beta have `len` elements and
+// may be null (no scaling / no shift).
+void layer_norm_f32(const float* x, float* y, size_t rows, size_t len, const float* gamma, const float* beta,
+                    float eps);
+
+// y = x / sqrt(mean(x^2) + eps) * gamma over rows of length `len`. gamma may be null.
+void rms_norm_f32(const float* x, float* y, size_t rows, size_t len, const float* gamma, float eps);
+
+}
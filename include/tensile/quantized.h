@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "tensor.h"
+
+namespace Tensile {
+
+// Quantized values are kept in [-127, 127]. Dropping -128 keeps the representation symmetric and lets the int8 GEMM
+// use the abs/sign trick with _mm256_maddubs_epi16 without overflowing its int16 intermediate sums.
+static constexpr int32_t QINT8_MIN = -127;
+static constexpr int32_t QINT8_MAX = 127;
+
+// An int8 tensor with affine quantization parameters: real = scale * (q - zero_point). Parameters are either one
+// (scale, zero_point) pair for the whole tensor, or one pair per index along `axis` (per-channel).
+class QuantizedTensor {
+public:
+    QuantizedTensor(Tensor<int8_t>&& values, std::vector<float> scales, std::vector<int32_t> zero_points,
+                    std::optional<size_t> axis = std::nullopt);
+
+    // Owns its int8 storage, so it can be moved but not copied (a Tensor copy would alias the storage).
+    QuantizedTensor(const QuantizedTensor&) = delete;
+    QuantizedTensor& operator=(const QuantizedTensor&) = delete;
+    QuantizedTensor(QuantizedTensor&&) = default;
+    QuantizedTensor& operator=(QuantizedTensor&&) = default;
+
+    static QuantizedTensor quantize(const Tensor<float>& tensor, float scale, int32_t zero_point);
+
+    static QuantizedTensor quantize_per_channel(const Tensor<float>& tensor, const std::vector<float>& scales,
+                                                const std::vector<int32_t>& zero_points, size_t axis);
+
+    // Picks a per-tensor scale and zero point covering [min(tensor), max(tensor)].
+    static QuantizedTensor quantize_dynamic(const Tensor<float>& tensor);
+
+    // Picks a symmetric (zero point 0) scale per index along `axis`, the usual choice for GEMM weights.
+    static QuantizedTensor quantize_symmetric_per_channel(const Tensor<float>& tensor, size_t axis);
+
+    [[nodiscard]] Tensor<float> dequantize() const;
+
+    [[nodiscard]] const Tensor<int8_t>& int_repr() const { return values_; }
+
+    [[nodiscard]] bool is_per_channel() const { return axis_.has_value(); }
+
+    [[nodiscard]] std::optional<size_t> axis() const { return axis_; }
+
+    [[nodiscard]] float scale() const;
+
+    [[nodiscard]] int32_t zero_point() const;
+
+    [[nodiscard]] const std::vector<float>& scales() const { return scales_; }
+
+    [[nodiscard]] const std::vector<int32_t>& zero_points() const { return zero_points_; }
+
+    [[nodiscard]] std::array<size_t, MAX_DIM> shape() const { return values_.shape(); }
+
+    [[nodiscard]] size_t n_dims() const { return values_.n_dims(); }
+
+private:
+    // Values produced by the quantization and requantization code are already clamped to [QINT8_MIN, QINT8_MAX], so
+    // this constructor checks only the parameters and skips the scan for -128.
+    struct Clamped {};
+    QuantizedTensor(Clamped, Tensor<int8_t>&& values, std::vector<float> scales, std::vector<int32_t> zero_points,
+                    std::optional<size_t> axis = std::nullopt);
+
+    friend QuantizedTensor quantized_matmul(const QuantizedTensor& a, const QuantizedTensor& b, float out_scale,
+                                            int32_t out_zero_point);
+
+    Tensor<int8_t> values_;
+    std::vector<float> scales_;
+    std::vector<int32_t> zero_points_;
+    std::optional<size_t> axis_;
+};
+
+// int8 x int8 matrix product of [M, K] and [K, N] quantized tensors, accumulated in int32. `a` may be quantized per
+// tensor or per row (axis 0) and `b` per tensor or per column (axis 1), so that the scales factor out of the sum.
+// The first overload dequantizes the accumulators to fp32; the second requantizes them to (out_scale,
+// out_zero_point). Both apply their epilogue to each row while it is still in cache.
+Tensor<float> quantized_matmul(const QuantizedTensor& a, const QuantizedTensor& b);
+
+QuantizedTensor quantized_matmul(const QuantizedTensor& a, const QuantizedTensor& b, float out_scale,
+                                 int32_t out_zero_point);
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Tensile {
+
+// The Philox4x32-10 bijection: ten rounds of multiply/xor over a 128-bit counter under a 64-bit key.
+std::array<uint32_t, 4> philox4x32_10(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key);
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"). Block `c` is
+// a pure function of (seed, c), so any range of the stream can be produced without generating what comes before it.
+//
+// The fills draw element i of a request from lane i % 4 of block offset() + i / 4 and then move offset() past the
+// blocks they used. Every element therefore has a fixed place in the stream, and the output is the same whether the
+// fill runs on one thread or many, in one call or in several back-to-back calls of whole blocks.
+class Philox4x32 {
+public:
+    explicit Philox4x32(uint64_t seed = 0, uint64_t offset = 0)
+        : seed_(seed)
+        , offset_(offset)
+    {
+    }
+
+    uint64_t seed() const { return seed_; }
+    uint64_t offset() const { return offset_; }
+    void set_offset(uint64_t offset) { offset_ = offset; }
+
+    // The four words of block `counter` (the low half of the 128-bit counter), independent of offset().
+    std::array<uint32_t, 4> block(uint64_t counter) const;
+
+    // Uniform in [low, high), 24 random bits per float.
+    void fill_uniform(float* data, size_t n, float low = 0.0f, float high = 1.0f);
+
+    // Normal with the given mean and standard deviation (Box-Muller on pairs of words).
+    void fill_normal(float* data, size_t n, float mean = 0.0f, float stddev = 1.0f);
+
+    // Double variants draw two words per element (53 random bits), i.e. two elements per block.
+    void fill_uniform(double* data, size_t n, double low = 0.0, double high = 1.0);
+    void fill_normal(double* data, size_t n, double mean = 0.0, double stddev = 1.0);
+
+private:
+    uint64_t seed_;
+    uint64_t offset_;
+};
+
+// Generator used by the Tensor factories that take no explicit one, seeded with 0 at start-up.
+Philox4x32& default_generator();
+
+}
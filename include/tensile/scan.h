@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Tensile {
+
+enum class ScanOp { SUM, PROD, MAX, MIN };
+
+// In-place inclusive scan of a contiguous float [outer, len, inner] block along the middle axis:
+// x[o, j, k] = op(x[o, j - 1, k], x[o, j, k]). MAX and MIN propagate NaN.
+//
+// Along a contiguous axis (inner == 1) eight elements are scanned in registers with log-step shifts and the running
+// carry is broadcast into the next vector. A few long lines are each cut into eight blocks that are scanned in
+// parallel, then fixed up with the carries of the blocks before them. Along other axes whole rows are combined
+// elementwise.
+void scan_f32(float* x, size_t outer, size_t len, size_t inner, ScanOp op);
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "half.h"
+
+namespace Tensile {
+
+// Tensor storage in POSIX shared memory, so that worker processes on one host can share one copy of their weights.
+//
+// A tensor shared under `name` lives in the shared memory object "/tensile.<name>": one page of header, then the
+// elements, which therefore start page aligned. The header records the element type, the shape and a reference count
+// that every process updates atomically. Each owning Tensor created by Tensor::share or Tensor::attach_shared holds
+// one reference, and views of it borrow that reference as they borrow any other storage. When the last reference in
+// any process is released the name is unlinked and the memory freed. A process that dies while holding a reference
+// leaks it; remove_shared() unlinks the name regardless, without affecting processes that are still attached.
+
+// Identifies an element type across processes, so that attaching with the wrong type fails.
+template <typename T> constexpr uint32_t shared_type_tag()
+{
+    return (uint32_t)sizeof(T) << 8 | (uint32_t)(std::is_floating_point_v<T> || HalfType<T>)
+        | (uint32_t)std::is_signed_v<T> << 1 | (uint32_t)std::same_as<T, bfloat16> << 2;
+}
+
+// Creates the object for `name` with room for `bytes` bytes of elements and one reference, and returns the address
+// of the elements. The tensor is not visible to shared_attach() until shared_publish(). Throws std::runtime_error if
+// the name is taken.
+void* shared_create(const std::string& name, size_t bytes, uint32_t type_tag, const std::vector<size_t>& shape);
+
+// Marks the elements as complete, so that other processes can attach.
+void shared_publish(void* data);
+
+// Maps a published tensor and takes a reference to it. Fills in its shape and size in bytes. Without `writable` the
+// elements are mapped read-only. Throws std::runtime_error if there is no such tensor, it has a different element
+// type, or it is not published yet.
+void* shared_attach(const std::string& name, uint32_t type_tag, bool writable, std::vector<size_t>& shape,
+                    size_t& bytes);
+
+// Drops the reference held by a mapping from shared_create() or shared_attach() and unmaps it; the last reference
+// unlinks the name. Matches the signature of Tensor's storage release hook.
+void shared_release(void* data, size_t bytes);
+
+// References currently held on the tensor whose elements start at `data`, across all processes.
+uint32_t shared_references(const void* data);
+
+// Names of the tensors currently in shared memory.
+std::vector<std::string> shared_names();
+
+// Unlinks `name` (e.g. after a worker crashed while holding a reference). Returns false if there was no such tensor.
+bool remove_shared(const std::string& name);
+
+}
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include "tensor.h"
+
+namespace Tensile {
+
+static constexpr size_t SMALL_TENSOR_MAX_ELEMS = 64;
+
+// A tensor whose shape is fixed at compile time and whose elements live inline in the object. It has no strides, no
+// offset and no parent: construction, copies and elementwise operations never touch the heap, which makes it suitable
+// for scalars, short vectors and small matrices created in bulk. Use to_tensor() / from_tensor() to cross over to the
+// dynamically shaped Tensor.
+template <typename DataType, size_t... Dims>
+requires TensorType<DataType> && (sizeof...(Dims) <= MAX_DIM) && ((Dims > 0) && ...)
+class SmallTensor {
+public:
+    static constexpr size_t N_DIMS = sizeof...(Dims);
+    static constexpr size_t SIZE = (Dims * ... * 1);
+    static constexpr std::array<size_t, MAX_DIM> SHAPE = [] {
+        std::array<size_t, MAX_DIM> shape {};
+        size_t i = 0;
+        ((shape[i++] = Dims), ...);
+        return shape;
+    }();
+
+    // Tensor has no rank-0 form, so scalars cross over as one-element [1] tensors.
+    static constexpr size_t TENSOR_N_DIMS = std::max(N_DIMS, (size_t)1);
+    static constexpr std::array<size_t, MAX_DIM> TENSOR_SHAPE = N_DIMS == 0 ? std::array<size_t, MAX_DIM> { 1 } : SHAPE;
+
+    static_assert(SIZE <= SMALL_TENSOR_MAX_ELEMS, "SmallTensor is meant for tiny tensors, use Tensor instead");
+
+    constexpr SmallTensor()
+        : data_ {}
+    {
+    }
+
+    constexpr SmallTensor(std::initializer_list<DataType> values)
+        : data_ {}
+    {
+        if (values.size() != SIZE)
+            throw std::invalid_argument("Number of values does not match the SmallTensor size");
+        std::copy(values.begin(), values.end(), data_.begin());
+    }
+
+    static constexpr SmallTensor full(DataType value)
+    {
+        SmallTensor result;
+        result.data_.fill(value);
+        return result;
+    }
+
+    static constexpr SmallTensor zeros() { return full(0); }
+
+    static constexpr SmallTensor ones() { return full(1); }
+
+    static constexpr SmallTensor identity()
+    requires(N_DIMS == 2 && SHAPE[0] == SHAPE[1])
+    {
+        SmallTensor result;
+        for (size_t i = 0; i < SHAPE[0]; i++)
+            result(i, i) = 1;
+        return result;
+    }
+
+    static SmallTensor from_tensor(const Tensor<DataType>& tensor)
+    {
+        if (tensor.n_dims() != TENSOR_N_DIMS || tensor.shape() != TENSOR_SHAPE)
+            throw std::invalid_argument("Tensor shape does not match the SmallTensor shape");
+
+        SmallTensor result;
+        tensor.contiguous().copy_to(result.data_.data());
+        return result;
+    }
+
+    [[nodiscard]] Tensor<DataType> to_tensor() const
+    {
+        auto* data = new DataType[SIZE];
+        std::copy(data_.begin(), data_.end(), data);
+        return Tensor<DataType>(data, TENSOR_SHAPE);
+    }
+
+    [[nodiscard]] static constexpr size_t size() { return SIZE; }
+
+    [[nodiscard]] static constexpr size_t n_dims() { return N_DIMS; }
+
+    [[nodiscard]] static constexpr std::array<size_t, MAX_DIM> shape() { return SHAPE; }
+
+    constexpr DataType* data() { return data_.data(); }
+
+    constexpr const DataType* data() const { return data_.data(); }
+
+    template <typename... Indices>
+    requires(sizeof...(Indices) == N_DIMS)
+    constexpr DataType& operator()(Indices... indices)
+    {
+        return data_[flat_index({ static_cast<size_t>(indices)... })];
+    }
+
+    template <typename... Indices>
+    requires(sizeof...(Indices) == N_DIMS)
+    constexpr DataType operator()(Indices... indices) const
+    {
+        return data_[flat_index({ static_cast<size_t>(indices)... })];
+    }
+
+    constexpr DataType item() const
+    requires(SIZE == 1)
+    {
+        return data_[0];
+    }
+
+    constexpr bool operator==(const SmallTensor& other) const = default;
+
+    constexpr SmallTensor operator+(const SmallTensor& other) const
+    {
+        return binary_op(other, [](DataType a, DataType b) { return a + b; });
+    }
+
+    constexpr SmallTensor operator-(const SmallTensor& other) const
+    {
+        return binary_op(other, [](DataType a, DataType b) { return a - b; });
+    }
+
+    constexpr SmallTensor elementwise_mul(const SmallTensor& other) const
+    {
+        return binary_op(other, [](DataType a, DataType b) { return a * b; });
+    }
+
+    constexpr SmallTensor operator*(DataType scalar) const
+    {
+        return unary_op([scalar](DataType a) { return a * scalar; });
+    }
+
+    constexpr SmallTensor operator+(DataType scalar) const
+    {
+        return unary_op([scalar](DataType a) { return a + scalar; });
+    }
+
+    constexpr SmallTensor operator-() const
+    {
+        return unary_op([](DataType a) { return -a; });
+    }
+
+    constexpr SmallTensor& operator+=(const SmallTensor& other)
+    {
+        for (size_t i = 0; i < SIZE; i++)
+            data_[i] += other.data_[i];
+        return *this;
+    }
+
+    constexpr SmallTensor& operator-=(const SmallTensor& other)
+    {
+        for (size_t i = 0; i < SIZE; i++)
+            data_[i] -= other.data_[i];
+        return *this;
+    }
+
+    SmallTensor exp() const
+    {
+        return unary_op([](DataType a) { return (DataType)std::exp(a); });
+    }
+
+    constexpr DataType sum() const
+    {
+        DataType total = 0;
+        for (size_t i = 0; i < SIZE; i++)
+            total += data_[i];
+        return total;
+    }
+
+    constexpr DataType dot(const SmallTensor& other) const
+    requires(N_DIMS == 1)
+    {
+        DataType total = 0;
+        for (size_t i = 0; i < SIZE; i++)
+            total += data_[i] * other.data_[i];
+        return total;
+    }
+
+    constexpr SmallTensor cross(const SmallTensor& other) const
+    requires(N_DIMS == 1 && SIZE == 3)
+    {
+        const auto& a = data_;
+        const auto& b = other.data_;
+        return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+    }
+
+    constexpr auto transpose() const
+    requires(N_DIMS == 2)
+    {
+        SmallTensor<DataType, SHAPE[1], SHAPE[0]> result;
+        for (size_t i = 0; i < SHAPE[0]; i++)
+            for (size_t j = 0; j < SHAPE[1]; j++)
+                result(j, i) = (*this)(i, j);
+        return result;
+    }
+
+    // Matrix product of an [M, K] and a [K, N] small tensor.
+    template <size_t OtherRows, size_t OtherCols>
+    requires(N_DIMS == 2 && SHAPE[1] == OtherRows)
+    constexpr SmallTensor<DataType, SHAPE[0], OtherCols>
+    operator*(const SmallTensor<DataType, OtherRows, OtherCols>& other) const
+    {
+        SmallTensor<DataType, SHAPE[0], OtherCols> result;
+        for (size_t i = 0; i < SHAPE[0]; i++)
+            for (size_t k = 0; k < SHAPE[1]; k++) {
+                DataType a = (*this)(i, k);
+                for (size_t j = 0; j < OtherCols; j++)
+                    result(i, j) += a * other(k, j);
+            }
+        return result;
+    }
+
+    // Matrix-vector product of an [M, K] small tensor and a [K] small tensor.
+    template <size_t Len>
+    requires(N_DIMS == 2 && SHAPE[1] == Len)
+    constexpr auto operator*(const SmallTensor<DataType, Len>& vec) const
+    {
+        SmallTensor<DataType, SHAPE[0]> result;
+        for (size_t i = 0; i < SHAPE[0]; i++)
+            for (size_t k = 0; k < Len; k++)
+                result(i) += (*this)(i, k) * vec(k);
+        return result;
+    }
+
+private:
+    static constexpr size_t flat_index(const std::array<size_t, N_DIMS>& indices)
+    {
+        size_t flat_idx = 0;
+        for (size_t i = 0; i < N_DIMS; i++) {
+            if (indices[i] >= SHAPE[i])
+                throw std::out_of_range("Index out of bounds");
+            flat_idx = flat_idx * SHAPE[i] + indices[i];
+        }
+        return flat_idx;
+    }
+
+    template <typename Op> constexpr SmallTensor binary_op(const SmallTensor& other, Op op) const
+    {
+        SmallTensor result;
+        for (size_t i = 0; i < SIZE; i++)
+            result.data_[i] = op(data_[i], other.data_[i]);
+        return result;
+    }
+
+    template <typename Op> constexpr SmallTensor unary_op(Op op) const
+    {
+        SmallTensor result;
+        for (size_t i = 0; i < SIZE; i++)
+            result.data_[i] = op(data_[i]);
+        return result;
+    }
+
+private:
+    std::array<DataType, SIZE> data_;
+};
+
+template <typename DataType> using Vec3 = SmallTensor<DataType, 3>;
+template <typename DataType> using Vec4 = SmallTensor<DataType, 4>;
+template <typename DataType> using Mat3 = SmallTensor<DataType, 3, 3>;
+template <typename DataType> using Mat4 = SmallTensor<DataType, 4, 4>;
+
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Tensile::Sort {
+
+// Building blocks of Tensor::sort/argsort/topk. Every ordering here is total: values first (NaN ranks above every
+// number, as in NumPy), then the original index, so sorts are stable and parallel runs return exactly what a serial
+// run would.
+
+// Lines at least this long are sorted with the parallel merge sort; top-k splits them into chunks of this size.
+static constexpr size_t PARALLEL_LINE = 1 << 16;
+
+template <typename T> struct Entry {
+    T value;
+    int64_t index;
+};
+
+// Half types compare through float.
+template <typename T> using Key = std::conditional_t<std::is_arithmetic_v<T>, T, float>;
+
+template <typename T> inline bool is_nan(T value)
+{
+    if constexpr (std::is_integral_v<T>)
+        return false;
+    else
+        return (Key<T>)value != (Key<T>)value;
+}
+
+// Strict "a ranks before b" for ascending (`descending` false) or descending order.
+template <typename T> struct Before {
+    bool descending;
+
+    bool operator()(const Entry<T>& a, const Entry<T>& b) const
+    {
+        Key<T> x = (Key<T>)a.value, y = (Key<T>)b.value;
+        bool x_nan = is_nan(a.value), y_nan = is_nan(b.value);
+        if (x_nan || y_nan) {
+            if (x_nan != y_nan)
+                return descending ? x_nan : y_nan;
+        } else if (x != y) {
+            return descending ? x > y : x < y;
+        }
+        return a.index < b.index;
+    }
+};
+
+// Sorts [data, data + n). Long ranges are cut into eight runs that are sorted in parallel and then merged pairwise,
+// also in parallel.
+template <typename T> void parallel_sort(Entry<T>* data, size_t n, Before<T> before)
+{
+    constexpr size_t RUNS = 8;
+    if (n < PARALLEL_LINE) {
+        std::sort(data, data + n, before);
+        return;
+    }
+
+    size_t bounds[RUNS + 1];
+    for (size_t r = 0; r <= RUNS; r++)
+        bounds[r] = n * r / RUNS;
+
+#pragma omp parallel for num_threads(8)
+    for (size_t r = 0; r < RUNS; r++)
+        std::sort(data + bounds[r], data + bounds[r + 1], before);
+
+    std::vector<Entry<T>> buffer(n);
+    Entry<T>* src = data;
+    Entry<T>* dst = buffer.data();
+    for (size_t width = 1; width < RUNS; width *= 2) {
+#pragma omp parallel for num_threads(8)
+        for (size_t r = 0; r < RUNS; r += 2 * width) {
+            size_t lo = bounds[r], mid = bounds[std::min(r + width, RUNS)], hi = bounds[std::min(r + 2 * width, RUNS)];
+            std::merge(src + lo, src + mid, src + mid, src + hi, dst + lo, before);
+        }
+        std::swap(src, dst);
+    }
+    if (src != data)
+        std::copy(src, src + n, data);
+}
+
+// Keeps the k entries that rank first among line[i * stride] for i in [0, len), with indices offset by `first`.
+// `heap` is a heap under `before`, so its front is the worst entry kept and the one the next candidate must beat.
+template <typename T>
+void select_into(const T* line, size_t len, size_t stride, int64_t first, size_t k, Before<T> before,
+                 std::vector<Entry<T>>& heap)
+{
+    size_t i = 0;
+    auto offer = [&](size_t at) {
+        Entry<T> e { line[at * stride], first + (int64_t)at };
+        if (heap.size() < k) {
+            heap.push_back(e);
+            std::push_heap(heap.begin(), heap.end(), before);
+        } else if (before(e, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), before);
+            heap.back() = e;
+            std::push_heap(heap.begin(), heap.end(), before);
+        }
+    };
+
+    for (; i < len && heap.size() < k; i++)
+        offer(i);
+
+    // Once the heap is full most elements cannot enter it. Contiguous float lines are screened eight at a time
+    // against the current threshold, and only blocks with a candidate go through the heap. Equal values never
+    // enter, since the kept one has the smaller index.
+    if constexpr (std::is_same_v<T, float>) {
+        if (stride == 1) {
+            for (; i + 7 < len; i += 8) {
+                __m256 v = _mm256_loadu_ps(line + i), threshold = _mm256_set1_ps(heap.front().value);
+                // NLE/NGE are also true for NaN lanes, which the exact comparison then sorts out.
+                __m256 candidates = before.descending ? _mm256_cmp_ps(v, threshold, _CMP_NLE_UQ)
+                                                      : _mm256_cmp_ps(v, threshold, _CMP_NGE_UQ);
+                int mask = _mm256_movemask_ps(candidates);
+                for (; mask; mask &= mask - 1)
+                    offer(i + (size_t)__builtin_ctz((unsigned)mask));
+            }
+        }
+    }
+
+    for (; i < len; i++)
+        offer(i);
+}
+
+// The k first-ranking entries of a strided line, in rank order. Long lines are screened in parallel chunks whose
+// survivors are then ranked together.
+template <typename T>
+std::vector<Entry<T>> top_k(const T* line, size_t len, size_t stride, size_t k, Before<T> before, bool parallel)
+{
+    std::vector<Entry<T>> result;
+    if (!parallel || len < 2 * PARALLEL_LINE) {
+        result.reserve(k);
+        select_into(line, len, stride, 0, k, before, result);
+    } else {
+        size_t n_chunks = (len + PARALLEL_LINE - 1) / PARALLEL_LINE;
+        std::vector<std::vector<Entry<T>>> kept(n_chunks);
+
+#pragma omp parallel for num_threads(8)
+        for (size_t c = 0; c < n_chunks; c++) {
+            size_t start = c * PARALLEL_LINE;
+            kept[c].reserve(k);
+            select_into(line + start * stride, std::min(PARALLEL_LINE, len - start), stride, (int64_t)start, k,
+                        before, kept[c]);
+        }
+
+        for (auto& chunk : kept)
+            result.insert(result.end(), chunk.begin(), chunk.end());
+        std::partial_sort(result.begin(), result.begin() + (std::ptrdiff_t)k, result.end(), before);
+        result.resize(k);
+        return result;
+    }
+
+    std::sort(result.begin(), result.end(), before);
+    return result;
+}
+
+}
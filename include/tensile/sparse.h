@@ -0,0 +1,348 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "tensor.h"
+
+namespace Tensile {
+
+template <typename DataType>
+requires TensorType<DataType>
+class CsrTensor;
+
+// Coordinate-format sparse tensor of up to MAX_DIM dimensions: one (index tuple, value) pair per stored element.
+// Entries built by from_dense() are sorted in row-major order and unique; coalesce() restores that invariant after
+// entries were added by hand.
+template <typename DataType>
+requires TensorType<DataType>
+class CooTensor {
+public:
+    CooTensor(const std::vector<size_t>& shape)
+        : n_dims_(shape.size())
+    {
+        if (shape.empty() || shape.size() > MAX_DIM)
+            throw std::invalid_argument("Sparse tensor shape must have between 1 and 4 dimensions");
+        std::copy(shape.begin(), shape.end(), shape_.begin());
+    }
+
+    static CooTensor from_dense(const Tensor<DataType>& dense)
+    {
+        auto shape = dense.shape();
+        CooTensor result({ shape.begin(), shape.begin() + dense.n_dims() });
+
+        auto src = dense.contiguous();
+        const DataType* data = src.data();
+        for (size_t flat = 0; flat < dense.size(); flat++) {
+            if (data[flat] == DataType(0))
+                continue;
+            result.indices_.push_back(result.unflatten(flat));
+            result.values_.push_back(data[flat]);
+        }
+
+        return result;
+    }
+
+    void insert(const std::array<size_t, MAX_DIM>& index, DataType value)
+    {
+        for (size_t d = 0; d < n_dims_; d++)
+            if (index[d] >= shape_[d])
+                throw std::out_of_range("Index out of bounds");
+        indices_.push_back(index);
+        values_.push_back(value);
+    }
+
+    // Sorts entries in row-major order and sums duplicates.
+    void coalesce()
+    {
+        std::vector<size_t> order(nnz());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return indices_[a] < indices_[b]; });
+
+        std::vector<std::array<size_t, MAX_DIM>> indices;
+        std::vector<DataType> values;
+        for (size_t i : order) {
+            if (!indices.empty() && indices.back() == indices_[i]) {
+                values.back() += values_[i];
+                continue;
+            }
+            indices.push_back(indices_[i]);
+            values.push_back(values_[i]);
+        }
+
+        indices_ = std::move(indices);
+        values_ = std::move(values);
+    }
+
+    [[nodiscard]] Tensor<DataType> to_dense() const
+    {
+        size_t n = size();
+        auto* data = new DataType[n];
+        std::fill(data, data + n, DataType(0));
+        for (size_t e = 0; e < nnz(); e++)
+            data[flatten(indices_[e])] += values_[e];
+        return Tensor<DataType>(data, { shape_.begin(), shape_.begin() + n_dims_ });
+    }
+
+    [[nodiscard]] CsrTensor<DataType> to_csr() const
+    {
+        if (n_dims_ != 2)
+            throw std::invalid_argument("CSR conversion is only defined for 2D sparse tensors");
+
+        CooTensor sorted = *this;
+        sorted.coalesce();
+
+        std::vector<size_t> row_ptr(shape_[0] + 1, 0), col_idx(sorted.nnz());
+        for (size_t e = 0; e < sorted.nnz(); e++) {
+            row_ptr[sorted.indices_[e][0] + 1]++;
+            col_idx[e] = sorted.indices_[e][1];
+        }
+        std::partial_sum(row_ptr.begin(), row_ptr.end(), row_ptr.begin());
+
+        return CsrTensor<DataType>(shape_[0], shape_[1], std::move(row_ptr), std::move(col_idx),
+                                   std::move(sorted.values_));
+    }
+
+    // Multiplies every stored element by the matching element of `dense`, which must have the same shape or be
+    // broadcastable to it. Elements missing from this tensor stay zero, so the result keeps this sparsity pattern.
+    [[nodiscard]] CooTensor elementwise_mul(const Tensor<DataType>& dense) const
+    {
+        auto strides = broadcast_strides(dense);
+        CooTensor result = *this;
+
+#pragma omp parallel for num_threads(8) if (nnz() > (1 << 16))
+        for (size_t e = 0; e < nnz(); e++) {
+            size_t offset = 0;
+            for (size_t d = 0; d < n_dims_; d++)
+                offset += indices_[e][d] * strides[d];
+            result.values_[e] = values_[e] * dense.data()[offset];
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] size_t nnz() const { return values_.size(); }
+
+    [[nodiscard]] size_t n_dims() const { return n_dims_; }
+
+    [[nodiscard]] std::array<size_t, MAX_DIM> shape() const { return shape_; }
+
+    [[nodiscard]] size_t size() const
+    {
+        return std::accumulate(shape_.begin(), shape_.begin() + n_dims_, (size_t)1, std::multiplies<>());
+    }
+
+    [[nodiscard]] const std::vector<std::array<size_t, MAX_DIM>>& indices() const { return indices_; }
+
+    [[nodiscard]] const std::vector<DataType>& values() const { return values_; }
+
+private:
+    [[nodiscard]] std::array<size_t, MAX_DIM> unflatten(size_t flat) const
+    {
+        std::array<size_t, MAX_DIM> index {};
+        for (int d = (int)n_dims_ - 1; d >= 0; d--) {
+            index[d] = flat % shape_[d];
+            flat /= shape_[d];
+        }
+        return index;
+    }
+
+    [[nodiscard]] size_t flatten(const std::array<size_t, MAX_DIM>& index) const
+    {
+        size_t flat = 0;
+        for (size_t d = 0; d < n_dims_; d++)
+            flat = flat * shape_[d] + index[d];
+        return flat;
+    }
+
+    [[nodiscard]] std::array<size_t, MAX_DIM> broadcast_strides(const Tensor<DataType>& dense) const
+    {
+        if (dense.n_dims() != n_dims_)
+            throw std::invalid_argument("Incompatible shapes for element-wise operation");
+
+        std::array<size_t, MAX_DIM> strides {};
+        for (size_t d = 0; d < n_dims_; d++) {
+            if (dense.shape()[d] != shape_[d] && dense.shape()[d] != 1)
+                throw std::invalid_argument("Incompatible shapes for element-wise operation");
+            strides[d] = dense.shape()[d] == 1 ? 0 : dense.strides()[d];
+        }
+        return strides;
+    }
+
+private:
+    std::array<size_t, MAX_DIM> shape_ {};
+    size_t n_dims_;
+    std::vector<std::array<size_t, MAX_DIM>> indices_;
+    std::vector<DataType> values_;
+};
+
+// Compressed sparse row matrix. Row i stores its column indices (sorted) and values in
+// [row_ptr[i], row_ptr[i + 1]) of col_idx / values.
+template <typename DataType>
+requires TensorType<DataType>
+class CsrTensor {
+public:
+    CsrTensor(size_t rows, size_t cols, std::vector<size_t> row_ptr, std::vector<size_t> col_idx,
+              std::vector<DataType> values)
+        : rows_(rows)
+        , cols_(cols)
+        , row_ptr_(std::move(row_ptr))
+        , col_idx_(std::move(col_idx))
+        , values_(std::move(values))
+    {
+        if (row_ptr_.size() != rows_ + 1 || row_ptr_.front() != 0 || row_ptr_.back() != values_.size()
+            || col_idx_.size() != values_.size())
+            throw std::invalid_argument("Inconsistent CSR arrays");
+        for (size_t i = 0; i < rows_; i++) {
+            if (row_ptr_[i] > row_ptr_[i + 1])
+                throw std::invalid_argument("CSR row pointers must be non-decreasing");
+            for (size_t e = row_ptr_[i]; e < row_ptr_[i + 1]; e++)
+                if (col_idx_[e] >= cols_ || (e > row_ptr_[i] && col_idx_[e] <= col_idx_[e - 1]))
+                    throw std::invalid_argument("CSR column indices must be in bounds and increasing per row");
+        }
+    }
+
+    static CsrTensor from_dense(const Tensor<DataType>& dense)
+    {
+        if (dense.n_dims() != 2)
+            throw std::invalid_argument("CSR conversion is only defined for 2D tensors");
+
+        size_t rows = dense.shape()[0], cols = dense.shape()[1];
+        auto src = dense.contiguous();
+        const DataType* data = src.data();
+
+        std::vector<size_t> row_ptr(rows + 1, 0), col_idx;
+        std::vector<DataType> values;
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < cols; j++) {
+                if (data[i * cols + j] == DataType(0))
+                    continue;
+                col_idx.push_back(j);
+                values.push_back(data[i * cols + j]);
+            }
+            row_ptr[i + 1] = values.size();
+        }
+
+        return CsrTensor(rows, cols, std::move(row_ptr), std::move(col_idx), std::move(values));
+    }
+
+    [[nodiscard]] Tensor<DataType> to_dense() const
+    {
+        auto* data = new DataType[rows_ * cols_];
+        std::fill(data, data + rows_ * cols_, DataType(0));
+        for (size_t i = 0; i < rows_; i++)
+            for (size_t e = row_ptr_[i]; e < row_ptr_[i + 1]; e++)
+                data[i * cols_ + col_idx_[e]] = values_[e];
+        return Tensor<DataType>(data, { rows_, cols_ });
+    }
+
+    [[nodiscard]] CooTensor<DataType> to_coo() const
+    {
+        CooTensor<DataType> result({ rows_, cols_ });
+        for (size_t i = 0; i < rows_; i++)
+            for (size_t e = row_ptr_[i]; e < row_ptr_[i + 1]; e++)
+                result.insert({ i, col_idx_[e] }, values_[e]);
+        return result;
+    }
+
+    // Sparse x dense product. A 2D [cols, N] operand gives SpMM, a 1D [cols] operand gives SpMV.
+    Tensor<DataType> operator*(const Tensor<DataType>& dense) const
+    {
+        if (dense.n_dims() == 1)
+            return matvec(dense);
+        return matmul(dense);
+    }
+
+    // C[rows, N] = A * B. Each output row is an accumulation of rows of B scaled by the stored values of the
+    // corresponding row of A; rows are distributed dynamically because their nnz can be very uneven.
+    [[nodiscard]] Tensor<DataType> matmul(const Tensor<DataType>& dense) const
+    {
+        if (dense.n_dims() != 2 || dense.shape()[0] != cols_)
+            throw std::invalid_argument("Incompatible shapes for sparse matrix multiplication");
+
+        size_t n = dense.shape()[1];
+        auto b = dense.contiguous();
+        const DataType* b_data = b.data();
+        auto* data = new DataType[rows_ * n];
+
+#pragma omp parallel for num_threads(8) schedule(dynamic, 16)
+        for (size_t i = 0; i < rows_; i++) {
+            DataType* c_row = data + i * n;
+            std::fill(c_row, c_row + n, DataType(0));
+            for (size_t e = row_ptr_[i]; e < row_ptr_[i + 1]; e++) {
+                const DataType value = values_[e];
+                const DataType* b_row = b_data + col_idx_[e] * n;
+#pragma omp simd
+                for (size_t j = 0; j < n; j++)
+                    c_row[j] += value * b_row[j];
+            }
+        }
+
+        return Tensor<DataType>(data, { rows_, n });
+    }
+
+    [[nodiscard]] Tensor<DataType> matvec(const Tensor<DataType>& vec) const
+    {
+        if (vec.n_dims() != 1 || vec.shape()[0] != cols_)
+            throw std::invalid_argument("Incompatible shapes for sparse matrix-vector multiplication");
+
+        auto x = vec.contiguous();
+        const DataType* x_data = x.data();
+        auto* data = new DataType[rows_];
+
+#pragma omp parallel for num_threads(8) schedule(dynamic, 64)
+        for (size_t i = 0; i < rows_; i++) {
+            DataType sum = 0;
+            for (size_t e = row_ptr_[i]; e < row_ptr_[i + 1]; e++)
+                sum += values_[e] * x_data[col_idx_[e]];
+            data[i] = sum;
+        }
+
+        return Tensor<DataType>(data, { rows_ });
+    }
+
+    // Multiplies every stored element by the matching element of a [rows, cols] (or broadcastable) dense tensor,
+    // keeping this sparsity pattern.
+    [[nodiscard]] CsrTensor elementwise_mul(const Tensor<DataType>& dense) const
+    {
+        if (dense.n_dims() != 2 || (dense.shape()[0] != rows_ && dense.shape()[0] != 1)
+            || (dense.shape()[1] != cols_ && dense.shape()[1] != 1))
+            throw std::invalid_argument("Incompatible shapes for element-wise operation");
+
+        size_t row_stride = dense.shape()[0] == 1 ? 0 : dense.strides()[0];
+        size_t col_stride = dense.shape()[1] == 1 ? 0 : dense.strides()[1];
+        const DataType* d = dense.data();
+
+        std::vector<DataType> values(values_.size());
+#pragma omp parallel for num_threads(8) schedule(dynamic, 64)
+        for (size_t i = 0; i < rows_; i++)
+            for (size_t e = row_ptr_[i]; e < row_ptr_[i + 1]; e++)
+                values[e] = values_[e] * d[i * row_stride + col_idx_[e] * col_stride];
+
+        return CsrTensor(rows_, cols_, row_ptr_, col_idx_, std::move(values));
+    }
+
+    [[nodiscard]] size_t nnz() const { return values_.size(); }
+
+    [[nodiscard]] std::array<size_t, MAX_DIM> shape() const { return { rows_, cols_, 0, 0 }; }
+
+    [[nodiscard]] size_t n_dims() const { return 2; }
+
+    [[nodiscard]] const std::vector<size_t>& row_ptr() const { return row_ptr_; }
+
+    [[nodiscard]] const std::vector<size_t>& col_idx() const { return col_idx_; }
+
+    [[nodiscard]] const std::vector<DataType>& values() const { return values_; }
+
+private:
+    size_t rows_;
+    size_t cols_;
+    std::vector<size_t> row_ptr_;
+    std::vector<size_t> col_idx_;
+    std::vector<DataType> values_;
+};
+
+}
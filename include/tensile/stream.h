@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+#include "tensor.h"
+
+namespace Tensile {
+
+// Out-of-core execution over tensors that need not fit in memory, typically from Tensor::map_file/create_file.
+// Operands are worked through in tiles sized to `memory_budget` bytes: the next tile is prefetched while the current
+// one is computed, and finished tiles are marked for reclaim, so the resident set stays near the budget. In-memory
+// tensors are accepted too; the hints are then no-ops.
+struct StreamOptions {
+    size_t memory_budget { size_t(1) << 30 };
+};
+
+enum class ReduceOp { SUM, MEAN, MAX, MIN };
+
+// c = a · b for row-major [M, K] and [K, N] float matrices, written into an [M, N] `c` with contiguous rows. Each
+// block of C rows is accumulated over K in panels of B, then flushed back to its file before the next block starts.
+void matmul_streamed(const Tensor<float>& a, const Tensor<float>& b, Tensor<float>& c,
+                     const StreamOptions& options = {});
+
+// Reduction of a contiguous float tensor along `axis`, accumulated in double over contiguous tiles of the input. The
+// result (the input shape without `axis`) is an ordinary in-memory tensor. MAX and MIN propagate NaN.
+Tensor<float> reduce_streamed(const Tensor<float>& x, size_t axis, ReduceOp op, const StreamOptions& options = {});
+
+}
@@ -6,30 +6,70 @@
 #include <cmath>
 #include <concepts>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <immintrin.h>
+#include <limits>
 #include <numeric>
+#include <type_traits>
 #include <utility>
 
+#include "alloc.h"
+#include "batched.h"
+#include "cast.h"
+#include "compare.h"
 #include "enumerate.h"
+#include "format.h"
+#include "gather.h"
+#include "gemm_kernel.h"
+#include "gemm_tune.h"
+#include "gemv.h"
+#include "half.h"
 #include "index_parser.h"
 #include "logger.h"
+#include "norm.h"
+#include "random.h"
+#include "scan.h"
+#include "shared.h"
+#include "sort.h"
 #include "unimpl.h"
 
 namespace Tensile {
 
+template <typename D>
+concept FloatingType = std::floating_point<D> || HalfType<D>;
+
+// Half types only combine with themselves: their kernels (e.g. the fp32-accumulating GEMM) take two operands of one
+// type, and mixing with float would need an explicit astype() anyway.
 template <typename D, typename S>
-concept CompatibleTypes
-    = (std::floating_point<D> && std::floating_point<S>) || (std::integral<D> && std::is_same_v<D, S>);
+concept CompatibleTypes = (std::floating_point<D> && std::floating_point<S>)
+    || ((HalfType<D> || std::integral<D>) && std::is_same_v<D, S>);
 
 template <typename D>
-concept TensorType = std::integral<D> || std::floating_point<D>;
+concept TensorType = std::integral<D> || FloatingType<D>;
 
 static constexpr size_t MAX_DIM = 4;
 
+// concat() copies runs of at most CONCAT_PIECE elements, in parallel once the output has CONCAT_PARALLEL elements.
+static constexpr size_t CONCAT_PIECE = 1 << 16;
+static constexpr size_t CONCAT_PARALLEL = 1 << 17;
+
+// Batched float matmuls whose products have at most SGEMM_MIN_WORK multiply-adds each skip sgemm, whose packing costs
+// more than such a product.
+static constexpr size_t SGEMM_MIN_WORK = 64;
+
+// Order of the elements of a dense tensor in memory: the last axis varies fastest (C order) or the first one does
+// (Fortran order). Kernels read strides, so any order is accepted everywhere; these are the two that a tensor can be
+// created in or converted to.
+enum class MemoryOrder { ROW_MAJOR, COLUMN_MAJOR };
+
 template <typename DataType>
 requires TensorType<DataType>
 class Tensor {
+    template <typename D>
+    requires TensorType<D>
+    friend class Tensor;
+
 public:
     Tensor()
         : n_dims_(0)
@@ -55,6 +95,13 @@ public:
         init_strides();
     }
 
+    // Takes ownership of `data`, whose elements are in `order`, e.g. a Fortran-ordered array.
+    Tensor(DataType* data, const std::vector<size_t>& pshape, MemoryOrder order)
+        : Tensor(data, pshape)
+    {
+        init_strides(order);
+    }
+
     Tensor(DataType* data, size_t shape[MAX_DIM])
         : Tensor(data, std::vector<size_t>(shape, shape + MAX_DIM))
     {
@@ -92,6 +139,49 @@ public:
         return *this;
     }
 
+    // Moving transfers ownership of the storage, so owning tensors can be returned from functions that have more than
+    // one return path (where copy elision is not guaranteed) without turning the result into a dangling view.
+    Tensor(Tensor<DataType>&& other) noexcept
+        : shape_(other.shape_)
+        , strides_(other.strides_)
+        , n_dims_(other.n_dims_)
+        , offset_(other.offset_)
+        , parent(other.parent)
+        , data_(other.data_)
+        , release_(other.release_)
+        , storage_bytes_(other.storage_bytes_)
+    {
+        if (other.parent == nullptr) {
+            other.data_ = nullptr;
+            other.release_ = nullptr;
+        }
+    }
+
+    Tensor& operator=(Tensor<DataType>&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        if (parent == nullptr)
+            release_storage();
+
+        shape_ = other.shape_;
+        strides_ = other.strides_;
+        n_dims_ = other.n_dims_;
+        offset_ = other.offset_;
+        parent = other.parent;
+        data_ = other.data_;
+        release_ = other.release_;
+        storage_bytes_ = other.storage_bytes_;
+
+        if (other.parent == nullptr) {
+            other.data_ = nullptr;
+            other.release_ = nullptr;
+        }
+
+        return *this;
+    }
+
     Tensor copy() const
     {
         Tensor<DataType> new_tensor;
@@ -101,16 +191,76 @@ public:
         new_tensor.parent = nullptr;
 
         std::copy(shape_.begin(), shape_.end(), new_tensor.shape_.begin());
-        std::copy(strides_.begin(), strides_.end(), new_tensor.strides_.begin());
+        new_tensor.init_strides();
+        copy_to(new_tensor.data_);
 
-        auto iter = get_iter_shape(shape_);
-        ENUMERATE(iter, i, j, k, l)
-        {
-            size_t flat_idx = multi_indices_to_flat({ i, j, k, l });
-            new_tensor.data_[flat_idx] = data_[flat_idx];
+        return new_tensor;
+    }
+
+    // Writes the elements of this (possibly strided) tensor to `dst` in row-major order.
+    void copy_to(DataType* dst) const
+    {
+        if (is_contiguous()) {
+            std::copy(data_ + offset_, data_ + offset_ + size(), dst);
+            return;
         }
 
-        return new_tensor;
+        auto iter = get_iter_shape(shape_);
+        const DataType* src = data_ + offset_;
+        for (size_t i = 0; i < iter[0]; i++)
+            for (size_t j = 0; j < iter[1]; j++)
+                for (size_t k = 0; k < iter[2]; k++) {
+                    const DataType* row = src + i * strides_[0] + j * strides_[1] + k * strides_[2];
+                    for (size_t l = 0; l < iter[3]; l++)
+                        *dst++ = row[l * strides_[3]];
+                }
+    }
+
+    // Returns a view of this tensor if its elements are already laid out in row-major order, otherwise a contiguous
+    // copy.
+    Tensor<DataType> contiguous() const
+    {
+        if (is_contiguous())
+            return *this;
+        return copy();
+    }
+
+    // Row-major copy with every element converted to T. See CastMode for out-of-range values.
+    template <TensorType T> Tensor<T> astype(CastMode mode = CastMode::WRAP) const
+    {
+        auto result = Tensor<T>::empty(shape_vector());
+        astype_into(result, mode);
+        return result;
+    }
+
+    // Converts into an existing contiguous tensor of the same shape, e.g. a buffer reused at every pipeline stage.
+    template <TensorType T> void astype_into(Tensor<T>& out, CastMode mode = CastMode::WRAP) const
+    {
+        if (out.n_dims_ != n_dims_ || out.shape_ != shape_)
+            throw std::invalid_argument("astype_into() output must have the shape of the input");
+        if (!out.is_contiguous())
+            throw std::invalid_argument("astype_into() output must be contiguous");
+
+        auto src = contiguous();
+        cast(src.data(), out.data(), size(), mode);
+    }
+
+    // Row-major copy in POSIX shared memory under `name`, which other processes on the host can then attach with
+    // attach_shared() instead of holding their own copy. See shared.h for the lifetime of the shared storage.
+    Tensor<DataType> share(const std::string& name) const
+    {
+        if (is_empty())
+            throw std::invalid_argument("Cannot share an empty tensor");
+
+        size_t bytes = size() * sizeof(DataType);
+        auto* data = static_cast<DataType*>(shared_create(name, bytes, shared_type_tag<DataType>(), shape_vector()));
+        copy_to(data);
+        shared_publish(data);
+
+        Tensor<DataType> result(data, shape_vector());
+        result.release_ = shared_release;
+        result.storage_bytes_ = bytes;
+        return result;
     }
 
     [[nodiscard]] size_t size() const
@@ -130,17 +280,178 @@ public:
             if (shape_[i] != other.shape_[i])
                 return false;
 
+        if (is_contiguous() && other.is_contiguous())
+            return std::equal(data(), data() + size(), other.data());
+
         auto iter = get_iter_shape(shape_);
         ENUMERATE(iter, i, j, k, l)
         {
-            size_t flat_idx = multi_indices_to_flat({ i, j, k, l });
-            if (data_[flat_idx] != other.data_[flat_idx])
+            size_t idx = multi_indices_to_flat({ i, j, k, l }), other_idx = other.multi_indices_to_flat({ i, j, k, l });
+            if (data_[idx] != other.data_[other_idx])
                 return false;
         }
 
         return true;
     }
 
+    // Elementwise comparisons with broadcasting. The result is a mask of the broadcast shape, 1 where the comparison
+    // holds and 0 elsewhere.
+    Tensor<uint8_t> eq(const Tensor<DataType>& other) const { return compare(other, CompareOp::EQ); }
+    Tensor<uint8_t> ne(const Tensor<DataType>& other) const { return compare(other, CompareOp::NE); }
+    Tensor<uint8_t> lt(const Tensor<DataType>& other) const { return compare(other, CompareOp::LT); }
+    Tensor<uint8_t> le(const Tensor<DataType>& other) const { return compare(other, CompareOp::LE); }
+    Tensor<uint8_t> gt(const Tensor<DataType>& other) const { return compare(other, CompareOp::GT); }
+    Tensor<uint8_t> ge(const Tensor<DataType>& other) const { return compare(other, CompareOp::GE); }
+
+    Tensor<uint8_t> eq(DataType value) const { return compare(value, CompareOp::EQ); }
+    Tensor<uint8_t> ne(DataType value) const { return compare(value, CompareOp::NE); }
+    Tensor<uint8_t> lt(DataType value) const { return compare(value, CompareOp::LT); }
+    Tensor<uint8_t> le(DataType value) const { return compare(value, CompareOp::LE); }
+    Tensor<uint8_t> gt(DataType value) const { return compare(value, CompareOp::GT); }
+    Tensor<uint8_t> ge(DataType value) const { return compare(value, CompareOp::GE); }
+
+    // True when the shapes match and |a - b| <= atol + rtol * |b| for every element (NumPy's definition, so not
+    // symmetric in a and b). NaNs compare equal only with `equal_nan`.
+    bool allclose(const Tensor<DataType>& other, double rtol = 1e-5, double atol = 1e-8, bool equal_nan = false) const
+    {
+        if (n_dims_ != other.n_dims_ || shape_ != other.shape_)
+            return false;
+
+        auto a = contiguous();
+        auto b = other.contiguous();
+        if constexpr (std::is_same_v<DataType, float>) {
+            return allclose_f32(a.data(), b.data(), size(), (float)rtol, (float)atol, equal_nan);
+        } else {
+            const DataType* x = a.data();
+            const DataType* y = b.data();
+            for (size_t i = 0; i < size(); i++) {
+                double u = (double)x[i], v = (double)y[i];
+                if (std::isnan(u) || std::isnan(v)) {
+                    if (!(equal_nan && std::isnan(u) && std::isnan(v)))
+                        return false;
+                } else if (u != v && !(std::isfinite(v) && std::abs(u - v) <= atol + rtol * std::abs(v))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    // mask ? a : b elementwise. All three must have the same shape.
+    static Tensor<DataType> where(const Tensor<uint8_t>& mask, const Tensor<DataType>& a, const Tensor<DataType>& b)
+    {
+        if (mask.n_dims() != a.n_dims_ || mask.shape() != a.shape_ || a.n_dims_ != b.n_dims_ || a.shape_ != b.shape_)
+            throw std::invalid_argument("where() requires mask and operands of the same shape");
+
+        auto m = mask.contiguous();
+        auto x = a.contiguous();
+        auto y = b.contiguous();
+        size_t n = a.size();
+        auto* result_data = new DataType[n];
+        Tensor<DataType> result(result_data, a.shape_);
+
+        if constexpr (std::is_same_v<DataType, float>) {
+            where_f32(m.data(), x.data(), y.data(), result_data, n);
+        } else {
+            for (size_t i = 0; i < n; i++)
+                result_data[i] = m.data()[i] ? x.data()[i] : y.data()[i];
+        }
+        return result;
+    }
+
+    // Joins tensors along `axis`; all other dimensions must match. Each input adds one contiguous run of
+    // shape[axis] * inner elements to every row of the [outer, total, inner] output, and those runs are memcpy'd in
+    // parallel once they add up to enough work.
+    static Tensor<DataType> concat(const std::vector<Tensor<DataType>>& tensors, size_t axis = 0)
+    {
+        if (tensors.empty())
+            throw std::invalid_argument("concat() needs at least one tensor");
+
+        const Tensor<DataType>& first = tensors.front();
+        if (axis >= first.n_dims_)
+            throw std::invalid_argument("Axis out of bounds");
+
+        auto shape = first.shape_vector();
+        shape[axis] = 0;
+        for (const auto& t : tensors) {
+            for (size_t d = 0; d < first.n_dims_; d++)
+                if (t.n_dims_ != first.n_dims_ || (d != axis && t.shape_[d] != first.shape_[d]))
+                    throw std::invalid_argument("concat() tensors must match in every dimension but the axis");
+            shape[axis] += t.shape_[axis];
+        }
+
+        auto result = empty(shape);
+        auto [outer, inner] = result.outer_inner(axis);
+        size_t row = shape[axis] * inner;
+
+        // One job per (input, outer row), with long runs cut into pieces so that a handful of large inputs still
+        // spread over the threads.
+        struct Job {
+            const DataType* src;
+            DataType* dst;
+            size_t count;
+        };
+        std::vector<Tensor<DataType>> sources;
+        std::vector<Job> jobs;
+        sources.reserve(tensors.size());
+        size_t column = 0;
+        for (const auto& t : tensors) {
+            sources.push_back(t.contiguous());
+            size_t run = t.shape_[axis] * inner;
+            for (size_t o = 0; o < outer; o++)
+                for (size_t start = 0; start < run; start += CONCAT_PIECE)
+                    jobs.push_back({ sources.back().data() + o * run + start, result.data_ + o * row + column + start,
+                                     std::min(CONCAT_PIECE, run - start) });
+            column += run;
+        }
+
+#pragma omp parallel for num_threads(8) if (result.size() >= CONCAT_PARALLEL && jobs.size() > 1)
+        for (size_t j = 0; j < jobs.size(); j++)
+            std::memcpy(jobs[j].dst, jobs[j].src, jobs[j].count * sizeof(DataType));
+
+        return result;
+    }
+
+    // Joins tensors of the same shape along a new axis inserted at `axis`.
+    static Tensor<DataType> stack(const std::vector<Tensor<DataType>>& tensors, size_t axis = 0)
+    {
+        if (tensors.empty())
+            throw std::invalid_argument("stack() needs at least one tensor");
+
+        std::vector<Tensor<DataType>> expanded;
+        expanded.reserve(tensors.size());
+        for (const auto& t : tensors) {
+            if (t.n_dims_ != tensors.front().n_dims_ || t.shape_ != tensors.front().shape_)
+                throw std::invalid_argument("stack() tensors must all have the same shape");
+            expanded.push_back(t);
+            expanded.back().expand_dims(axis);
+        }
+        return concat(expanded, axis);
+    }
+
+    // The elements where `mask` (same shape) is set, in row-major order, as a 1D tensor.
+    Tensor<DataType> masked_select(const Tensor<uint8_t>& mask) const
+    {
+        if (mask.n_dims() != n_dims_ || mask.shape() != shape_)
+            throw std::invalid_argument("masked_select() requires a mask of the same shape");
+
+        auto m = mask.contiguous();
+        auto x = contiguous();
+        size_t n = size();
+        const uint8_t* bits = m.data();
+
+        auto* result_data = new DataType[count_mask(bits, n)];
+        size_t count = 0;
+        if constexpr (std::is_same_v<DataType, float>) {
+            count = masked_select_f32(x.data(), bits, n, result_data);
+        } else {
+            for (size_t i = 0; i < n; i++)
+                if (bits[i])
+                    result_data[count++] = x.data()[i];
+        }
+        return Tensor<DataType>(result_data, std::vector<size_t> { count });
+    }
+
     Tensor<DataType> operator[](const std::string& indices) const
     {
         auto parsed_indices = parse_indices(indices);
@@ -215,37 +526,66 @@ public:
         return sub_tensor;
     }
 
-    void init_strides()
+    void init_strides(MemoryOrder order = MemoryOrder::ROW_MAJOR)
     {
         std::fill(strides_.begin(), strides_.end(), 0);
         if (n_dims_ == 0)
             return;
 
+        if (order == MemoryOrder::COLUMN_MAJOR) {
+            strides_[0] = 1;
+            for (size_t i = 1; i < n_dims_; i++)
+                strides_[i] = strides_[i - 1] * shape_[i - 1];
+            return;
+        }
+
         strides_[n_dims_ - 1] = 1;
         for (int i = (int)n_dims_ - 2; i >= 0; i--)
             strides_[i] = strides_[i + 1] * shape_[i + 1];
     }
 
-    [[nodiscard]] std::string flat_string() const
+    // Every element in row-major order, each followed by ", ": "[0, 1, 2, ]". Not summarized unless `opts` asks for it.
+    [[nodiscard]] std::string flat_string(const FormatOptions& opts = { .threshold = SIZE_MAX }) const
     {
-        auto iter = get_iter_shape(shape_);
-        std::string str = "[";
+        auto view = format_view();
+        bool summarize = view.size > opts.threshold && view.size > 2 * opts.edge_items;
+        size_t printed = summarize ? 2 * opts.edge_items : view.size;
+        TextWriter out(printed * (Format::element_width<DataType>(opts.precision) + 2) + 8);
+        Format::write_flat(out, view, opts);
+        return out.take();
+    }
 
-        ENUMERATE(iter, i, j, k, l)
-        {
-            auto flat_idx = multi_indices_to_flat({ i, j, k, l });
-            str += std::to_string(data_[flat_idx]) + ", ";
-        }
+    void write_flat(std::ostream& os, const FormatOptions& opts = { .threshold = SIZE_MAX }) const
+    {
+        TextWriter out(os);
+        Format::write_flat(out, format_view(), opts);
+    }
 
-        str += "]";
-        return str;
+    // "Tensor([...], shape=[...])" with one line per innermost row. Tensors above opts.threshold elements are
+    // summarized NumPy-style.
+    [[nodiscard]] std::string to_string(const FormatOptions& opts = {}) const
+    {
+        auto view = format_view();
+        bool summarize = view.size > opts.threshold;
+        size_t printed = Format::printed_elements(view, summarize, opts.edge_items);
+        // Each row also carries a newline, its indentation and brackets.
+        size_t rows = n_dims_ > 1 ? printed / Format::shown(shape_[n_dims_ - 1], summarize, opts.edge_items) : 1;
+        TextWriter out(printed * (Format::element_width<DataType>(opts.precision) + 2) + rows * (2 * n_dims_ + 8) + 64);
+        write_tensor(out, view, summarize, opts);
+        return out.take();
     }
 
-    [[nodiscard]] std::string to_string() const
+    void write(std::ostream& os, const FormatOptions& opts = {}) const
     {
-        std::string res = "Tensor(";
-        res += to_string_rec() + ", shape=" + shape_to_string() + ")";
-        return res;
+        auto view = format_view();
+        TextWriter out(os);
+        write_tensor(out, view, view.size > opts.threshold, opts);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const Tensor<DataType>& tensor)
+    {
+        tensor.write(os);
+        return os;
     }
 
     Tensor<DataType> sum(size_t axis, bool keepdims) const
@@ -297,6 +637,69 @@ public:
         return result;
     }
 
+    // View whose axis d is axis `axes[d]` of this tensor. Nothing is copied; only shape and strides are reordered.
+    Tensor<DataType> permute(const std::vector<size_t>& axes) const
+    {
+        if (axes.size() != n_dims_)
+            throw std::invalid_argument("permute() needs one entry per dimension");
+
+        std::array<bool, MAX_DIM> used {};
+        Tensor<DataType> result(*this);
+        for (size_t d = 0; d < n_dims_; d++) {
+            if (axes[d] >= n_dims_ || used[axes[d]])
+                throw std::invalid_argument("permute() axes must be a permutation of the dimensions");
+            used[axes[d]] = true;
+            result.shape_[d] = shape_[axes[d]];
+            result.strides_[d] = strides_[axes[d]];
+        }
+        return result;
+    }
+
+    // Views of consecutive pieces along `axis` with the given lengths, which must add up to shape[axis].
+    [[nodiscard]] std::vector<Tensor<DataType>> split(const std::vector<size_t>& sizes, size_t axis = 0) const
+    {
+        if (axis >= n_dims_)
+            throw std::invalid_argument("Axis out of bounds");
+        if (std::accumulate(sizes.begin(), sizes.end(), (size_t)0) != shape_[axis])
+            throw std::invalid_argument("split() sizes must add up to the length of the axis");
+
+        std::vector<Tensor<DataType>> pieces;
+        pieces.reserve(sizes.size());
+        size_t start = 0;
+        for (size_t size : sizes) {
+            Tensor<DataType> piece(*this);
+            piece.shape_[axis] = size;
+            piece.offset_ += start * strides_[axis];
+            pieces.push_back(piece);
+            start += size;
+        }
+        return pieces;
+    }
+
+    // Views of `split_size` entries along `axis`; the last one is shorter if the length is not a multiple.
+    [[nodiscard]] std::vector<Tensor<DataType>> split(size_t split_size, size_t axis = 0) const
+    {
+        if (axis >= n_dims_)
+            throw std::invalid_argument("Axis out of bounds");
+        if (split_size == 0)
+            throw std::invalid_argument("split() size must be positive");
+
+        std::vector<size_t> sizes;
+        for (size_t start = 0; start < shape_[axis]; start += split_size)
+            sizes.push_back(std::min(split_size, shape_[axis] - start));
+        return split(sizes, axis);
+    }
+
+    // At most `n_chunks` views of equal length along `axis` (the last may be shorter), as in split(ceil(len / n)).
+    [[nodiscard]] std::vector<Tensor<DataType>> chunk(size_t n_chunks, size_t axis = 0) const
+    {
+        if (n_chunks == 0)
+            throw std::invalid_argument("chunk() needs at least one chunk");
+        if (axis >= n_dims_)
+            throw std::invalid_argument("Axis out of bounds");
+        return split(std::max((shape_[axis] + n_chunks - 1) / n_chunks, (size_t)1), axis);
+    }
+
     void expand_dims(size_t axis)
     {
         if (axis > n_dims_)
@@ -329,6 +732,98 @@ public:
         n_dims_--;
     }
 
+    // Returns a tensor of shape `new_shape` that shares storage with this tensor. Throws if the strides of this tensor
+    // cannot express the new shape without moving elements (e.g. flattening a transposed matrix).
+    Tensor<DataType> view(const std::vector<size_t>& new_shape) const
+    {
+        check_reshape(new_shape);
+
+        std::array<size_t, MAX_DIM> new_strides {};
+        if (!view_strides(new_shape, new_strides))
+            throw std::invalid_argument("View shape is not compatible with the tensor's strides, use reshape()");
+
+        Tensor<DataType> result(*this);
+        std::fill(result.shape_.begin(), result.shape_.end(), 0);
+        std::copy(new_shape.begin(), new_shape.end(), result.shape_.begin());
+        result.strides_ = new_strides;
+        result.n_dims_ = new_shape.size();
+
+        return result;
+    }
+
+    // Like view(), but falls back to a single contiguous copy when the strides do not allow a view. Use is_view() or
+    // shares_storage() on the result to tell which path was taken.
+    Tensor<DataType> reshape(const std::vector<size_t>& new_shape) const
+    {
+        check_reshape(new_shape);
+
+        std::array<size_t, MAX_DIM> new_strides {};
+        if (view_strides(new_shape, new_strides))
+            return view(new_shape);
+
+        LOG_INFO("reshape: copying tensor of shape " + shape_to_string() + ", strides do not allow a view");
+        auto result = copy();
+        std::fill(result.shape_.begin(), result.shape_.end(), 0);
+        std::copy(new_shape.begin(), new_shape.end(), result.shape_.begin());
+        result.n_dims_ = new_shape.size();
+        result.init_strides();
+
+        return result;
+    }
+
+    // Collapses the axes [start_axis, end_axis] into one, e.g. flatten(1) turns [B, H, W, C] into [B, H * W * C].
+    Tensor<DataType> flatten(size_t start_axis = 0, size_t end_axis = MAX_DIM - 1) const
+    {
+        if (n_dims_ == 0)
+            throw std::invalid_argument("Cannot flatten an empty tensor");
+
+        end_axis = std::min(end_axis, n_dims_ - 1);
+        if (start_axis > end_axis)
+            throw std::invalid_argument("Axis out of bounds");
+
+        std::vector<size_t> new_shape(shape_.begin(), shape_.begin() + start_axis);
+        new_shape.push_back(std::accumulate(
+            shape_.begin() + start_axis, shape_.begin() + end_axis + 1, (size_t)1, std::multiplies<>()));
+        new_shape.insert(new_shape.end(), shape_.begin() + end_axis + 1, shape_.begin() + n_dims_);
+
+        return reshape(new_shape);
+    }
+
+    [[nodiscard]] bool is_contiguous() const
+    {
+        size_t expected = 1;
+        for (int i = (int)n_dims_ - 1; i >= 0; i--) {
+            if (shape_[i] == 1)
+                continue;
+            if (strides_[i] != expected)
+                return false;
+            expected *= shape_[i];
+        }
+        return true;
+    }
+
+    // True if the elements are dense in memory in `order`. A tensor can be in both orders, e.g. a vector.
+    [[nodiscard]] bool has_order(MemoryOrder order) const
+    {
+        return order == MemoryOrder::ROW_MAJOR ? is_contiguous() : reversed_axes().is_contiguous();
+    }
+
+    // This tensor if it is already in `order`, otherwise a copy with the same shape whose storage is in that order.
+    Tensor<DataType> with_order(MemoryOrder order) const
+    {
+        if (has_order(order))
+            return *this;
+        return copy_in(order);
+    }
+
+    // True if this tensor borrows its storage from another tensor rather than owning it.
+    [[nodiscard]] bool is_view() const { return parent != nullptr; }
+
+    [[nodiscard]] bool shares_storage(const Tensor<DataType>& other) const
+    {
+        return data_ != nullptr && data_ == other.data_;
+    }
+
     template <typename D, typename S> static bool matmul_compat(const Tensor<D>& a, const Tensor<S>& b)
     {
         if (a.n_dims() == 2 && b.n_dims() == 2) {
@@ -336,6 +831,10 @@ public:
         } else if (a.n_dims() == 3 && b.n_dims() == 3) {
             return a.shape()[2] == b.shape()[1]
                 && (a.shape()[0] == b.shape()[0] || a.shape()[0] == 1 || b.shape()[0] == 1);
+        } else if (a.n_dims() == 2 && b.n_dims() == 1) {
+            return a.shape()[1] == b.shape()[0];
+        } else if (a.n_dims() == 1 && b.n_dims() == 2) {
+            return a.shape()[0] == b.shape()[0];
         }
 
         UNIMPLEMENTED("Matmul only implemented for tensors of the same number of dimensions");
@@ -362,6 +861,11 @@ public:
     requires CompatibleTypes<DataType, OtherDataType>
     auto operator+(const Tensor<OtherDataType>& other) -> Tensor<decltype(DataType() + OtherDataType())> const
     {
+        if constexpr (HalfType<DataType> && std::is_same_v<DataType, OtherDataType>) {
+            if (half_fast_path_compat(other))
+                return half_elementwise_op(other, [](__m256 a, __m256 b) { return _mm256_add_ps(a, b); });
+        }
+
         using ResultDataType = decltype(DataType() + OtherDataType());
         std::function<ResultDataType(DataType, OtherDataType)> op
             = [](DataType a, OtherDataType b) -> ResultDataType { return a + b; };
@@ -372,6 +876,11 @@ public:
     requires CompatibleTypes<DataType, OtherDataType>
     auto operator-(const Tensor<OtherDataType>& other) -> Tensor<decltype(DataType() - OtherDataType())> const
     {
+        if constexpr (HalfType<DataType> && std::is_same_v<DataType, OtherDataType>) {
+            if (half_fast_path_compat(other))
+                return half_elementwise_op(other, [](__m256 a, __m256 b) { return _mm256_sub_ps(a, b); });
+        }
+
         using ResultDataType = decltype(DataType() - OtherDataType());
         std::function<ResultDataType(DataType, OtherDataType)> op
             = [](DataType a, OtherDataType b) -> ResultDataType { return a - b; };
@@ -382,6 +891,11 @@ public:
     requires CompatibleTypes<DataType, OtherDataType>
     auto elementwise_mul(const Tensor<OtherDataType>& other) -> Tensor<decltype(DataType() * OtherDataType())> const
     {
+        if constexpr (HalfType<DataType> && std::is_same_v<DataType, OtherDataType>) {
+            if (half_fast_path_compat(other))
+                return half_elementwise_op(other, [](__m256 a, __m256 b) { return _mm256_mul_ps(a, b); });
+        }
+
         using ResultDataType = decltype(DataType() * OtherDataType());
         std::function<ResultDataType(DataType, OtherDataType)> op
             = [](DataType a, OtherDataType b) -> ResultDataType { return a * b; };
@@ -415,90 +929,626 @@ public:
         if (!matmul_compat(*this, other))
             throw std::invalid_argument("Incompatible shapes for matrix multiplication");
 
-        if (n_dims() == 2) {
-            auto otherT = other.transpose();
-            return matmul2d_transpose_other(otherT);
+        if (n_dims() == 2 && other.n_dims() == 1)
+            return matvec(other);
+        if (n_dims() == 1 && other.n_dims() == 2)
+            return vecmat(other);
+
+        if constexpr (HalfType<DataType> && std::is_same_v<DataType, OtherDataType>) {
+            return matmul_accumulate_f32<DataType>(other);
+        } else {
+            if (n_dims() == 2) {
+                if constexpr (std::is_same_v<DataType, float> && std::is_same_v<OtherDataType, float>)
+                    return matmul2d_sgemm(other);
+                auto otherT = other.transpose();
+                return matmul2d_transpose_other(otherT);
+            }
+            if (n_dims() == 3)
+                return matmul3d(other);
         }
-        if (n_dims() == 3)
-            return matmul3d(other);
 
         UNIMPLEMENTED("Matmul is not implemented for tensors with different number of dimensions");
     }
 
+    // Inner product of two 1D tensors of the same length.
     template <typename OtherDataType>
     requires CompatibleTypes<DataType, OtherDataType>
-    auto operator*(OtherDataType scalar) -> Tensor<decltype(DataType() * scalar)> const
+    auto dot(const Tensor<OtherDataType>& other) const -> decltype(DataType() * OtherDataType())
     {
-        std::function<decltype(DataType() * OtherDataType())(DataType)> op
-            = [scalar](DataType a) -> decltype(DataType() * scalar) { return a * scalar; };
-        return unary_op(op);
+        if (n_dims_ != 1 || other.n_dims_ != 1 || shape_[0] != other.shape_[0])
+            throw std::invalid_argument("dot expects two 1D tensors of the same length");
+
+        if constexpr (std::is_same_v<DataType, float> && std::is_same_v<OtherDataType, float>) {
+            return sdot(shape_[0], data(), strides_[0], other.data(), other.strides_[0]);
+        } else {
+            using ResultType = decltype(DataType() * OtherDataType());
+            using AccType = GemvAccType<ResultType>;
+            const DataType* x = data();
+            const OtherDataType* y = other.data();
+
+            AccType sum(0);
+            for (size_t i = 0; i < shape_[0]; i++)
+                sum += (AccType)x[i * strides_[0]] * (AccType)y[i * other.strides_[0]];
+            return ResultType(sum);
+        }
     }
 
+    // [M, N] matrix times [N] vector, giving a [M] vector.
     template <typename OtherDataType>
     requires CompatibleTypes<DataType, OtherDataType>
-    auto operator+(OtherDataType scalar) -> Tensor<decltype(DataType() * scalar)> const
+    auto matvec(const Tensor<OtherDataType>& vec) const -> Tensor<decltype(DataType() * OtherDataType())>
     {
-        std::function<decltype(DataType() * OtherDataType())(DataType)> op
-            = [scalar](DataType a) -> decltype(DataType() * scalar) { return a + scalar; };
-        return unary_op(op);
+        if (n_dims_ != 2 || vec.n_dims_ != 1 || shape_[1] != vec.shape_[0])
+            throw std::invalid_argument("Incompatible shapes for matrix-vector product");
+
+        size_t m = shape_[0], n = shape_[1];
+        using ResultType = decltype(DataType() * OtherDataType());
+        auto* result_data = new ResultType[m];
+        Tensor<ResultType> result(result_data, { m });
+        auto x = vec.contiguous();
+
+        if constexpr (std::is_same_v<DataType, float> && std::is_same_v<OtherDataType, float>) {
+            // Row-major and transposed matrices both get a unit-stride kernel; anything else is packed first.
+            if (strides_[1] == 1 || n == 1) {
+                sgemv(m, n, data(), strides_[0], x.data(), result_data);
+            } else if (strides_[0] == 1) {
+                sgemv_t(n, m, data(), strides_[1], x.data(), result_data);
+            } else {
+                auto a = contiguous();
+                sgemv(m, n, a.data(), n, x.data(), result_data);
+            }
+        } else {
+            using AccType = GemvAccType<ResultType>;
+            auto a = contiguous();
+            for (size_t i = 0; i < m; i++) {
+                AccType sum(0);
+                for (size_t j = 0; j < n; j++)
+                    sum += (AccType)a.data()[i * n + j] * (AccType)x.data()[j];
+                result_data[i] = ResultType(sum);
+            }
+        }
+
+        return result;
     }
 
-    Tensor<DataType> reciprocal() const
+    // [M] vector times [M, N] matrix, giving a [N] vector.
+    template <typename OtherDataType>
+    requires CompatibleTypes<DataType, OtherDataType>
+    auto vecmat(const Tensor<OtherDataType>& matrix) const -> Tensor<decltype(DataType() * OtherDataType())>
     {
-        std::function<DataType(DataType)> op = [](DataType a) -> DataType { return 1 / a; };
-        return unary_op(op);
+        if (n_dims_ != 1 || matrix.n_dims_ != 2 || shape_[0] != matrix.shape_[0])
+            throw std::invalid_argument("Incompatible shapes for vector-matrix product");
+
+        size_t m = matrix.shape_[0], n = matrix.shape_[1];
+        using ResultType = decltype(DataType() * OtherDataType());
+        auto* result_data = new ResultType[n];
+        Tensor<ResultType> result(result_data, { n });
+        auto x = contiguous();
+
+        if constexpr (std::is_same_v<DataType, float> && std::is_same_v<OtherDataType, float>) {
+            if (matrix.strides_[1] == 1 || n == 1) {
+                sgemv_t(m, n, matrix.data(), matrix.strides_[0], x.data(), result_data);
+            } else if (matrix.strides_[0] == 1) {
+                sgemv(n, m, matrix.data(), matrix.strides_[1], x.data(), result_data);
+            } else {
+                auto a = matrix.contiguous();
+                sgemv_t(m, n, a.data(), n, x.data(), result_data);
+            }
+        } else {
+            using AccType = GemvAccType<ResultType>;
+            auto a = matrix.contiguous();
+            std::vector<AccType> sums(n, AccType(0));
+            for (size_t i = 0; i < m; i++)
+                for (size_t j = 0; j < n; j++)
+                    sums[j] += (AccType)x.data()[i] * (AccType)a.data()[i * n + j];
+            for (size_t j = 0; j < n; j++)
+                result_data[j] = ResultType(sums[j]);
+        }
+
+        return result;
     }
 
-    Tensor<DataType> operator+() const
+    // Outer product of a [M] and a [N] vector, giving a [M, N] matrix.
+    template <typename OtherDataType>
+    requires CompatibleTypes<DataType, OtherDataType>
+    auto outer(const Tensor<OtherDataType>& other) const -> Tensor<decltype(DataType() * OtherDataType())>
     {
-        return copy(); // identity operation
+        if (n_dims_ != 1 || other.n_dims_ != 1)
+            throw std::invalid_argument("outer expects two 1D tensors");
+
+        size_t m = shape_[0], n = other.shape_[0];
+        using ResultType = decltype(DataType() * OtherDataType());
+        auto* result_data = new ResultType[m * n];
+        Tensor<ResultType> result(result_data, { m, n });
+        auto x = contiguous();
+        auto y = other.contiguous();
+
+#pragma omp parallel for num_threads(8) if (m * n > (1 << 16))
+        for (size_t i = 0; i < m; i++) {
+            DataType xi = x.data()[i];
+            for (size_t j = 0; j < n; j++)
+                result_data[i * n + j] = xi * y.data()[j];
+        }
+
+        return result;
     }
 
-    Tensor<DataType> operator-() const
+    // Inverse of a [N, N] matrix or of every matrix of a [B, N, N] batch, for N up to 8. Singular matrices give
+    // non-finite entries.
+    Tensor<DataType> inverse() const
+    requires std::is_same_v<DataType, float>
     {
-        std::function<DataType(DataType)> op = [](DataType a) -> DataType { return -a; };
-        return unary_op(op);
+        auto [batch, n] = small_matrix_batch("inverse()");
+        auto src = contiguous();
+        auto result = Tensor<DataType>::empty(shape_vector());
+        batched_inverse_f32(batch, n, src.data(), n * n, result.data());
+        return result;
     }
 
-    Tensor<DataType> exp() const
+    // Determinants of a [B, N, N] batch as a [B] tensor, or of a [N, N] matrix as a [1] tensor, for N up to 8.
+    Tensor<DataType> det() const
+    requires std::is_same_v<DataType, float>
     {
-        std::function<DataType(DataType)> op = [](DataType a) -> DataType { return std::exp(a); };
-        return unary_op(op);
+        auto [batch, n] = small_matrix_batch("det()");
+        auto src = contiguous();
+        auto result = Tensor<DataType>::empty({ batch });
+        batched_det_f32(batch, n, src.data(), n * n, result.data());
+        return result;
     }
 
-    [[nodiscard]] bool is_empty() const { return n_dims_ == 0; }
-
-    [[nodiscard]] std::array<size_t, MAX_DIM> shape() const { return shape_; }
-
-    [[nodiscard]] size_t n_dims() const { return n_dims_; }
-
-    ~Tensor()
+    // Applies [N, N] (or [B, N, N]) transforms to [B, N] vectors, or to [B, N - 1] points that are extended with
+    // w = 1 and divided by the resulting w, e.g. 3D points through 4x4 matrices. A single matrix or a single [N]
+    // vector is broadcast over the other operand's batch.
+    Tensor<DataType> transform(const Tensor<DataType>& vectors) const
+    requires std::is_same_v<DataType, float>
     {
-        if (parent == nullptr)
-            delete[] data_;
+        auto [m_batch, n] = small_matrix_batch("transform()");
+        if (vectors.n_dims() < 1 || vectors.n_dims() > 2)
+            throw std::invalid_argument("transform() expects [B, N] or [N] vectors");
+
+        size_t len = vectors.shape()[vectors.n_dims() - 1], v_batch = vectors.n_dims() == 2 ? vectors.shape()[0] : 1;
+        if (m_batch != v_batch && m_batch != 1 && v_batch != 1)
+            throw std::invalid_argument("transform() batch sizes do not match");
+
+        size_t batch = std::max(m_batch, v_batch);
+        auto m = contiguous();
+        auto v = vectors.contiguous();
+        auto result = Tensor<DataType>::empty({ batch, len });
+        batched_transform_f32(batch, n, m.data(), m_batch == 1 ? 0 : n * n, v.data(), v_batch == 1 ? 0 : len, len,
+                              result.data());
+        return result;
     }
 
-public:
-    static Tensor<DataType> ones(const std::vector<size_t>& shape) { return all_v(shape, 1); }
-
-    static Tensor<DataType> zeros(const std::vector<size_t>& shape) { return all_v(shape, 0); }
-
-    static Tensor<DataType> rand(const std::vector<size_t>& shape)
+    template <typename OtherDataType>
+    requires CompatibleTypes<DataType, OtherDataType>
+    auto operator*(OtherDataType scalar) -> Tensor<decltype(DataType() * scalar)> const
     {
-        size_t n_elems = std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<>());
-        auto* data = new DataType[n_elems];
-        for (size_t i = 0; i < n_elems; i++) {
-            data[i] = (DataType)std::rand() / RAND_MAX;
+        std::function<decltype(DataType() * OtherDataType())(DataType)> op
+            = [scalar](DataType a) -> decltype(DataType() * scalar) { return a * scalar; };
+        return unary_op(op);
+    }
+
+    template <typename OtherDataType>
+    requires CompatibleTypes<DataType, OtherDataType>
+    auto operator+(OtherDataType scalar) -> Tensor<decltype(DataType() * scalar)> const
+    {
+        std::function<decltype(DataType() * OtherDataType())(DataType)> op
+            = [scalar](DataType a) -> decltype(DataType() * scalar) { return a + scalar; };
+        return unary_op(op);
+    }
+
+    // Matrix product of half-precision tensors that reads the operands in their storage type, widens them in registers
+    // and accumulates in fp32. ResultType selects whether the product is kept in fp32 or rounded back to DataType.
+    template <typename ResultType = float>
+    requires HalfType<DataType> && (std::is_same_v<ResultType, float> || std::is_same_v<ResultType, DataType>)
+    Tensor<ResultType> matmul_accumulate_f32(const Tensor<DataType>& other) const
+    {
+        if (n_dims_ != other.n_dims_ || !matmul_compat(*this, other))
+            throw std::invalid_argument("Incompatible shapes for matrix multiplication");
+
+        auto a = contiguous(), b = other.contiguous();
+        bool batched = n_dims_ == 3;
+        size_t a_batch = batched ? shape_[0] : 1, b_batch = batched ? other.shape_[0] : 1;
+        size_t batch = std::max(a_batch, b_batch);
+        size_t m = shape_[n_dims_ - 2], k = shape_[n_dims_ - 1], n = other.shape_[other.n_dims_ - 1];
+
+        auto* result_data = new ResultType[batch * m * n];
+        Tensor<ResultType> result = batched ? Tensor<ResultType>(result_data, { batch, m, n })
+                                            : Tensor<ResultType>(result_data, { m, n });
+
+        for (size_t bt = 0; bt < batch; bt++) {
+            const DataType* a_mat = a.data_ + a.offset_ + std::min(bt, a_batch - 1) * m * k;
+            const DataType* b_mat = b.data_ + b.offset_ + std::min(bt, b_batch - 1) * k * n;
+            gemm_accumulate_f32(a_mat, b_mat, result_data + bt * m * n, m, k, n);
         }
-        return Tensor(data, shape);
+
+        return result;
+    }
+
+    Tensor<DataType> reciprocal() const
+    {
+        std::function<DataType(DataType)> op = [](DataType a) -> DataType { return 1 / a; };
+        return unary_op(op);
+    }
+
+    Tensor<DataType> operator+() const
+    {
+        return copy(); // identity operation
+    }
+
+    Tensor<DataType> operator-() const
+    {
+        std::function<DataType(DataType)> op = [](DataType a) -> DataType { return -a; };
+        return unary_op(op);
+    }
+
+    Tensor<DataType> exp() const
+    {
+        std::function<DataType(DataType)> op = [](DataType a) -> DataType { return std::exp(a); };
+        return unary_op(op);
+    }
+
+    // Entries `index` (1D) along `axis`, in index order; the result has index.size() entries there. Whole
+    // sub-tensors after `axis` are copied as contiguous rows.
+    template <std::integral I> Tensor<DataType> index_select(size_t axis, const Tensor<I>& index) const
+    {
+        if (axis >= n_dims_)
+            throw std::invalid_argument("Axis out of bounds");
+        if (index.n_dims() != 1)
+            throw std::invalid_argument("index_select() requires a 1D index");
+
+        auto [outer, inner] = outer_inner(axis);
+        size_t len = shape_[axis], n_index = index.size();
+        auto idx = checked_indices(index, len);
+        auto src = contiguous();
+        const DataType* x = src.data();
+
+        auto shape = shape_vector();
+        shape[axis] = n_index;
+        auto result = Tensor<DataType>::empty(shape);
+        DataType* out = result.data();
+
+        if constexpr (std::is_same_v<DataType, float>) {
+            if (inner == 1) {
+                gather_f32(x, outer, len, 1, broadcast_index_rows(idx, outer).data(), n_index, out);
+                return result;
+            }
+        }
+
+#pragma omp parallel for num_threads(8) collapse(2) if (outer * n_index * inner > (1 << 15))
+        for (size_t o = 0; o < outer; o++)
+            for (size_t i = 0; i < n_index; i++)
+                std::copy_n(x + (o * len + (size_t)idx[i]) * inner, inner, out + (o * n_index + i) * inner);
+        return result;
+    }
+
+    // Elements of the row-major flattened tensor at `index`, in the shape of `index`.
+    template <std::integral I> Tensor<DataType> take(const Tensor<I>& index) const
+    {
+        auto idx = checked_indices(index, size());
+        auto src = contiguous();
+        auto result = Tensor<DataType>::empty(index.shape_vector());
+        size_t n = idx.size();
+
+        if constexpr (std::is_same_v<DataType, float>) {
+            take_f32(src.data(), idx.data(), n, result.data());
+        } else {
+            const DataType* x = src.data();
+            DataType* out = result.data();
+#pragma omp parallel for num_threads(8) if (n > (1 << 15))
+            for (size_t i = 0; i < n; i++)
+                out[i] = x[idx[i]];
+        }
+        return result;
+    }
+
+    // result[..., j, ...] = this[..., index[..., j, ...], ...] along `axis`. The result has the shape of `index`,
+    // which must match this tensor in every other dimension.
+    template <std::integral I> Tensor<DataType> gather(size_t axis, const Tensor<I>& index) const
+    {
+        check_gather_shape(axis, index, "gather()");
+
+        auto [outer, inner] = outer_inner(axis);
+        size_t len = shape_[axis], n_index = index.shape()[axis];
+        auto idx = checked_indices(index, len);
+        auto src = contiguous();
+        const DataType* x = src.data();
+
+        auto result = Tensor<DataType>::empty(index.shape_vector());
+        DataType* out = result.data();
+
+        if constexpr (std::is_same_v<DataType, float>) {
+            gather_f32(x, outer, len, inner, idx.data(), n_index, out);
+        } else {
+#pragma omp parallel for num_threads(8) collapse(2) if (outer * n_index * inner > (1 << 15))
+            for (size_t o = 0; o < outer; o++) {
+                for (size_t j = 0; j < n_index; j++) {
+                    size_t row = (o * n_index + j) * inner;
+                    for (size_t k = 0; k < inner; k++)
+                        out[row + k] = x[(o * len + (size_t)idx[row + k]) * inner + k];
+                }
+            }
+        }
+        return result;
+    }
+
+    // Copy of this tensor with result[..., index[..., j, ...], ...] = src[..., j, ...] along `axis`. `src` has the
+    // shape of `index`, which must match this tensor in every other dimension. Where an index repeats along the
+    // axis, the write that comes last in index order wins.
+    template <std::integral I>
+    Tensor<DataType> scatter(size_t axis, const Tensor<I>& index, const Tensor<DataType>& src) const
+    {
+        return scatter_along(axis, index, src, false);
+    }
+
+    // As scatter(), but adds into the copy. Repeated indices accumulate in index order whatever the thread count, so
+    // the result is deterministic.
+    template <std::integral I>
+    Tensor<DataType> scatter_add(size_t axis, const Tensor<I>& index, const Tensor<DataType>& src) const
+    {
+        return scatter_along(axis, index, src, true);
+    }
+
+    // Values sorted along `axis`. NaNs sort after every number (first when descending) and ties keep their order.
+    Tensor<DataType> sort(size_t axis, bool descending = false) const
+    {
+        auto result = Tensor<DataType>::empty(shape_vector());
+        sort_lines(axis, descending, result.data(), nullptr);
+        return result;
+    }
+
+    // Indices that sort along `axis`, in the same order as sort().
+    Tensor<int64_t> argsort(size_t axis, bool descending = false) const
+    {
+        auto result = Tensor<int64_t>::empty(shape_vector());
+        sort_lines(axis, descending, nullptr, result.data());
+        return result;
+    }
+
+    // The k largest (or smallest) entries along `axis` and their indices, best first. Each line is scanned once
+    // against a k-entry heap; nothing is sorted beyond the k results.
+    std::pair<Tensor<DataType>, Tensor<int64_t>> topk(size_t k, size_t axis, bool largest = true) const
+    {
+        if (axis >= n_dims_)
+            throw std::invalid_argument("Axis out of bounds");
+        if (k == 0 || k > shape_[axis])
+            throw std::invalid_argument("topk() requires 0 < k <= the length of the axis");
+
+        auto shape = shape_vector();
+        shape[axis] = k;
+        auto values = Tensor<DataType>::empty(shape);
+        auto indices = Tensor<int64_t>::empty(shape);
+
+        size_t len = shape_[axis], n_lines = size() / len;
+        Sort::Before<DataType> before { largest };
+
+        // Few long lines are split internally instead of being spread over threads.
+        bool split_lines = n_lines < 8;
+
+#pragma omp parallel for num_threads(8) if (!split_lines && size() > (1 << 15))
+        for (size_t line = 0; line < n_lines; line++) {
+            auto best = Sort::top_k(data_ + line_start(line, axis), len, strides_[axis], k, before, split_lines);
+            size_t out = values.line_start(line, axis), out_stride = values.strides_[axis];
+            for (size_t i = 0; i < k; i++) {
+                values.data_[out + i * out_stride] = best[i].value;
+                indices.data_[out + i * out_stride] = best[i].index;
+            }
+        }
+        return { std::move(values), std::move(indices) };
+    }
+
+    // Running sum along `axis`: element i of each line becomes the sum of elements 0..i.
+    Tensor<DataType> cumsum(size_t axis) const { return scanned(axis, ScanOp::SUM); }
+
+    // Running product along `axis`.
+    Tensor<DataType> cumprod(size_t axis) const { return scanned(axis, ScanOp::PROD); }
+
+    // Running maximum (minimum) along `axis`. Once a line has seen a NaN, the rest of it is NaN. Only values are
+    // returned; use argsort or topk for positions.
+    Tensor<DataType> cummax(size_t axis) const { return scanned(axis, ScanOp::MAX); }
+    Tensor<DataType> cummin(size_t axis) const { return scanned(axis, ScanOp::MIN); }
+
+    // In-place forms of the scans above. They write through views into the storage they share.
+    Tensor& cumsum_inplace(size_t axis) { return scan_inplace(axis, ScanOp::SUM); }
+    Tensor& cumprod_inplace(size_t axis) { return scan_inplace(axis, ScanOp::PROD); }
+    Tensor& cummax_inplace(size_t axis) { return scan_inplace(axis, ScanOp::MAX); }
+    Tensor& cummin_inplace(size_t axis) { return scan_inplace(axis, ScanOp::MIN); }
+
+    // Softmax along `axis`, computed as exp(x - max) / sum(exp(x - max)) so that large inputs do not overflow. One
+    // fused kernel replaces the exp / sum / divide chain and allocates only the result. A line whose entries are all
+    // -inf is NaN throughout, for both softmax and log_softmax.
+    Tensor<DataType> softmax(size_t axis) const
+    requires FloatingType<DataType>
+    {
+        return softmax_along(axis, false);
+    }
+
+    // log(softmax(x)) computed directly as x - max - log(sum(exp(x - max))), which stays finite where softmax
+    // underflows to 0.
+    Tensor<DataType> log_softmax(size_t axis) const
+    requires FloatingType<DataType>
+    {
+        return softmax_along(axis, true);
+    }
+
+    // Normalizes every vector along the last dimension to zero mean and unit variance, then scales it by `gamma` and
+    // shifts it by `beta` (1D tensors of the last dimension's size).
+    Tensor<DataType> layer_norm(const Tensor<DataType>& gamma, const Tensor<DataType>& beta, float eps = 1e-5f) const
+    requires FloatingType<DataType>
+    {
+        return normalize_last_dim(&gamma, &beta, eps, false);
+    }
+
+    Tensor<DataType> layer_norm(float eps = 1e-5f) const
+    requires FloatingType<DataType>
+    {
+        return normalize_last_dim(nullptr, nullptr, eps, false);
+    }
+
+    // Divides every vector along the last dimension by its root mean square, then scales it by `gamma`.
+    Tensor<DataType> rms_norm(const Tensor<DataType>& gamma, float eps = 1e-6f) const
+    requires FloatingType<DataType>
+    {
+        return normalize_last_dim(&gamma, nullptr, eps, true);
+    }
+
+    Tensor<DataType> rms_norm(float eps = 1e-6f) const
+    requires FloatingType<DataType>
+    {
+        return normalize_last_dim(nullptr, nullptr, eps, true);
+    }
+
+    // Pointer to the first element of this tensor (after any slice offset). Only meaningful as a flat array when
+    // is_contiguous() holds.
+    DataType* data() { return data_ + offset_; }
+
+    const DataType* data() const { return data_ + offset_; }
+
+    [[nodiscard]] std::array<size_t, MAX_DIM> strides() const { return strides_; }
+
+    [[nodiscard]] bool is_empty() const { return n_dims_ == 0; }
+
+    [[nodiscard]] std::array<size_t, MAX_DIM> shape() const { return shape_; }
+
+    [[nodiscard]] size_t n_dims() const { return n_dims_; }
+
+    ~Tensor()
+    {
+        if (parent == nullptr)
+            release_storage();
+    }
+
+public:
+    static Tensor<DataType> ones(const std::vector<size_t>& shape) { return all_v(shape, DataType(1)); }
+
+    // Large zero tensors are mapped rather than filled: the pages are zeroed on first touch by the thread that
+    // touches them, which is also what places them on that thread's NUMA node.
+    static Tensor<DataType> zeros(const std::vector<size_t>& shape)
+    {
+        size_t bytes = n_elems_of(shape) * sizeof(DataType);
+        if (bytes < LAZY_ZERO_BYTES)
+            return all_v(shape, DataType(0));
+
+        Tensor<DataType> result(static_cast<DataType*>(map_zeroed(bytes)), shape);
+        result.release_ = unmap;
+        result.storage_bytes_ = bytes;
+        return result;
+    }
+
+    static Tensor<DataType> full(const std::vector<size_t>& shape, DataType value) { return all_v(shape, value); }
+
+    // Uninitialized storage, for outputs that are about to be overwritten. Nothing is written here, so the pages are
+    // placed by the kernel that fills them.
+    static Tensor<DataType> empty(const std::vector<size_t>& shape)
+    {
+        return Tensor(new DataType[n_elems_of(shape)], shape);
+    }
+
+    static Tensor<DataType> empty(const std::vector<size_t>& shape, MemoryOrder order)
+    {
+        return Tensor(new DataType[n_elems_of(shape)], shape, order);
+    }
+
+    // Row-major tensor backed by the raw elements of a file, paged in on demand, so it may be larger than memory (see
+    // stream.h for kernels that work through such tensors tile by tile). Without `writable`, changes stay private.
+    static Tensor<DataType> map_file(const std::string& path, const std::vector<size_t>& shape, bool writable = false)
+    {
+        size_t bytes = n_elems_of(shape) * sizeof(DataType);
+        Tensor<DataType> result(static_cast<DataType*>(Tensile::map_file(path, bytes, writable, false)), shape);
+        result.release_ = unmap;
+        result.storage_bytes_ = bytes;
+        return result;
+    }
+
+    // Creates (or truncates) the file at `path` to hold a zero tensor of `shape` and maps it writable.
+    static Tensor<DataType> create_file(const std::string& path, const std::vector<size_t>& shape)
+    {
+        size_t bytes = n_elems_of(shape) * sizeof(DataType);
+        Tensor<DataType> result(static_cast<DataType*>(Tensile::map_file(path, bytes, true, true)), shape);
+        result.release_ = unmap;
+        result.storage_bytes_ = bytes;
+        return result;
+    }
+
+    // Zero-copy view of the tensor another process published with share(). Unless `writable`, the elements are mapped
+    // read-only and writing to them faults.
+    static Tensor<DataType> attach_shared(const std::string& name, bool writable = false)
+    {
+        std::vector<size_t> shape;
+        size_t bytes = 0;
+        void* data = shared_attach(name, shared_type_tag<DataType>(), writable, shape, bytes);
+
+        Tensor<DataType> result(static_cast<DataType*>(data), shape);
+        result.release_ = shared_release;
+        result.storage_bytes_ = bytes;
+        return result;
+    }
+
+    // Uniform in [0, 1) from the process-wide generator (see random.h).
+    static Tensor<DataType> rand(const std::vector<size_t>& shape) { return rand(shape, default_generator()); }
+
+    static Tensor<DataType> rand(const std::vector<size_t>& shape, Philox4x32& gen)
+    {
+        return uniform(shape, 0.0, 1.0, gen);
+    }
+
+    static Tensor<DataType> uniform(const std::vector<size_t>& shape, double low, double high,
+                                    Philox4x32& gen = default_generator())
+    {
+        return random_fill(shape, [&](auto* data, size_t n) { gen.fill_uniform(data, n, low, high); });
+    }
+
+    // Standard normal, or N(mean, stddev^2).
+    static Tensor<DataType> randn(const std::vector<size_t>& shape, Philox4x32& gen = default_generator())
+    {
+        return randn(shape, 0.0, 1.0, gen);
+    }
+
+    static Tensor<DataType> randn(const std::vector<size_t>& shape, double mean, double stddev,
+                                  Philox4x32& gen = default_generator())
+    {
+        return random_fill(shape, [&](auto* data, size_t n) { gen.fill_normal(data, n, mean, stddev); });
     }
 
 private:
+    static size_t n_elems_of(const std::vector<size_t>& shape)
+    {
+        return std::accumulate(shape.begin(), shape.end(), size_t(1), std::multiplies<>());
+    }
+
     static Tensor<DataType> all_v(const std::vector<size_t>& shape, DataType value)
     {
-        size_t n_elems = std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<>());
+        size_t n_elems = n_elems_of(shape);
+        auto* data = new DataType[n_elems];
+        first_touch_fill(data, n_elems, value);
+        return Tensor(data, shape);
+    }
+
+    // Frees owned storage: delete[] unless a factory installed its own release hook.
+    void release_storage()
+    {
+        if (release_ && data_)
+            release_(data_, storage_bytes_);
+        else
+            delete[] data_;
+        data_ = nullptr;
+        release_ = nullptr;
+    }
+
+    // Float and double are filled in place; other types are drawn as floats and converted.
+    template <typename Fill>
+    static Tensor<DataType> random_fill(const std::vector<size_t>& shape, Fill fill)
+    {
+        size_t n_elems = n_elems_of(shape);
         auto* data = new DataType[n_elems];
-        std::fill(data, data + n_elems, value);
+        if constexpr (std::is_same_v<DataType, float> || std::is_same_v<DataType, double>) {
+            fill(data, n_elems);
+        } else {
+            std::vector<float> values(n_elems);
+            fill(values.data(), n_elems);
+            for (size_t i = 0; i < n_elems; i++)
+                data[i] = DataType(values[i]);
+        }
         return Tensor(data, shape);
     }
 
@@ -545,6 +1595,11 @@ private:
         auto* result_data = new ResultType[a * d];
         Tensor<ResultType> result(result_data, { a, d });
 
+        // The vector loads walk rows with unit stride, so strided operands (e.g. the transposed view of the right-hand
+        // side) are made contiguous first.
+        auto lhs = contiguous();
+        auto rhs = other.contiguous();
+
 #pragma omp parallel for num_threads(8)
         for (size_t i = 0; i < a; i++) {
             for (size_t j = 0; j < d; j++) {
@@ -552,8 +1607,8 @@ private:
                 size_t k = 0;
                 __m256 vec_sum = _mm256_setzero_ps();
                 for (; k + 7 < b; k += 8) {
-                    __m256 a_vec = _mm256_loadu_ps(address_of({ i, k }));
-                    __m256 b_vec = _mm256_loadu_ps(other.address_of({ j, k }));
+                    __m256 a_vec = _mm256_loadu_ps(lhs.address_of({ i, k }));
+                    __m256 b_vec = _mm256_loadu_ps(rhs.address_of({ j, k }));
                     vec_sum = _mm256_fmadd_ps(a_vec, b_vec, vec_sum);
                 }
 
@@ -564,7 +1619,7 @@ private:
                     sum += tmp[l];
 
                 for (; k < b; k++)
-                    sum += item_at({ i, k }) * other.item_at({ j, k });
+                    sum += lhs.item_at({ i, k }) * rhs.item_at({ j, k });
 
                 result.item_at({ i, j }) = sum;
             }
@@ -573,6 +1628,18 @@ private:
         return result;
     }
 
+    // Float products go through the blocked sgemm, whose blocking and thread count come from gemm_config() and so
+    // follow the tuning cache. It reads both operands through their strides, so views need no copy.
+    Tensor<float> matmul2d_sgemm(const Tensor<float>& other) const
+    requires std::is_same_v<DataType, float>
+    {
+        size_t m = shape_[0], k = shape_[1], n = other.shape_[1];
+        Tensor<float> result(new float[m * n], { m, n });
+        sgemm(m, n, k, { data(), strides_[0], strides_[1] }, { other.data(), other.strides_[0], other.strides_[1] },
+              result.data(), n, Epilogue {});
+        return result;
+    }
+
     template <typename OtherDataType>
     requires CompatibleTypes<DataType, OtherDataType>
     auto matmul3d(const Tensor<OtherDataType>& other) -> Tensor<decltype(DataType() * OtherDataType())> const
@@ -584,8 +1651,32 @@ private:
         size_t d = other.shape()[1], e = other.shape()[2];
 
         using ResultType = decltype(DataType() * OtherDataType());
-        auto* result_data = new ResultType[batch * d * e];
-        Tensor<ResultType> result(result_data, { batch, d, e });
+        auto* result_data = new ResultType[batch * a * e];
+        Tensor<ResultType> result(result_data, { batch, a, e });
+
+        if constexpr (std::is_same_v<DataType, float> && std::is_same_v<OtherDataType, float>) {
+            // Batches of small square float matrices go through the unrolled SIMD kernels.
+            if (a == b && b == d && d == e && a <= BATCHED_MAX_ORDER) {
+                auto lhs = contiguous();
+                auto rhs = other.contiguous();
+                batched_matmul_f32(batch, a, lhs.data(), shape()[0] == 1 ? 0 : a * a, rhs.data(),
+                                   other.shape()[0] == 1 ? 0 : a * a, result_data);
+                return result;
+            }
+
+            // Anything bigger than a few multiply-adds per product goes through sgemm, one batch entry at a time,
+            // with a broadcast operand repeated through a zero batch stride.
+            if (a * b * e > SGEMM_MIN_WORK) {
+                size_t a_stride = shape()[0] == 1 ? 0 : strides_[0];
+                size_t b_stride = other.shape()[0] == 1 ? 0 : other.strides_[0];
+                for (size_t bt = 0; bt < batch; bt++) {
+                    MatrixRef lhs { data() + bt * a_stride, strides_[1], strides_[2] };
+                    MatrixRef rhs { other.data() + bt * b_stride, other.strides_[1], other.strides_[2] };
+                    sgemm(a, e, b, lhs, rhs, result_data + bt * a * e, e, Epilogue {});
+                }
+                return result;
+            }
+        }
 
         for (size_t bt = 0; bt < batch; bt++) {
             for (size_t i = 0; i < a; i++) {
@@ -603,6 +1694,77 @@ private:
         return result;
     }
 
+    // C[m, n] = A[m, k] * B[k, n] over contiguous half-precision operands. Four rows of A are widened once into an fp32
+    // panel, then each eight-wide strip of B is widened in registers and reused across those four rows.
+    template <typename ResultType>
+    static void gemm_accumulate_f32(const DataType* a, const DataType* b, ResultType* c, size_t m, size_t k, size_t n)
+    {
+        constexpr size_t ROWS = 4;
+
+#pragma omp parallel for num_threads(8)
+        for (size_t i0 = 0; i0 < m; i0 += ROWS) {
+            size_t rows = std::min(ROWS, m - i0);
+            std::vector<float> a_panel(ROWS * k, 0.0f);
+            for (size_t r = 0; r < rows; r++)
+                convert(a + (i0 + r) * k, a_panel.data() + r * k, k);
+
+            size_t j = 0;
+            for (; j + 7 < n; j += 8) {
+                __m256 acc[ROWS] = { _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps(),
+                                     _mm256_setzero_ps() };
+                for (size_t p = 0; p < k; p++) {
+                    __m256 b_vec = cvt_load_ps(b + p * n + j);
+                    for (size_t r = 0; r < ROWS; r++)
+                        acc[r] = _mm256_fmadd_ps(_mm256_set1_ps(a_panel[r * k + p]), b_vec, acc[r]);
+                }
+                for (size_t r = 0; r < rows; r++)
+                    cvt_store_ps(c + (i0 + r) * n + j, acc[r]);
+            }
+
+            for (; j < n; j++) {
+                for (size_t r = 0; r < rows; r++) {
+                    float sum = 0;
+                    for (size_t p = 0; p < k; p++)
+                        sum += a_panel[r * k + p] * (float)b[p * n + j];
+                    c[(i0 + r) * n + j] = ResultType(sum);
+                }
+            }
+        }
+    }
+
+private:
+    [[nodiscard]] bool half_fast_path_compat(const Tensor<DataType>& other) const
+    {
+        return n_dims_ == other.n_dims_ && shape_ == other.shape_ && is_contiguous() && other.is_contiguous();
+    }
+
+    // Elementwise op over two contiguous half-precision tensors of the same shape. Operands are widened to fp32 in
+    // registers and the result is narrowed on store, so no fp32 copy of either tensor is materialized.
+    template <typename VecOp> Tensor<DataType> half_elementwise_op(const Tensor<DataType>& other, VecOp op) const
+    {
+        size_t n = size();
+        auto* result_data = new DataType[n];
+        Tensor<DataType> result(result_data, { shape_.begin(), shape_.begin() + n_dims_ });
+
+        const DataType* a = data_ + offset_;
+        const DataType* b = other.data_ + other.offset_;
+        size_t n_vec = n / 8 * 8;
+
+#pragma omp parallel for num_threads(8) if (n_vec > (1 << 16))
+        for (size_t i = 0; i < n_vec; i += 8)
+            cvt_store_ps(result_data + i, op(cvt_load_ps(a + i), cvt_load_ps(b + i)));
+
+        if (n_vec < n) {
+            alignas(32) DataType a_tail[8] {}, b_tail[8] {}, out_tail[8];
+            std::copy(a + n_vec, a + n, a_tail);
+            std::copy(b + n_vec, b + n, b_tail);
+            cvt_store_ps(out_tail, op(cvt_load_ps(a_tail), cvt_load_ps(b_tail)));
+            std::copy(out_tail, out_tail + (n - n_vec), result_data + n_vec);
+        }
+
+        return result;
+    }
+
 private:
     template <typename OtherDataType>
     requires CompatibleTypes<DataType, OtherDataType>
@@ -613,11 +1775,23 @@ private:
         if (!shape_compat(*this, other))
             throw std::invalid_argument("Incompatible shapes for element-wise operation");
 
+        using ResultType = decltype(DataType() + OtherDataType());
+
+        // Operands that are both column-major are combined in storage order, and the result keeps their order.
+        if (n_dims_ == other.n_dims_ && shape_ == other.shape_ && !is_contiguous()
+            && has_order(MemoryOrder::COLUMN_MAJOR) && other.has_order(MemoryOrder::COLUMN_MAJOR)) {
+            auto result = Tensor<ResultType>::empty(shape_vector(), MemoryOrder::COLUMN_MAJOR);
+            const DataType* a = data();
+            const OtherDataType* b = other.data();
+            for (size_t i = 0; i < size(); i++)
+                result.data_[i] = op(a[i], b[i]);
+            return result;
+        }
+
         auto shape = get_broadcasted_shape(other.shape());
         auto result_n_dims = get_n_dims_from_shape(shape);
         auto iter = get_iter_shape(shape);
 
-        using ResultType = decltype(DataType() + OtherDataType());
         auto flat_size = std::accumulate(shape.begin(), shape.begin() + result_n_dims, 1, std::multiplies<>());
         auto* result_data = new ResultType[flat_size];
 
@@ -633,14 +1807,399 @@ private:
         return result;
     }
 
-    auto unary_op(std::function<DataType(DataType)> op) -> Tensor<DataType> const
+    static bool compare_values(DataType a, DataType b, CompareOp op)
+    {
+        switch (op) {
+        case CompareOp::EQ:
+            return a == b;
+        case CompareOp::NE:
+            return a != b;
+        case CompareOp::LT:
+            return a < b;
+        case CompareOp::LE:
+            return a <= b;
+        case CompareOp::GT:
+            return a > b;
+        case CompareOp::GE:
+            return a >= b;
+        }
+        return false;
+    }
+
+    Tensor<uint8_t> compare(const Tensor<DataType>& other, CompareOp op) const
     {
-        auto new_tensor = copy();
+        if constexpr (std::is_same_v<DataType, float>) {
+            if (n_dims_ == other.n_dims_ && shape_ == other.shape_) {
+                auto a = contiguous();
+                auto b = other.contiguous();
+                auto* result_data = new uint8_t[size()];
+                Tensor<uint8_t> result(result_data, shape_);
+                compare_f32(a.data(), b.data(), result_data, size(), op);
+                return result;
+            }
+        }
+
+        if (!shape_compat(*this, other))
+            throw std::invalid_argument("Incompatible shapes for comparison");
+
+        auto shape = get_broadcasted_shape(other.shape());
+        auto iter = get_iter_shape(shape);
+        auto flat_size = std::accumulate(shape.begin(), shape.begin() + get_n_dims_from_shape(shape), (size_t)1,
+                                         std::multiplies<>());
+        auto* result_data = new uint8_t[flat_size];
+        Tensor<uint8_t> result(result_data, shape);
+
+        ENUMERATE(iter, i, j, k, l)
+        {
+            size_t aidx = broadcasted_flat_index({ i, j, k, l });
+            size_t bidx = other.broadcasted_flat_index({ i, j, k, l });
+            size_t flat_idx = result.multi_indices_to_flat({ i, j, k, l });
+            result_data[flat_idx] = compare_values(data_[aidx], other.data_[bidx], op);
+        }
+        return result;
+    }
+
+    Tensor<uint8_t> compare(DataType value, CompareOp op) const
+    {
+        auto a = contiguous();
+        size_t n = size();
+        auto* result_data = new uint8_t[n];
+        Tensor<uint8_t> result(result_data, shape_);
+
+        if constexpr (std::is_same_v<DataType, float>) {
+            compare_scalar_f32(a.data(), value, result_data, n, op);
+        } else {
+            for (size_t i = 0; i < n; i++)
+                result_data[i] = compare_values(a.data()[i], value, op);
+        }
+        return result;
+    }
+
+    auto unary_op(std::function<DataType(DataType)> op) const -> Tensor<DataType>
+    {
+        // Column-major tensors stay column-major; anything else comes out row-major.
+        bool column_major = !is_contiguous() && has_order(MemoryOrder::COLUMN_MAJOR);
+        auto new_tensor = copy_in(column_major ? MemoryOrder::COLUMN_MAJOR : MemoryOrder::ROW_MAJOR);
         for (size_t i = 0; i < new_tensor.size(); i++)
             new_tensor.data_[i] = op(new_tensor.data_[i]);
         return new_tensor;
     }
 
+private:
+    [[nodiscard]] std::vector<size_t> shape_vector() const { return { shape_.begin(), shape_.begin() + n_dims_ }; }
+
+    // View with the axes in reverse order, which is row-major exactly when this tensor is column-major.
+    [[nodiscard]] Tensor<DataType> reversed_axes() const
+    {
+        std::vector<size_t> axes(n_dims_);
+        std::iota(axes.rbegin(), axes.rend(), (size_t)0);
+        return permute(axes);
+    }
+
+    // Copy whose storage is in `order`.
+    Tensor<DataType> copy_in(MemoryOrder order) const
+    {
+        if (order == MemoryOrder::ROW_MAJOR)
+            return copy();
+
+        auto result = empty(shape_vector(), order);
+        reversed_axes().copy_to(result.data_);
+        return result;
+    }
+
+    // Element counts before and after `axis`, viewing the contiguous tensor as [outer, shape[axis], inner].
+    [[nodiscard]] std::pair<size_t, size_t> outer_inner(size_t axis) const
+    {
+        size_t outer = std::accumulate(shape_.begin(), shape_.begin() + axis, (size_t)1, std::multiplies<>());
+        size_t inner
+            = std::accumulate(shape_.begin() + axis + 1, shape_.begin() + n_dims_, (size_t)1, std::multiplies<>());
+        return { outer, inner };
+    }
+
+    // Row-major copy of `index` as 32-bit offsets, each checked against [0, bound).
+    template <std::integral I> static std::vector<int32_t> checked_indices(const Tensor<I>& index, size_t bound)
+    {
+        if (bound > (size_t)INT32_MAX)
+            throw std::invalid_argument("Indexed dimension too large for 32-bit indices");
+
+        auto src = index.contiguous();
+        const I* values = src.data();
+        std::vector<int32_t> idx(index.size());
+        bool in_range = true;
+        for (size_t i = 0; i < idx.size(); i++) {
+            in_range &= values[i] >= 0 && (size_t)values[i] < bound;
+            idx[i] = (int32_t)values[i];
+        }
+        if (!in_range)
+            throw std::out_of_range("Index out of bounds");
+        return idx;
+    }
+
+    // `idx` repeated `outer` times, the index rows of a gather with the same selection for every outer position.
+    static std::vector<int32_t> broadcast_index_rows(const std::vector<int32_t>& idx, size_t outer)
+    {
+        std::vector<int32_t> rows(idx.size() * outer);
+        for (size_t o = 0; o < outer; o++)
+            std::copy(idx.begin(), idx.end(), rows.begin() + o * idx.size());
+        return rows;
+    }
+
+    template <std::integral I> void check_gather_shape(size_t axis, const Tensor<I>& index, const char* op) const
+    {
+        if (axis >= n_dims_)
+            throw std::invalid_argument("Axis out of bounds");
+        if (index.n_dims() != n_dims_)
+            throw std::invalid_argument(std::string(op) + " requires an index with as many dimensions as the tensor");
+        for (size_t d = 0; d < n_dims_; d++)
+            if (d != axis && index.shape()[d] != shape_[d])
+                throw std::invalid_argument(std::string(op) + " index must match the tensor outside the axis");
+    }
+
+    // Work is split over (outer position, block of inner positions). Each task owns a disjoint set of output columns
+    // and visits its indices in order, so repeated indices resolve the same way as on one thread.
+    template <std::integral I>
+    Tensor<DataType> scatter_along(size_t axis, const Tensor<I>& index, const Tensor<DataType>& src, bool add) const
+    {
+        check_gather_shape(axis, index, add ? "scatter_add()" : "scatter()");
+        if (src.n_dims() != index.n_dims() || src.shape() != index.shape())
+            throw std::invalid_argument("scatter source must have the shape of the index");
+
+        auto [outer, inner] = outer_inner(axis);
+        size_t len = shape_[axis], n_index = index.shape()[axis];
+        auto idx = checked_indices(index, len);
+        auto values = src.contiguous();
+        const DataType* v = values.data();
+
+        auto result = copy();
+        DataType* out = result.data();
+
+        constexpr size_t INNER_BLOCK = 64;
+        size_t n_blocks = (inner + INNER_BLOCK - 1) / INNER_BLOCK;
+
+#pragma omp parallel for num_threads(8) collapse(2) if (outer * n_index * inner > (1 << 15))
+        for (size_t o = 0; o < outer; o++) {
+            for (size_t b = 0; b < n_blocks; b++) {
+                size_t k0 = b * INNER_BLOCK, k1 = std::min(inner, k0 + INNER_BLOCK);
+                for (size_t j = 0; j < n_index; j++) {
+                    size_t row = (o * n_index + j) * inner;
+                    for (size_t k = k0; k < k1; k++) {
+                        DataType& dst = out[(o * len + (size_t)idx[row + k]) * inner + k];
+                        dst = add ? DataType(dst + v[row + k]) : v[row + k];
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+private:
+    // Batch size and order of a [N, N] matrix or [B, N, N] batch accepted by the batched small-matrix kernels.
+    [[nodiscard]] std::pair<size_t, size_t> small_matrix_batch(const char* op) const
+    {
+        if (n_dims_ < 2 || n_dims_ > 3 || shape_[n_dims_ - 1] != shape_[n_dims_ - 2])
+            throw std::invalid_argument(std::string(op) + " expects a [N, N] matrix or a [B, N, N] batch");
+        size_t n = shape_[n_dims_ - 1];
+        if (n > BATCHED_MAX_ORDER)
+            throw std::invalid_argument(std::string(op) + " supports matrices up to 8x8");
+        return { n_dims_ == 3 ? shape_[0] : 1, n };
+    }
+
+private:
+    // Offset from data_ of the first element of the `line`-th line along `axis`, lines being numbered in row-major
+    // order of the other dimensions. Walking the line then uses strides_[axis], so no axis has to be moved last.
+    [[nodiscard]] size_t line_start(size_t line, size_t axis) const
+    {
+        size_t offset = offset_;
+        for (size_t d = n_dims_; d-- > 0;) {
+            if (d == axis)
+                continue;
+            offset += (line % shape_[d]) * strides_[d];
+            line /= shape_[d];
+        }
+        return offset;
+    }
+
+    // Sorts every line along `axis`, writing values and/or indices (either may be null) into contiguous outputs of
+    // this tensor's shape. Many lines are spread over threads; a few long ones use the parallel merge sort instead.
+    void sort_lines(size_t axis, bool descending, DataType* values, int64_t* indices) const
+    {
+        if (axis >= n_dims_)
+            throw std::invalid_argument("Axis out of bounds");
+
+        size_t len = shape_[axis], n_lines = size() / len, stride = strides_[axis];
+        size_t inner = outer_inner(axis).second;
+        Sort::Before<DataType> before { descending };
+        bool split_lines = n_lines < 8;
+
+#pragma omp parallel for num_threads(8) if (!split_lines && size() > (1 << 15))
+        for (size_t line = 0; line < n_lines; line++) {
+            const DataType* src = data_ + line_start(line, axis);
+            std::vector<Sort::Entry<DataType>> entries(len);
+            for (size_t i = 0; i < len; i++)
+                entries[i] = { src[i * stride], (int64_t)i };
+
+            if (split_lines)
+                Sort::parallel_sort(entries.data(), len, before);
+            else
+                std::sort(entries.begin(), entries.end(), before);
+
+            // The outputs are contiguous: line (o, k) starts at o * len * inner + k and steps by inner.
+            size_t out = (line / inner) * len * inner + line % inner;
+            for (size_t i = 0; i < len; i++) {
+                if (values)
+                    values[out + i * inner] = entries[i].value;
+                if (indices)
+                    indices[out + i * inner] = entries[i].index;
+            }
+        }
+    }
+
+    Tensor<DataType> scanned(size_t axis, ScanOp op) const
+    {
+        if (axis >= n_dims_)
+            throw std::invalid_argument("Axis out of bounds");
+        auto result = copy();
+        result.scan_inplace(axis, op);
+        return result;
+    }
+
+    // Contiguous float tensors go through scan_f32; everything else walks each line with strides_[axis], so strided
+    // views are scanned where they are.
+    Tensor& scan_inplace(size_t axis, ScanOp op)
+    {
+        if (axis >= n_dims_)
+            throw std::invalid_argument("Axis out of bounds");
+
+        size_t len = shape_[axis], n_lines = size() / len, stride = strides_[axis];
+        if constexpr (std::is_same_v<DataType, float>) {
+            if (is_contiguous()) {
+                auto [outer, inner] = outer_inner(axis);
+                scan_f32(data(), outer, len, inner, op);
+                return *this;
+            }
+        }
+
+        using K = Sort::Key<DataType>;
+        auto combine = [op](DataType a, DataType b) -> DataType {
+            switch (op) {
+            case ScanOp::SUM:
+                return DataType(a + b);
+            case ScanOp::PROD:
+                return DataType(a * b);
+            case ScanOp::MAX:
+                return Sort::is_nan(a) || !((K)b > (K)a || Sort::is_nan(b)) ? a : b;
+            case ScanOp::MIN:
+                return Sort::is_nan(a) || !((K)b < (K)a || Sort::is_nan(b)) ? a : b;
+            }
+            return b;
+        };
+
+#pragma omp parallel for num_threads(8) if (n_lines >= 8 && size() > (1 << 15))
+        for (size_t line = 0; line < n_lines; line++) {
+            DataType* p = data_ + line_start(line, axis);
+            for (size_t i = 1; i < len; i++)
+                p[i * stride] = combine(p[(i - 1) * stride], p[i * stride]);
+        }
+        return *this;
+    }
+
+private:
+    // Accumulator of the generic dot/matvec/vecmat loops. Half types are summed in fp32, as their GEMM does: a half
+    // accumulator stops growing once its spacing exceeds the addends (at 2048 for a float16 sum of ones).
+    template <typename R> using GemvAccType = std::conditional_t<HalfType<R>, float, R>;
+
+    // Types without a dedicated kernel (double, float16, bfloat16) are normalized in this precision.
+    using NormAccType = std::conditional_t<std::is_same_v<DataType, double>, double, float>;
+
+    Tensor<DataType> softmax_along(size_t axis, bool log) const
+    {
+        if (axis >= n_dims_)
+            throw std::invalid_argument("Axis out of bounds");
+
+        // Lines along `axis` are `inner` elements apart in the contiguous [outer, len, inner] layout.
+        size_t len = shape_[axis];
+        size_t outer = std::accumulate(shape_.begin(), shape_.begin() + axis, (size_t)1, std::multiplies<>());
+        size_t inner
+            = std::accumulate(shape_.begin() + axis + 1, shape_.begin() + n_dims_, (size_t)1, std::multiplies<>());
+
+        auto src = contiguous();
+        auto* result_data = new DataType[size()];
+        Tensor<DataType> result(result_data, shape_);
+
+        if constexpr (std::is_same_v<DataType, float>) {
+            softmax_f32(src.data(), result_data, outer, len, inner, log);
+        } else {
+            const DataType* x = src.data();
+            for (size_t o = 0; o < outer; o++) {
+                for (size_t j = 0; j < inner; j++) {
+                    size_t base = o * len * inner + j;
+                    NormAccType max = -std::numeric_limits<NormAccType>::infinity(), sum = 0;
+                    for (size_t k = 0; k < len; k++)
+                        max = std::max(max, (NormAccType)x[base + k * inner]);
+                    for (size_t k = 0; k < len; k++)
+                        sum += std::exp((NormAccType)x[base + k * inner] - max);
+
+                    for (size_t k = 0; k < len; k++) {
+                        NormAccType v = (NormAccType)x[base + k * inner] - max;
+                        result_data[base + k * inner] = DataType(log ? v - std::log(sum) : std::exp(v) / sum);
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    Tensor<DataType> normalize_last_dim(const Tensor<DataType>* gamma, const Tensor<DataType>* beta, float eps,
+                                        bool rms) const
+    {
+        if (n_dims_ == 0)
+            throw std::invalid_argument("Cannot normalize a tensor without dimensions");
+
+        size_t len = shape_[n_dims_ - 1], rows = len ? size() / len : 0;
+        for (const auto* param : { gamma, beta }) {
+            if (param && (param->n_dims_ != 1 || param->shape_[0] != len))
+                throw std::invalid_argument("Normalization parameters must be 1D and match the last dimension");
+        }
+
+        auto src = contiguous();
+        auto g = gamma ? gamma->contiguous() : Tensor<DataType>();
+        auto b = beta ? beta->contiguous() : Tensor<DataType>();
+        auto* result_data = new DataType[size()];
+        Tensor<DataType> result(result_data, shape_);
+
+        if constexpr (std::is_same_v<DataType, float>) {
+            if (rms)
+                rms_norm_f32(src.data(), result_data, rows, len, gamma ? g.data() : nullptr, eps);
+            else
+                layer_norm_f32(src.data(), result_data, rows, len, gamma ? g.data() : nullptr,
+                               beta ? b.data() : nullptr, eps);
+        } else {
+            const DataType* x = src.data();
+            for (size_t r = 0; r < rows; r++) {
+                const DataType* row = x + r * len;
+                NormAccType mean = 0, sq = 0;
+                for (size_t i = 0; i < len; i++)
+                    mean += (NormAccType)row[i];
+                mean = rms ? 0 : mean / (NormAccType)len;
+                for (size_t i = 0; i < len; i++)
+                    sq += ((NormAccType)row[i] - mean) * ((NormAccType)row[i] - mean);
+                NormAccType scale = 1 / std::sqrt(sq / (NormAccType)len + (NormAccType)eps);
+
+                for (size_t i = 0; i < len; i++) {
+                    NormAccType v = ((NormAccType)row[i] - mean) * scale;
+                    if (gamma)
+                        v *= (NormAccType)g.data()[i];
+                    if (beta)
+                        v += (NormAccType)b.data()[i];
+                    result_data[r * len + i] = DataType(v);
+                }
+            }
+        }
+
+        return result;
+    }
+
 private:
     template <typename Iterable> static size_t get_n_dims_from_shape(const Iterable& shape)
     {
@@ -672,6 +2231,61 @@ private:
         return shape;
     }
 
+    void check_reshape(const std::vector<size_t>& new_shape) const
+    {
+        if (new_shape.empty() || new_shape.size() > MAX_DIM)
+            throw std::invalid_argument("Reshape target must have between 1 and 4 dimensions");
+        if (std::find(new_shape.begin(), new_shape.end(), 0) != new_shape.end())
+            throw std::invalid_argument("Reshape target cannot have zero-sized dimensions");
+
+        size_t new_size = std::accumulate(new_shape.begin(), new_shape.end(), (size_t)1, std::multiplies<>());
+        if (new_size != size())
+            throw std::invalid_argument("Cannot reshape tensor of shape " + shape_to_string() + " to "
+                                        + std::to_string(new_size) + " elements");
+    }
+
+    // Computes strides that address the elements of this tensor in row-major order under `new_shape`. Every run of
+    // old axes that merges into (or splits from) a run of new axes must itself be contiguous for this to succeed.
+    bool view_strides(const std::vector<size_t>& new_shape, std::array<size_t, MAX_DIM>& new_strides) const
+    {
+        std::array<size_t, MAX_DIM> old_shape {}, old_strides {};
+        size_t old_n = 0;
+        for (size_t i = 0; i < n_dims_; i++) {
+            if (shape_[i] == 1)
+                continue;
+            old_shape[old_n] = shape_[i];
+            old_strides[old_n++] = strides_[i];
+        }
+
+        size_t new_n = new_shape.size();
+        size_t oi = 0, oj = 1, ni = 0, nj = 1;
+        while (ni < new_n && oi < old_n) {
+            size_t np = new_shape[ni], op = old_shape[oi];
+            while (np != op) {
+                if (np < op)
+                    np *= new_shape[nj++];
+                else
+                    op *= old_shape[oj++];
+            }
+
+            for (size_t ok = oi; ok + 1 < oj; ok++)
+                if (old_strides[ok] != old_shape[ok + 1] * old_strides[ok + 1])
+                    return false;
+
+            new_strides[nj - 1] = old_strides[oj - 1];
+            for (size_t nk = nj - 1; nk > ni; nk--)
+                new_strides[nk - 1] = new_strides[nk] * new_shape[nk];
+
+            ni = nj++;
+            oi = oj++;
+        }
+
+        for (; ni < new_n; ni++)
+            new_strides[ni] = 1;
+
+        return true;
+    }
+
     [[nodiscard]] size_t multi_indices_to_flat(const std::vector<size_t>& indices) const
     {
         size_t flat_idx = 0;
@@ -695,29 +2309,26 @@ private:
         return multi_indices_to_flat(new_indices);
     }
 
-    [[nodiscard]] std::string to_string_rec(std::vector<size_t> dims = {}) const
+private:
+    [[nodiscard]] Format::View<DataType> format_view() const
     {
-        if (n_dims_ == 0)
-            return "[]";
-
-        if (dims.size() == n_dims_)
-            return "";
+        return { data_ + offset_, shape_, strides_, n_dims_, n_dims_ == 0 ? 0 : size() };
+    }
 
-        std::string res = "[";
-        for (size_t i = 0; i < shape_[dims.size()]; i++) {
-            dims.push_back(i);
-            auto delim = (i < shape_[dims.size() - 1] - 1) ? ", " : "";
-            if (dims.size() == n_dims_) {
-                res += std::to_string(data_[multi_indices_to_flat(dims)]) + delim;
-            } else {
-                res += "\n" + std::string(dims.size() * 2, ' ') + to_string_rec(dims) + delim;
-            }
-            dims.pop_back();
-        }
-        res += (dims.size() == n_dims_ - 1 ? "]" : "\n" + std::string(dims.size() * 2, ' ') + "]");
-        return res;
+    void write_tensor(TextWriter& out, const Format::View<DataType>& view, bool summarize,
+                      const FormatOptions& opts) const
+    {
+        out.put("Tensor(");
+        if (n_dims_ == 0)
+            out.put("[]");
+        else
+            Format::write_nested(out, view, 0, view.data, summarize, opts);
+        out.put(", shape=");
+        out.put(shape_to_string());
+        out.put(')');
     }
 
+public:
     [[nodiscard]] std::string shape_to_string() const
     {
         std::string str = "[";
@@ -734,6 +2345,9 @@ private:
     size_t offset_ { 0 };
     const Tensor<DataType>* parent { nullptr };
     DataType* data_ { nullptr };
+    // How owned storage is freed when it did not come from new[]; views never free.
+    void (*release_)(void*, size_t) { nullptr };
+    size_t storage_bytes_ { 0 };
 };
 
 }
\ No newline at end of file
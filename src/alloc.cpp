@@ -0,0 +1,87 @@
+#include "tensile/alloc.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace Tensile {
+
+void* map_zeroed(size_t bytes)
+{
+    void* data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED)
+        throw std::bad_alloc();
+    return data;
+}
+
+void unmap(void* data, size_t bytes) { munmap(data, bytes); }
+
+void* map_file(const std::string& path, size_t bytes, bool writable, bool create)
+{
+    if (bytes == 0)
+        throw std::invalid_argument("Cannot map an empty tensor");
+
+    int flags = writable || create ? O_RDWR : O_RDONLY;
+    if (create)
+        flags |= O_CREAT | O_TRUNC;
+
+    int fd = open(path.c_str(), flags | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+
+    struct stat st {};
+    bool sized = create ? ftruncate(fd, (off_t)bytes) == 0 : fstat(fd, &st) == 0 && (size_t)st.st_size >= bytes;
+    if (!sized) {
+        close(fd);
+        throw std::runtime_error(path + " is smaller than the tensor");
+    }
+
+    // The mapping keeps its own reference to the file, so the descriptor is not needed past this point.
+    void* data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        throw std::runtime_error("Cannot map " + path + ": " + std::strerror(errno));
+    return data;
+}
+
+// The whole pages overlapping [data, data + bytes).
+static std::pair<void*, size_t> page_range(const void* data, size_t bytes)
+{
+    static const uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t begin = (uintptr_t)data & ~(page - 1);
+    uintptr_t end = ((uintptr_t)data + bytes + page - 1) & ~(page - 1);
+    return { (void*)begin, end - begin };
+}
+
+void prefetch_pages(const void* data, size_t bytes)
+{
+    if (bytes == 0)
+        return;
+    auto [begin, length] = page_range(data, bytes);
+    madvise(begin, length, MADV_WILLNEED);
+}
+
+void evict_pages(const void* data, size_t bytes)
+{
+    if (bytes == 0)
+        return;
+    auto [begin, length] = page_range(data, bytes);
+    madvise(begin, length, MADV_COLD);
+}
+
+void flush_pages(void* data, size_t bytes)
+{
+    if (bytes == 0)
+        return;
+    auto [begin, length] = page_range(data, bytes);
+    msync(begin, length, MS_ASYNC);
+}
+
+}
@@ -0,0 +1,251 @@
+#include "tensile/batched.h"
+
+#include <algorithm>
+#include <immintrin.h>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace Tensile {
+
+// Matrices per block, one per lane.
+static constexpr size_t LANES = 8;
+static constexpr size_t PARALLEL_BATCH = 1 << 12;
+
+// `Size` registers of a struct-of-arrays block: lane l of v[e] is element e of the block's l-th matrix.
+template <size_t Size> struct Lanes {
+    __m256 v[Size];
+};
+
+// Calls f(I) for I in [0, N) as straight-line code.
+template <size_t N, typename F> static inline void unroll(F&& f)
+{
+    [&]<size_t... I>(std::index_sequence<I...>) { (f(I), ...); }(std::make_index_sequence<N> {});
+}
+
+// Lanes past `count` repeat the last matrix so that they always hold valid input.
+template <size_t Size> static void load_block(const float* src, size_t stride, size_t count, Lanes<Size>& block)
+{
+    if (stride == 0) {
+        unroll<Size>([&](size_t e) { block.v[e] = _mm256_set1_ps(src[e]); });
+        return;
+    }
+
+    alignas(32) float tmp[Size][LANES];
+    for (size_t l = 0; l < LANES; l++) {
+        const float* m = src + std::min(l, count - 1) * stride;
+        unroll<Size>([&](size_t e) { tmp[e][l] = m[e]; });
+    }
+    unroll<Size>([&](size_t e) { block.v[e] = _mm256_load_ps(tmp[e]); });
+}
+
+template <size_t Size> static void store_block(const Lanes<Size>& block, float* dst, size_t count)
+{
+    alignas(32) float tmp[Size][LANES];
+    unroll<Size>([&](size_t e) { _mm256_store_ps(tmp[e], block.v[e]); });
+    for (size_t l = 0; l < count; l++)
+        unroll<Size>([&](size_t e) { dst[l * Size + e] = tmp[e][l]; });
+}
+
+// Runs f(first, count) over the batch in blocks of LANES matrices.
+template <typename F> static void for_blocks(size_t batch, F f)
+{
+    size_t n_blocks = (batch + LANES - 1) / LANES;
+
+#pragma omp parallel for num_threads(8) if (batch >= PARALLEL_BATCH)
+    for (size_t b = 0; b < n_blocks; b++)
+        f(b * LANES, std::min(LANES, batch - b * LANES));
+}
+
+// Calls f with the matrix order as a compile-time constant.
+template <typename F> static void dispatch(size_t n, F&& f)
+{
+    if (n == 0 || n > BATCHED_MAX_ORDER)
+        throw std::invalid_argument("Batched small-matrix kernels support orders 1 to 8");
+
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        ((n == I + 1 ? f(std::integral_constant<size_t, I + 1> {}) : void()), ...);
+    }(std::make_index_sequence<BATCHED_MAX_ORDER> {});
+}
+
+static inline __m256 abs_ps(__m256 x) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x); }
+
+// Swaps rows r and s of an N x N block in the lanes selected by `mask`.
+template <size_t N> static inline void swap_rows(Lanes<N * N>& m, size_t r, size_t s, __m256 mask)
+{
+    unroll<N>([&](size_t j) {
+        __m256 x = m.v[r * N + j], y = m.v[s * N + j];
+        m.v[r * N + j] = _mm256_blendv_ps(x, y, mask);
+        m.v[s * N + j] = _mm256_blendv_ps(y, x, mask);
+    });
+}
+
+// Moves the row with the largest |a[r][c]|, r >= c, into row c of `a` (and of `other`, if given), lane by lane.
+// Returns the lanes in which an odd number of swaps happened.
+template <size_t N> static __m256 pivot(Lanes<N * N>& a, Lanes<N * N>* other, size_t c)
+{
+    __m256 best = abs_ps(a.v[c * N + c]), flipped = _mm256_setzero_ps();
+    unroll<N>([&](size_t r) {
+        if (r <= c)
+            return;
+        __m256 magnitude = abs_ps(a.v[r * N + c]);
+        __m256 take = _mm256_cmp_ps(magnitude, best, _CMP_GT_OQ);
+        best = _mm256_blendv_ps(best, magnitude, take);
+        flipped = _mm256_xor_ps(flipped, take);
+        swap_rows<N>(a, c, r, take);
+        if (other)
+            swap_rows<N>(*other, c, r, take);
+    });
+    return flipped;
+}
+
+template <size_t N> static void matmul_block(const Lanes<N * N>& a, const Lanes<N * N>& b, Lanes<N * N>& c)
+{
+    unroll<N>([&](size_t i) {
+        unroll<N>([&](size_t j) {
+            __m256 acc = _mm256_mul_ps(a.v[i * N], b.v[j]);
+            unroll<N - 1>([&](size_t k) { acc = _mm256_fmadd_ps(a.v[i * N + k + 1], b.v[(k + 1) * N + j], acc); });
+            c.v[i * N + j] = acc;
+        });
+    });
+}
+
+template <size_t N> static void inverse_block(Lanes<N * N>& a, Lanes<N * N>& inv)
+{
+    unroll<N * N>([&](size_t e) { inv.v[e] = _mm256_set1_ps(e / N == e % N ? 1.0f : 0.0f); });
+
+    unroll<N>([&](size_t c) {
+        pivot<N>(a, &inv, c);
+        __m256 rcp = _mm256_div_ps(_mm256_set1_ps(1.0f), a.v[c * N + c]);
+        unroll<N>([&](size_t j) {
+            a.v[c * N + j] = _mm256_mul_ps(a.v[c * N + j], rcp);
+            inv.v[c * N + j] = _mm256_mul_ps(inv.v[c * N + j], rcp);
+        });
+
+        unroll<N>([&](size_t r) {
+            if (r == c)
+                return;
+            __m256 f = a.v[r * N + c];
+            unroll<N>([&](size_t j) {
+                a.v[r * N + j] = _mm256_fnmadd_ps(f, a.v[c * N + j], a.v[r * N + j]);
+                inv.v[r * N + j] = _mm256_fnmadd_ps(f, inv.v[c * N + j], inv.v[r * N + j]);
+            });
+        });
+    });
+}
+
+template <size_t N> static __m256 det_block(Lanes<N * N>& a)
+{
+    const __m256 zero = _mm256_setzero_ps(), sign = _mm256_set1_ps(-0.0f);
+    __m256 det = _mm256_set1_ps(1.0f);
+
+    unroll<N>([&](size_t c) {
+        __m256 flipped = pivot<N>(a, nullptr, c);
+        __m256 p = a.v[c * N + c];
+        det = _mm256_mul_ps(_mm256_xor_ps(det, _mm256_and_ps(flipped, sign)), p);
+
+        // A zero pivot means the column is zero from here down: the determinant is already 0, and eliminating with
+        // 1/0 would turn it into NaN.
+        __m256 rcp = _mm256_div_ps(_mm256_set1_ps(1.0f), p);
+        rcp = _mm256_blendv_ps(rcp, zero, _mm256_cmp_ps(p, zero, _CMP_EQ_OQ));
+        unroll<N>([&](size_t r) {
+            if (r <= c)
+                return;
+            __m256 f = _mm256_mul_ps(a.v[r * N + c], rcp);
+            unroll<N>([&](size_t j) {
+                if (j > c)
+                    a.v[r * N + j] = _mm256_fnmadd_ps(f, a.v[c * N + j], a.v[r * N + j]);
+            });
+        });
+    });
+    return det;
+}
+
+template <size_t N, size_t Len> static void transform_block(const Lanes<N * N>& m, const Lanes<Len>& v, Lanes<Len>& out)
+{
+    static_assert(Len == N || Len + 1 == N);
+
+    // Row i of m applied to v, with v[N - 1] = 1 for points.
+    auto row = [&](size_t i) {
+        __m256 acc = Len == N ? _mm256_setzero_ps() : m.v[i * N + N - 1];
+        unroll<Len>([&](size_t j) { acc = _mm256_fmadd_ps(m.v[i * N + j], v.v[j], acc); });
+        return acc;
+    };
+
+    if constexpr (Len == N) {
+        unroll<N>([&](size_t i) { out.v[i] = row(i); });
+    } else {
+        __m256 rcp_w = _mm256_div_ps(_mm256_set1_ps(1.0f), row(N - 1));
+        unroll<Len>([&](size_t i) { out.v[i] = _mm256_mul_ps(row(i), rcp_w); });
+    }
+}
+
+void batched_matmul_f32(size_t batch, size_t n, const float* a, size_t a_stride, const float* b, size_t b_stride,
+                        float* c)
+{
+    dispatch(n, [&](auto order) {
+        constexpr size_t N = decltype(order)::value;
+        for_blocks(batch, [&](size_t first, size_t count) {
+            Lanes<N * N> x, y, z;
+            load_block(a + first * a_stride, a_stride, count, x);
+            load_block(b + first * b_stride, b_stride, count, y);
+            matmul_block<N>(x, y, z);
+            store_block(z, c + first * N * N, count);
+        });
+    });
+}
+
+void batched_inverse_f32(size_t batch, size_t n, const float* a, size_t a_stride, float* out)
+{
+    dispatch(n, [&](auto order) {
+        constexpr size_t N = decltype(order)::value;
+        for_blocks(batch, [&](size_t first, size_t count) {
+            Lanes<N * N> x, inv;
+            load_block(a + first * a_stride, a_stride, count, x);
+            inverse_block<N>(x, inv);
+            store_block(inv, out + first * N * N, count);
+        });
+    });
+}
+
+void batched_det_f32(size_t batch, size_t n, const float* a, size_t a_stride, float* out)
+{
+    dispatch(n, [&](auto order) {
+        constexpr size_t N = decltype(order)::value;
+        for_blocks(batch, [&](size_t first, size_t count) {
+            Lanes<N * N> x;
+            load_block(a + first * a_stride, a_stride, count, x);
+            Lanes<1> det { { det_block<N>(x) } };
+            store_block(det, out + first, count);
+        });
+    });
+}
+
+void batched_transform_f32(size_t batch, size_t n, const float* m, size_t m_stride, const float* v, size_t v_stride,
+                           size_t v_len, float* out)
+{
+    if (v_len == 0 || (v_len != n && v_len + 1 != n))
+        throw std::invalid_argument("Vectors must have the matrix order or one less");
+
+    dispatch(n, [&](auto order) {
+        constexpr size_t N = decltype(order)::value;
+        auto run = [&](auto length) {
+            constexpr size_t Len = decltype(length)::value;
+            for_blocks(batch, [&](size_t first, size_t count) {
+                Lanes<N * N> x;
+                Lanes<Len> y, z;
+                load_block(m + first * m_stride, m_stride, count, x);
+                load_block(v + first * v_stride, v_stride, count, y);
+                transform_block<N, Len>(x, y, z);
+                store_block(z, out + first * Len, count);
+            });
+        };
+
+        if (v_len == N)
+            run(std::integral_constant<size_t, N> {});
+        else if constexpr (N > 1)
+            run(std::integral_constant<size_t, N - 1> {});
+    });
+}
+
+}
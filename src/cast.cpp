@@ -0,0 +1,192 @@
+#include "tensile/cast.h"
+
+#include <immintrin.h>
+
+namespace Tensile {
+
+// Elements per unit of parallel work, a multiple of every vector step.
+static constexpr size_t CHUNK = 1 << 15;
+
+// Converts `Step` elements at a time with `vec` and the remainder of each chunk with cast_value.
+template <size_t Step, typename S, typename D, typename Vec>
+static void run(const S* src, D* dst, size_t n, CastMode mode, Vec vec)
+{
+    size_t n_chunks = (n + CHUNK - 1) / CHUNK;
+
+#pragma omp parallel for num_threads(8) if (n >= CAST_PARALLEL)
+    for (size_t c = 0; c < n_chunks; c++) {
+        size_t i = c * CHUNK, end = std::min(n, i + CHUNK);
+        for (; i + Step <= end; i += Step)
+            vec(src + i, dst + i);
+        for (; i < end; i++)
+            dst[i] = cast_value<D>(src[i], mode);
+    }
+}
+
+static inline __m128i load_128(const void* src) { return _mm_loadu_si128(static_cast<const __m128i*>(src)); }
+
+static inline __m256i load_256(const void* src) { return _mm256_loadu_si256(static_cast<const __m256i*>(src)); }
+
+static inline void store_128(void* dst, __m128i x) { _mm_storeu_si128(static_cast<__m128i*>(dst), x); }
+
+static inline void store_64(void* dst, __m128i x) { _mm_storel_epi64(static_cast<__m128i*>(dst), x); }
+
+void cast_kernel(const int32_t* src, float* dst, size_t n, CastMode mode)
+{
+    run<8>(src, dst, n, mode, [](const int32_t* s, float* d) { _mm256_storeu_ps(d, _mm256_cvtepi32_ps(load_256(s))); });
+}
+
+// cvttps_epi32 returns INT32_MIN for NaN and anything out of range: NaN is zeroed first and overflow past the top is
+// patched to INT32_MAX, which leaves exactly the values that really are INT32_MIN or below.
+void cast_kernel(const float* src, int32_t* dst, size_t n, CastMode mode)
+{
+    run<8>(src, dst, n, mode, [](const float* s, int32_t* d) {
+        __m256 x = _mm256_loadu_ps(s);
+        x = _mm256_and_ps(x, _mm256_cmp_ps(x, x, _CMP_ORD_Q));
+        __m256i r = _mm256_cvttps_epi32(x);
+        __m256 overflow = _mm256_cmp_ps(x, _mm256_set1_ps(2147483648.0f), _CMP_GE_OQ);
+        r = _mm256_blendv_epi8(r, _mm256_set1_epi32(INT32_MAX), _mm256_castps_si256(overflow));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d), r);
+    });
+}
+
+void cast_kernel(const uint8_t* src, float* dst, size_t n, CastMode mode)
+{
+    run<8>(src, dst, n, mode, [](const uint8_t* s, float* d) {
+        __m256i widened = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(s)));
+        _mm256_storeu_ps(d, _mm256_cvtepi32_ps(widened));
+    });
+}
+
+// Narrows eight int32 lanes to int16 with signed saturation, in element order.
+static inline __m128i packs_epi32(__m256i x)
+{
+    return _mm_packs_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+}
+
+// Narrows eight int32 lanes to uint16 with unsigned saturation.
+static inline __m128i packus_epi32(__m256i x)
+{
+    return _mm_packus_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+}
+
+void cast_kernel(const float* src, uint8_t* dst, size_t n, CastMode mode)
+{
+    // max_ps returns its second operand when the first is NaN, so NaN clamps to 0 along with the negatives.
+    run<8>(src, dst, n, mode, [](const float* s, uint8_t* d) {
+        __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(s), _mm256_setzero_ps()), _mm256_set1_ps(255.0f));
+        __m128i words = packus_epi32(_mm256_cvttps_epi32(x));
+        store_64(d, _mm_packus_epi16(words, words));
+    });
+}
+
+void cast_kernel(const double* src, float* dst, size_t n, CastMode mode)
+{
+    run<8>(src, dst, n, mode, [](const double* s, float* d) {
+        _mm_storeu_ps(d, _mm256_cvtpd_ps(_mm256_loadu_pd(s)));
+        _mm_storeu_ps(d + 4, _mm256_cvtpd_ps(_mm256_loadu_pd(s + 4)));
+    });
+}
+
+void cast_kernel(const float* src, double* dst, size_t n, CastMode mode)
+{
+    run<8>(src, dst, n, mode, [](const float* s, double* d) {
+        _mm256_storeu_pd(d, _mm256_cvtps_pd(_mm_loadu_ps(s)));
+        _mm256_storeu_pd(d + 4, _mm256_cvtps_pd(_mm_loadu_ps(s + 4)));
+    });
+}
+
+void cast_kernel(const int32_t* src, double* dst, size_t n, CastMode mode)
+{
+    run<8>(src, dst, n, mode, [](const int32_t* s, double* d) {
+        _mm256_storeu_pd(d, _mm256_cvtepi32_pd(load_128(s)));
+        _mm256_storeu_pd(d + 4, _mm256_cvtepi32_pd(load_128(s + 4)));
+    });
+}
+
+// Both int32 limits are exact doubles, so clamping before the conversion saturates exactly.
+void cast_kernel(const double* src, int32_t* dst, size_t n, CastMode mode)
+{
+    run<4>(src, dst, n, mode, [](const double* s, int32_t* d) {
+        __m256d x = _mm256_loadu_pd(s);
+        x = _mm256_and_pd(x, _mm256_cmp_pd(x, x, _CMP_ORD_Q));
+        x = _mm256_min_pd(_mm256_max_pd(x, _mm256_set1_pd(INT32_MIN)), _mm256_set1_pd(INT32_MAX));
+        store_128(d, _mm256_cvttpd_epi32(x));
+    });
+}
+
+// Integer narrowing saturates with the signed packs, or keeps the low bits by masking them off before an unsigned pack
+// that then never saturates.
+void cast_kernel(const int32_t* src, int16_t* dst, size_t n, CastMode mode)
+{
+    if (mode == CastMode::SATURATE)
+        run<8>(src, dst, n, mode, [](const int32_t* s, int16_t* d) { store_128(d, packs_epi32(load_256(s))); });
+    else
+        run<8>(src, dst, n, mode, [](const int32_t* s, int16_t* d) {
+            store_128(d, packus_epi32(_mm256_and_si256(load_256(s), _mm256_set1_epi32(0xFFFF))));
+        });
+}
+
+void cast_kernel(const int32_t* src, uint16_t* dst, size_t n, CastMode mode)
+{
+    if (mode == CastMode::SATURATE)
+        run<8>(src, dst, n, mode, [](const int32_t* s, uint16_t* d) { store_128(d, packus_epi32(load_256(s))); });
+    else
+        run<8>(src, dst, n, mode, [](const int32_t* s, uint16_t* d) {
+            store_128(d, packus_epi32(_mm256_and_si256(load_256(s), _mm256_set1_epi32(0xFFFF))));
+        });
+}
+
+void cast_kernel(const int32_t* src, int8_t* dst, size_t n, CastMode mode)
+{
+    if (mode == CastMode::SATURATE)
+        run<8>(src, dst, n, mode, [](const int32_t* s, int8_t* d) {
+            __m128i words = packs_epi32(load_256(s));
+            store_64(d, _mm_packs_epi16(words, words));
+        });
+    else
+        run<8>(src, dst, n, mode, [](const int32_t* s, int8_t* d) {
+            __m128i words = packus_epi32(_mm256_and_si256(load_256(s), _mm256_set1_epi32(0xFF)));
+            store_64(d, _mm_packus_epi16(words, words));
+        });
+}
+
+void cast_kernel(const int32_t* src, uint8_t* dst, size_t n, CastMode mode)
+{
+    if (mode == CastMode::SATURATE)
+        run<8>(src, dst, n, mode, [](const int32_t* s, uint8_t* d) {
+            __m128i words = packs_epi32(load_256(s));
+            store_64(d, _mm_packus_epi16(words, words));
+        });
+    else
+        run<8>(src, dst, n, mode, [](const int32_t* s, uint8_t* d) {
+            __m128i words = packus_epi32(_mm256_and_si256(load_256(s), _mm256_set1_epi32(0xFF)));
+            store_64(d, _mm_packus_epi16(words, words));
+        });
+}
+
+void cast_kernel(const int64_t* src, int32_t* dst, size_t n, CastMode mode)
+{
+    // The low dword of each of the four lanes, gathered into the bottom half.
+    const __m256i low_dwords = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    bool saturate = mode == CastMode::SATURATE;
+
+    run<4>(src, dst, n, mode, [&](const int64_t* s, int32_t* d) {
+        __m256i x = load_256(s);
+        if (saturate) {
+            __m256i hi = _mm256_set1_epi64x(INT32_MAX), lo = _mm256_set1_epi64x(INT32_MIN);
+            x = _mm256_blendv_epi8(x, hi, _mm256_cmpgt_epi64(x, hi));
+            x = _mm256_blendv_epi8(x, lo, _mm256_cmpgt_epi64(lo, x));
+        }
+        store_128(d, _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(x, low_dwords)));
+    });
+}
+
+void cast_kernel(const int32_t* src, int64_t* dst, size_t n, CastMode mode)
+{
+    run<4>(src, dst, n, mode, [](const int32_t* s, int64_t* d) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d), _mm256_cvtepi32_epi64(load_128(s)));
+    });
+}
+
+}
@@ -0,0 +1,287 @@
+#include "tensile/compare.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <immintrin.h>
+#include <limits>
+#include <vector>
+
+namespace Tensile {
+
+// Elements per unit of parallel work, a multiple of the 32 elements handled per vector step.
+static constexpr size_t CHUNK = 1 << 14;
+static constexpr size_t PARALLEL_WORK = 1 << 16;
+
+template <typename Body> static void parallel_chunks(size_t n, Body body)
+{
+    size_t n_chunks = (n + CHUNK - 1) / CHUNK;
+
+#pragma omp parallel for num_threads(8) if (n > PARALLEL_WORK)
+    for (size_t c = 0; c < n_chunks; c++)
+        body(c * CHUNK, std::min(CHUNK, n - c * CHUNK));
+}
+
+template <CompareOp Op> static inline bool compare_one(float a, float b)
+{
+    if constexpr (Op == CompareOp::EQ)
+        return a == b;
+    else if constexpr (Op == CompareOp::NE)
+        return a != b;
+    else if constexpr (Op == CompareOp::LT)
+        return a < b;
+    else if constexpr (Op == CompareOp::LE)
+        return a <= b;
+    else if constexpr (Op == CompareOp::GT)
+        return a > b;
+    else
+        return a >= b;
+}
+
+template <CompareOp Op> static inline __m256 compare_ps(__m256 a, __m256 b)
+{
+    if constexpr (Op == CompareOp::EQ)
+        return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+    else if constexpr (Op == CompareOp::NE)
+        return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ);
+    else if constexpr (Op == CompareOp::LT)
+        return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+    else if constexpr (Op == CompareOp::LE)
+        return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+    else if constexpr (Op == CompareOp::GT)
+        return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+    else
+        return _mm256_cmp_ps(a, b, _CMP_GE_OQ);
+}
+
+// Narrows four all-ones/all-zeros float masks (32 elements) to 0/1 bytes in element order. The two packs interleave
+// the 128-bit halves, which the final dword permutation undoes.
+static inline __m256i masks_to_bytes(__m256 m0, __m256 m1, __m256 m2, __m256 m3)
+{
+    __m256i w01 = _mm256_packs_epi32(_mm256_castps_si256(m0), _mm256_castps_si256(m1));
+    __m256i w23 = _mm256_packs_epi32(_mm256_castps_si256(m2), _mm256_castps_si256(m3));
+    __m256i bytes = _mm256_packs_epi16(w01, w23);
+    bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+    return _mm256_and_si256(bytes, _mm256_set1_epi8(1));
+}
+
+// `b` advances with the elements unless `b_stride` is 0, in which case b[0] is compared with every element.
+template <CompareOp Op>
+static void compare_block(const float* a, const float* b, size_t b_stride, uint8_t* out, size_t n)
+{
+    auto load_b = [&](size_t i) { return b_stride ? _mm256_loadu_ps(b + i) : _mm256_set1_ps(b[0]); };
+
+    size_t i = 0;
+    for (; i + 31 < n; i += 32) {
+        __m256 m0 = compare_ps<Op>(_mm256_loadu_ps(a + i), load_b(i));
+        __m256 m1 = compare_ps<Op>(_mm256_loadu_ps(a + i + 8), load_b(i + 8));
+        __m256 m2 = compare_ps<Op>(_mm256_loadu_ps(a + i + 16), load_b(i + 16));
+        __m256 m3 = compare_ps<Op>(_mm256_loadu_ps(a + i + 24), load_b(i + 24));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), masks_to_bytes(m0, m1, m2, m3));
+    }
+    for (; i < n; i++)
+        out[i] = compare_one<Op>(a[i], b[i * b_stride]);
+}
+
+template <CompareOp Op> static void compare_all(const float* a, const float* b, size_t b_stride, uint8_t* out, size_t n)
+{
+    parallel_chunks(n, [&](size_t start, size_t count) {
+        compare_block<Op>(a + start, b + start * b_stride, b_stride, out + start, count);
+    });
+}
+
+static void compare_dispatch(const float* a, const float* b, size_t b_stride, uint8_t* out, size_t n, CompareOp op)
+{
+    switch (op) {
+    case CompareOp::EQ:
+        return compare_all<CompareOp::EQ>(a, b, b_stride, out, n);
+    case CompareOp::NE:
+        return compare_all<CompareOp::NE>(a, b, b_stride, out, n);
+    case CompareOp::LT:
+        return compare_all<CompareOp::LT>(a, b, b_stride, out, n);
+    case CompareOp::LE:
+        return compare_all<CompareOp::LE>(a, b, b_stride, out, n);
+    case CompareOp::GT:
+        return compare_all<CompareOp::GT>(a, b, b_stride, out, n);
+    case CompareOp::GE:
+        return compare_all<CompareOp::GE>(a, b, b_stride, out, n);
+    }
+}
+
+void compare_f32(const float* a, const float* b, uint8_t* out, size_t n, CompareOp op)
+{
+    compare_dispatch(a, b, 1, out, n, op);
+}
+
+void compare_scalar_f32(const float* a, float b, uint8_t* out, size_t n, CompareOp op)
+{
+    compare_dispatch(a, &b, 0, out, n, op);
+}
+
+// Lane mask of the elements of a and b that are close.
+static inline __m256 close_ps(__m256 a, __m256 b, __m256 rtol, __m256 atol, bool equal_nan)
+{
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 diff = _mm256_and_ps(_mm256_sub_ps(a, b), abs_mask);
+    __m256 b_abs = _mm256_and_ps(b, abs_mask);
+    __m256 bound = _mm256_fmadd_ps(rtol, b_abs, atol);
+    // An infinite b makes the bound infinite too, so infinities are only matched by the equality test.
+    __m256 finite_b = _mm256_cmp_ps(b_abs, _mm256_set1_ps(std::numeric_limits<float>::infinity()), _CMP_LT_OQ);
+    __m256 within = _mm256_and_ps(_mm256_cmp_ps(diff, bound, _CMP_LE_OQ), finite_b);
+    __m256 close = _mm256_or_ps(within, _mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+    if (equal_nan) {
+        __m256 both_nan = _mm256_and_ps(_mm256_cmp_ps(a, a, _CMP_UNORD_Q), _mm256_cmp_ps(b, b, _CMP_UNORD_Q));
+        close = _mm256_or_ps(close, both_nan);
+    }
+    return close;
+}
+
+static bool close_one(float a, float b, float rtol, float atol, bool equal_nan)
+{
+    if (std::isnan(a) || std::isnan(b))
+        return equal_nan && std::isnan(a) && std::isnan(b);
+    return a == b || (std::isfinite(b) && std::abs(a - b) <= std::fma(rtol, std::abs(b), atol));
+}
+
+static bool allclose_block(const float* a, const float* b, size_t n, float rtol, float atol, bool equal_nan)
+{
+    __m256 vrtol = _mm256_set1_ps(rtol), vatol = _mm256_set1_ps(atol);
+    __m256 all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+    size_t i = 0;
+    for (; i + 7 < n; i += 8)
+        all = _mm256_and_ps(all, close_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), vrtol, vatol, equal_nan));
+    if (_mm256_movemask_ps(all) != 0xFF)
+        return false;
+
+    for (; i < n; i++)
+        if (!close_one(a[i], b[i], rtol, atol, equal_nan))
+            return false;
+    return true;
+}
+
+bool allclose_f32(const float* a, const float* b, size_t n, float rtol, float atol, bool equal_nan)
+{
+    if (n <= PARALLEL_WORK) {
+        for (size_t start = 0; start < n; start += CHUNK)
+            if (!allclose_block(a + start, b + start, std::min(CHUNK, n - start), rtol, atol, equal_nan))
+                return false;
+        return true;
+    }
+
+    // Chunks still queued when a mismatch is found are skipped.
+    std::atomic<bool> mismatch { false };
+    parallel_chunks(n, [&](size_t start, size_t count) {
+        if (mismatch.load(std::memory_order_relaxed))
+            return;
+        if (!allclose_block(a + start, b + start, count, rtol, atol, equal_nan))
+            mismatch.store(true, std::memory_order_relaxed);
+    });
+    return !mismatch.load();
+}
+
+// Lanes whose mask byte (8 bytes from `mask`) is nonzero.
+static inline __m256i byte_mask_epi32(const uint8_t* mask)
+{
+    __m256i bytes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(mask)));
+    return _mm256_xor_si256(_mm256_cmpeq_epi32(bytes, _mm256_setzero_si256()), _mm256_set1_epi32(-1));
+}
+
+void where_f32(const uint8_t* mask, const float* a, const float* b, float* out, size_t n)
+{
+    parallel_chunks(n, [&](size_t start, size_t count) {
+        size_t i = start, end = start + count;
+        for (; i + 7 < end; i += 8) {
+            __m256 take_a = _mm256_castsi256_ps(byte_mask_epi32(mask + i));
+            _mm256_storeu_ps(out + i, _mm256_blendv_ps(_mm256_loadu_ps(b + i), _mm256_loadu_ps(a + i), take_a));
+        }
+        for (; i < end; i++)
+            out[i] = mask[i] ? a[i] : b[i];
+    });
+}
+
+static size_t count_block(const uint8_t* mask, size_t n)
+{
+    size_t count = 0, i = 0;
+    for (; i + 31 < n; i += 32) {
+        __m256i zero = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i)),
+                                         _mm256_setzero_si256());
+        count += 32 - std::popcount((uint32_t)_mm256_movemask_epi8(zero));
+    }
+    for (; i < n; i++)
+        count += mask[i] != 0;
+    return count;
+}
+
+size_t count_mask(const uint8_t* mask, size_t n)
+{
+    size_t n_chunks = (n + CHUNK - 1) / CHUNK;
+    std::vector<size_t> counts(n_chunks);
+    parallel_chunks(n, [&](size_t start, size_t count) { counts[start / CHUNK] = count_block(mask + start, count); });
+
+    size_t total = 0;
+    for (size_t c : counts)
+        total += c;
+    return total;
+}
+
+// For each 8-bit lane mask, the indices of its set lanes first, in order: a permutation that packs the selected
+// elements of a vector to its front.
+static constexpr auto COMPRESS_LUT = [] {
+    std::array<std::array<uint32_t, 8>, 256> lut {};
+    for (uint32_t bits = 0; bits < 256; bits++) {
+        uint32_t k = 0;
+        for (uint32_t lane = 0; lane < 8; lane++)
+            if (bits & (1u << lane))
+                lut[bits][k++] = lane;
+    }
+    return lut;
+}();
+
+// Compacts one chunk into out[0, capacity). Full-width stores are used only while they stay inside the chunk's own
+// output range, since the next range belongs to another thread.
+static void select_block(const float* x, const uint8_t* mask, size_t n, float* out, size_t capacity)
+{
+    size_t pos = 0, i = 0;
+    for (; i + 7 < n; i += 8) {
+        uint32_t bits = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(byte_mask_epi32(mask + i)));
+        if (bits == 0)
+            continue;
+
+        __m256i perm = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(COMPRESS_LUT[bits].data()));
+        __m256 packed = _mm256_permutevar8x32_ps(_mm256_loadu_ps(x + i), perm);
+        if (pos + 8 <= capacity) {
+            _mm256_storeu_ps(out + pos, packed);
+        } else {
+            alignas(32) float tmp[8];
+            _mm256_store_ps(tmp, packed);
+            std::copy(tmp, tmp + std::popcount(bits), out + pos);
+        }
+        pos += std::popcount(bits);
+    }
+    for (; i < n; i++)
+        if (mask[i])
+            out[pos++] = x[i];
+}
+
+size_t masked_select_f32(const float* x, const uint8_t* mask, size_t n, float* out)
+{
+    // Count per chunk, then compact each chunk at its prefix offset.
+    size_t n_chunks = (n + CHUNK - 1) / CHUNK;
+    std::vector<size_t> offsets(n_chunks + 1, 0);
+    parallel_chunks(n, [&](size_t start, size_t count) {
+        offsets[start / CHUNK + 1] = count_block(mask + start, count);
+    });
+    for (size_t c = 0; c < n_chunks; c++)
+        offsets[c + 1] += offsets[c];
+
+    parallel_chunks(n, [&](size_t start, size_t count) {
+        size_t c = start / CHUNK;
+        select_block(x + start, mask + start, count, out + offsets[c], offsets[c + 1] - offsets[c]);
+    });
+    return offsets[n_chunks];
+}
+
+}
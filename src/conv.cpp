@@ -0,0 +1,442 @@
+#include "tensile/conv.h"
+#include "tensile/gemm.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <immintrin.h>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace Tensile {
+
+// Sizes of an image batch independent of its layout.
+struct ImageShape {
+    size_t n, c, h, w;
+};
+
+static ImageShape image_shape(const Tensor<float>& tensor, Layout layout)
+{
+    if (tensor.n_dims() != 4)
+        throw std::invalid_argument("Expected a 4D image tensor");
+
+    auto s = tensor.shape();
+    return layout == Layout::NCHW ? ImageShape { s[0], s[1], s[2], s[3] } : ImageShape { s[0], s[3], s[1], s[2] };
+}
+
+static Tensor<float> image_tensor(const ImageShape& shape, Layout layout)
+{
+    auto* data = new float[shape.n * shape.c * shape.h * shape.w];
+    return layout == Layout::NCHW ? Tensor<float>(data, { shape.n, shape.c, shape.h, shape.w })
+                                  : Tensor<float>(data, { shape.n, shape.h, shape.w, shape.c });
+}
+
+static size_t output_extent(size_t in, size_t kernel, size_t stride, size_t pad, size_t dilation)
+{
+    if (kernel == 0 || stride == 0 || dilation == 0)
+        throw std::invalid_argument("Kernel size, stride and dilation must be positive");
+
+    size_t span = dilation * (kernel - 1) + 1;
+    if (in + 2 * pad < span)
+        throw std::invalid_argument("Kernel is larger than the padded input");
+    return (in + 2 * pad - span) / stride + 1;
+}
+
+// Output positions [begin, end) whose input coordinate o * stride + offset falls inside [0, in).
+struct ValidRange {
+    size_t begin, end;
+};
+
+static ValidRange valid_range(ptrdiff_t offset, size_t stride, size_t in, size_t out)
+{
+    auto s = (ptrdiff_t)stride;
+    ptrdiff_t begin = offset < 0 ? (-offset + s - 1) / s : 0;
+    ptrdiff_t end = (ptrdiff_t)in > offset ? ((ptrdiff_t)in - offset + s - 1) / s : 0;
+    end = std::min(end, (ptrdiff_t)out);
+    return { (size_t)begin, (size_t)std::max(begin, end) };
+}
+
+// dst[0, n) += scale * src[0, n)
+static void axpy(float* dst, const float* src, float scale, size_t n)
+{
+    __m256 vscale = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 7 < n; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(vscale, _mm256_loadu_ps(src + i), _mm256_loadu_ps(dst + i)));
+    for (; i < n; i++)
+        dst[i] += scale * src[i];
+}
+
+// dst[0, n) += a[0, n) * b[0, n)
+static void fma_into(float* dst, const float* a, const float* b, size_t n)
+{
+    size_t i = 0;
+    for (; i + 7 < n; i += 8)
+        _mm256_storeu_ps(dst + i,
+                         _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), _mm256_loadu_ps(dst + i)));
+    for (; i < n; i++)
+        dst[i] += a[i] * b[i];
+}
+
+struct ConvShape {
+    ImageShape in, out;
+    size_t kh, kw;
+    size_t in_per_group, out_per_group;
+};
+
+// NHWC groups with at most this many input channels (RGB input layers, for example) run the direct kernel: their
+// im2col rows are too short to pay for the copy. In NCHW the GEMM reuses each input row across output channels, which
+// the plane-at-a-time direct kernel does not, so only depthwise convolutions run direct there.
+static constexpr size_t DIRECT_MAX_CHANNELS = 4;
+
+// Depthwise NCHW: every output plane is a sum of shifted, scaled copies of one input plane, accumulated a row at a
+// time so that unit-stride rows vectorize.
+static void depthwise_nchw(const float* in, const float* weight, const float* bias, float* out, const ConvShape& cs,
+                           const Conv2dParams& p)
+{
+    const auto &is = cs.in, &os = cs.out;
+
+#pragma omp parallel for num_threads(8) collapse(2)
+    for (size_t n = 0; n < os.n; n++) {
+        for (size_t oc = 0; oc < os.c; oc++) {
+            const float* plane = in + (n * is.c + oc / cs.out_per_group) * is.h * is.w;
+            float* out_plane = out + (n * os.c + oc) * os.h * os.w;
+            std::fill(out_plane, out_plane + os.h * os.w, bias ? bias[oc] : 0.0f);
+
+            for (size_t kh = 0; kh < cs.kh; kh++) {
+                ptrdiff_t off_h = (ptrdiff_t)(kh * p.dilation_h) - (ptrdiff_t)p.pad_h;
+                auto rows = valid_range(off_h, p.stride_h, is.h, os.h);
+
+                for (size_t kw = 0; kw < cs.kw; kw++) {
+                    ptrdiff_t off_w = (ptrdiff_t)(kw * p.dilation_w) - (ptrdiff_t)p.pad_w;
+                    auto cols = valid_range(off_w, p.stride_w, is.w, os.w);
+                    float w = weight[(oc * cs.kh + kh) * cs.kw + kw];
+
+                    for (size_t oh = rows.begin; oh < rows.end; oh++) {
+                        const float* in_row = plane + (oh * p.stride_h + off_h) * is.w;
+                        float* out_row = out_plane + oh * os.w;
+                        if (p.stride_w == 1) {
+                            axpy(out_row + cols.begin, in_row + cols.begin + off_w, w, cols.end - cols.begin);
+                        } else {
+                            for (size_t ow = cols.begin; ow < cols.end; ow++)
+                                out_row[ow] += w * in_row[ow * p.stride_w + off_w];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Direct NHWC: channels are contiguous, so each output pixel accumulates kernel_h * kernel_w * in_per_group channel
+// vectors.
+static void direct_nhwc(const float* in, const float* weight, const float* bias, float* out, const ConvShape& cs,
+                        const Conv2dParams& p)
+{
+    const auto &is = cs.in, &os = cs.out;
+    size_t cg = cs.in_per_group, og = cs.out_per_group;
+
+    // [kh, kw, c, out_channels], so the weights of one kernel tap and input channel are contiguous like the output
+    // channels they produce.
+    std::vector<float> taps(cs.kh * cs.kw * cg * os.c);
+    for (size_t oc = 0; oc < os.c; oc++)
+        for (size_t c = 0; c < cg; c++)
+            for (size_t t = 0; t < cs.kh * cs.kw; t++)
+                taps[(t * cg + c) * os.c + oc] = weight[(oc * cg + c) * cs.kh * cs.kw + t];
+
+    // Each group's output channels read the same input channel through tap channel c: with at least a vector of them,
+    // that is one broadcast FMA per group. Otherwise output channel oc reads input channel oc / og * cg + c, and unless
+    // that is simply oc the input pixel is expanded into output channel order once per tap and channel.
+    bool broadcast = og >= 8, identity = cg == 1 && og == 1;
+    std::vector<float> expanded(broadcast || identity ? 0 : os.c);
+
+#pragma omp parallel for num_threads(8) collapse(2) firstprivate(expanded)
+    for (size_t n = 0; n < os.n; n++) {
+        for (size_t oh = 0; oh < os.h; oh++) {
+            for (size_t ow = 0; ow < os.w; ow++) {
+                float* out_px = out + ((n * os.h + oh) * os.w + ow) * os.c;
+                for (size_t oc = 0; oc < os.c; oc++)
+                    out_px[oc] = bias ? bias[oc] : 0.0f;
+
+                for (size_t kh = 0; kh < cs.kh; kh++) {
+                    ptrdiff_t ih = (ptrdiff_t)(oh * p.stride_h + kh * p.dilation_h) - (ptrdiff_t)p.pad_h;
+                    if (ih < 0 || ih >= (ptrdiff_t)is.h)
+                        continue;
+
+                    for (size_t kw = 0; kw < cs.kw; kw++) {
+                        ptrdiff_t iw = (ptrdiff_t)(ow * p.stride_w + kw * p.dilation_w) - (ptrdiff_t)p.pad_w;
+                        if (iw < 0 || iw >= (ptrdiff_t)is.w)
+                            continue;
+
+                        const float* in_px = in + ((n * is.h + (size_t)ih) * is.w + (size_t)iw) * is.c;
+                        for (size_t c = 0; c < cg; c++) {
+                            const float* tap = taps.data() + ((kh * cs.kw + kw) * cg + c) * os.c;
+                            if (broadcast) {
+                                for (size_t g = 0; g < p.groups; g++)
+                                    axpy(out_px + g * og, tap + g * og, in_px[g * cg + c], og);
+                            } else if (identity) {
+                                fma_into(out_px, tap, in_px, os.c);
+                            } else {
+                                for (size_t oc = 0; oc < os.c; oc++)
+                                    expanded[oc] = in_px[oc / og * cg + c];
+                                fma_into(out_px, tap, expanded.data(), os.c);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Columns of the NCHW lowering: row (c, kh, kw) of the [in_per_group * kh * kw, out_h * out_w] matrix holds the input
+// pixel each output position reads through that tap, or 0 in the padding.
+static void im2col_nchw(const float* image, float* col, const ConvShape& cs, const Conv2dParams& p)
+{
+    const auto &is = cs.in, &os = cs.out;
+    size_t n_rows = cs.in_per_group * cs.kh * cs.kw;
+
+#pragma omp parallel for num_threads(8) if (n_rows * os.h * os.w > (1 << 15))
+    for (size_t row = 0; row < n_rows; row++) {
+        size_t c = row / (cs.kh * cs.kw), kh = row / cs.kw % cs.kh, kw = row % cs.kw;
+        ptrdiff_t off_h = (ptrdiff_t)(kh * p.dilation_h) - (ptrdiff_t)p.pad_h;
+        ptrdiff_t off_w = (ptrdiff_t)(kw * p.dilation_w) - (ptrdiff_t)p.pad_w;
+        auto rows = valid_range(off_h, p.stride_h, is.h, os.h);
+        auto cols = valid_range(off_w, p.stride_w, is.w, os.w);
+
+        const float* plane = image + c * is.h * is.w;
+        float* dst = col + row * os.h * os.w;
+        std::fill(dst, dst + os.h * os.w, 0.0f);
+        for (size_t oh = rows.begin; oh < rows.end; oh++) {
+            const float* in_row = plane + (oh * p.stride_h + off_h) * is.w;
+            for (size_t ow = cols.begin; ow < cols.end; ow++)
+                dst[oh * os.w + ow] = in_row[ow * p.stride_w + off_w];
+        }
+    }
+}
+
+// Rows of the NHWC lowering: row (oh, ow) of the [out_h * out_w, kh * kw * in_per_group] matrix concatenates the
+// channel vectors the output pixel reads, which are contiguous runs of the input.
+static void im2col_nhwc(const float* image, size_t c_begin, float* col, const ConvShape& cs, const Conv2dParams& p)
+{
+    const auto &is = cs.in, &os = cs.out;
+    size_t cg = cs.in_per_group, row_len = cs.kh * cs.kw * cg;
+
+#pragma omp parallel for num_threads(8) if (os.h * os.w * row_len > (1 << 15))
+    for (size_t oh = 0; oh < os.h; oh++) {
+        for (size_t ow = 0; ow < os.w; ow++) {
+            float* dst = col + (oh * os.w + ow) * row_len;
+            for (size_t kh = 0; kh < cs.kh; kh++) {
+                ptrdiff_t ih = (ptrdiff_t)(oh * p.stride_h + kh * p.dilation_h) - (ptrdiff_t)p.pad_h;
+                for (size_t kw = 0; kw < cs.kw; kw++, dst += cg) {
+                    ptrdiff_t iw = (ptrdiff_t)(ow * p.stride_w + kw * p.dilation_w) - (ptrdiff_t)p.pad_w;
+                    if (ih < 0 || ih >= (ptrdiff_t)is.h || iw < 0 || iw >= (ptrdiff_t)is.w) {
+                        std::fill(dst, dst + cg, 0.0f);
+                        continue;
+                    }
+                    const float* src = image + ((size_t)ih * is.w + (size_t)iw) * is.c + c_begin;
+                    std::copy(src, src + cg, dst);
+                }
+            }
+        }
+    }
+}
+
+static void conv_gemm_nchw(const float* in, const float* weight, const float* bias, float* out, const ConvShape& cs,
+                           const Conv2dParams& p, bool pointwise)
+{
+    const auto &is = cs.in, &os = cs.out;
+    size_t k = cs.in_per_group * cs.kh * cs.kw, pixels = os.h * os.w;
+    std::vector<float> col(pointwise ? 0 : k * pixels);
+
+    for (size_t n = 0; n < is.n; n++) {
+        for (size_t g = 0; g < p.groups; g++) {
+            const float* image = in + (n * is.c + g * cs.in_per_group) * is.h * is.w;
+            MatrixRef b { image, pixels, 1 };
+            if (!pointwise) {
+                im2col_nchw(image, col.data(), cs, p);
+                b = { col.data(), pixels, 1 };
+            }
+
+            MatrixRef a { weight + g * cs.out_per_group * k, k, 1 };
+            MatrixRef bias_ref = bias ? MatrixRef { bias + g * cs.out_per_group, 1, 0 } : MatrixRef {};
+            float* c = out + (n * os.c + g * cs.out_per_group) * pixels;
+            sgemm(cs.out_per_group, pixels, k, a, b, c, pixels, Epilogue {}, bias_ref);
+        }
+    }
+}
+
+static void conv_gemm_nhwc(const float* in, const float* weight, const float* bias, float* out, const ConvShape& cs,
+                           const Conv2dParams& p, bool pointwise)
+{
+    const auto &is = cs.in, &os = cs.out;
+    size_t cg = cs.in_per_group, og = cs.out_per_group;
+    size_t k = cs.kh * cs.kw * cg, pixels = os.h * os.w;
+
+    // [group][kh, kw, c][o]: the K order of an NHWC im2col row, with the group's output channels contiguous.
+    std::vector<float> packed(p.groups * k * og);
+    for (size_t g = 0; g < p.groups; g++)
+        for (size_t o = 0; o < og; o++)
+            for (size_t c = 0; c < cg; c++)
+                for (size_t t = 0; t < cs.kh * cs.kw; t++)
+                    packed[(g * k + t * cg + c) * og + o] = weight[((g * og + o) * cg + c) * cs.kh * cs.kw + t];
+
+    std::vector<float> col(pointwise ? 0 : pixels * k);
+
+    for (size_t n = 0; n < is.n; n++) {
+        const float* image = in + n * is.h * is.w * is.c;
+        for (size_t g = 0; g < p.groups; g++) {
+            MatrixRef a { image + g * cg, is.c, 1 };
+            if (!pointwise) {
+                im2col_nhwc(image, g * cg, col.data(), cs, p);
+                a = { col.data(), k, 1 };
+            }
+
+            MatrixRef b { packed.data() + g * k * og, og, 1 };
+            MatrixRef bias_ref = bias ? MatrixRef { bias + g * og, 0, 1 } : MatrixRef {};
+            float* c = out + n * pixels * os.c + g * og;
+            sgemm(pixels, og, k, a, b, c, os.c, Epilogue {}, bias_ref);
+        }
+    }
+}
+
+Tensor<float> conv2d(const Tensor<float>& input, const Tensor<float>& weight, const Tensor<float>* bias,
+                     const Conv2dParams& params)
+{
+    ConvShape cs;
+    cs.in = image_shape(input, params.layout);
+    if (weight.n_dims() != 4)
+        throw std::invalid_argument("Convolution weight must be [out_channels, in_channels / groups, kh, kw]");
+    if (params.groups == 0 || cs.in.c % params.groups != 0 || weight.shape()[0] % params.groups != 0)
+        throw std::invalid_argument("Channels must be divisible by the number of groups");
+    if (weight.shape()[1] * params.groups != cs.in.c)
+        throw std::invalid_argument("Weight input channels do not match the input");
+    if (bias && (bias->n_dims() != 1 || bias->shape()[0] != weight.shape()[0]))
+        throw std::invalid_argument("Bias must be a 1D tensor with one element per output channel");
+
+    cs.kh = weight.shape()[2];
+    cs.kw = weight.shape()[3];
+    cs.in_per_group = weight.shape()[1];
+    cs.out_per_group = weight.shape()[0] / params.groups;
+    cs.out = { cs.in.n, weight.shape()[0],
+               output_extent(cs.in.h, cs.kh, params.stride_h, params.pad_h, params.dilation_h),
+               output_extent(cs.in.w, cs.kw, params.stride_w, params.pad_w, params.dilation_w) };
+
+    auto in = input.contiguous();
+    auto w = weight.contiguous();
+    auto b = bias ? bias->contiguous() : Tensor<float>();
+    const float* bias_data = bias ? b.data() : nullptr;
+
+    Tensor<float> result = image_tensor(cs.out, params.layout);
+    bool nchw = params.layout == Layout::NCHW;
+
+    if (nchw && cs.in_per_group == 1) {
+        depthwise_nchw(in.data(), w.data(), bias_data, result.data(), cs, params);
+        return result;
+    }
+    if (!nchw && cs.in_per_group <= DIRECT_MAX_CHANNELS) {
+        direct_nhwc(in.data(), w.data(), bias_data, result.data(), cs, params);
+        return result;
+    }
+
+    // A 1x1 kernel with unit stride and no padding reads the input itself as the GEMM operand.
+    bool pointwise = cs.kh == 1 && cs.kw == 1 && params.stride_h == 1 && params.stride_w == 1 && params.pad_h == 0
+        && params.pad_w == 0;
+    if (nchw)
+        conv_gemm_nchw(in.data(), w.data(), bias_data, result.data(), cs, params, pointwise);
+    else
+        conv_gemm_nhwc(in.data(), w.data(), bias_data, result.data(), cs, params, pointwise);
+    return result;
+}
+
+enum class PoolOp { MAX, AVG };
+
+template <PoolOp Op> static Tensor<float> pool2d(const Tensor<float>& input, const Pool2dParams& p)
+{
+    auto is = image_shape(input, p.layout);
+    if (p.pad_h >= p.kernel_h || p.pad_w >= p.kernel_w)
+        throw std::invalid_argument("Padding must be smaller than the pooling window");
+
+    ImageShape os { is.n, is.c, output_extent(is.h, p.kernel_h, p.stride_h, p.pad_h, 1),
+                    output_extent(is.w, p.kernel_w, p.stride_w, p.pad_w, 1) };
+    auto in = input.contiguous();
+    Tensor<float> result = image_tensor(os, p.layout);
+    const float* src = in.data();
+    float* dst = result.data();
+    constexpr float INIT = Op == PoolOp::MAX ? -std::numeric_limits<float>::infinity() : 0.0f;
+
+    if (p.layout == Layout::NCHW) {
+#pragma omp parallel for num_threads(8) collapse(2)
+        for (size_t n = 0; n < is.n; n++) {
+            for (size_t c = 0; c < is.c; c++) {
+                const float* plane = src + (n * is.c + c) * is.h * is.w;
+                float* out_plane = dst + (n * os.c + c) * os.h * os.w;
+
+                for (size_t oh = 0; oh < os.h; oh++) {
+                    size_t h0 = std::max(oh * p.stride_h, p.pad_h) - p.pad_h;
+                    size_t h1 = std::min(oh * p.stride_h + p.kernel_h - p.pad_h, is.h);
+                    for (size_t ow = 0; ow < os.w; ow++) {
+                        size_t w0 = std::max(ow * p.stride_w, p.pad_w) - p.pad_w;
+                        size_t w1 = std::min(ow * p.stride_w + p.kernel_w - p.pad_w, is.w);
+
+                        float acc = INIT;
+                        for (size_t ih = h0; ih < h1; ih++)
+                            for (size_t iw = w0; iw < w1; iw++)
+                                acc = Op == PoolOp::MAX ? std::max(acc, plane[ih * is.w + iw])
+                                                        : acc + plane[ih * is.w + iw];
+                        out_plane[oh * os.w + ow] = Op == PoolOp::MAX ? acc : acc / (float)((h1 - h0) * (w1 - w0));
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+#pragma omp parallel for num_threads(8) collapse(2)
+    for (size_t n = 0; n < is.n; n++) {
+        for (size_t oh = 0; oh < os.h; oh++) {
+            size_t h0 = std::max(oh * p.stride_h, p.pad_h) - p.pad_h;
+            size_t h1 = std::min(oh * p.stride_h + p.kernel_h - p.pad_h, is.h);
+            for (size_t ow = 0; ow < os.w; ow++) {
+                size_t w0 = std::max(ow * p.stride_w, p.pad_w) - p.pad_w;
+                size_t w1 = std::min(ow * p.stride_w + p.kernel_w - p.pad_w, is.w);
+                float* out_px = dst + ((n * os.h + oh) * os.w + ow) * os.c;
+                std::fill(out_px, out_px + os.c, INIT);
+
+                // Whole channel vectors per window position.
+                for (size_t ih = h0; ih < h1; ih++) {
+                    for (size_t iw = w0; iw < w1; iw++) {
+                        const float* in_px = src + ((n * is.h + ih) * is.w + iw) * is.c;
+                        size_t c = 0;
+                        for (; c + 7 < os.c; c += 8) {
+                            __m256 v = _mm256_loadu_ps(in_px + c), acc = _mm256_loadu_ps(out_px + c);
+                            acc = Op == PoolOp::MAX ? _mm256_max_ps(acc, v) : _mm256_add_ps(acc, v);
+                            _mm256_storeu_ps(out_px + c, acc);
+                        }
+                        for (; c < os.c; c++)
+                            out_px[c] = Op == PoolOp::MAX ? std::max(out_px[c], in_px[c]) : out_px[c] + in_px[c];
+                    }
+                }
+
+                if (Op == PoolOp::AVG) {
+                    float inv = 1.0f / (float)((h1 - h0) * (w1 - w0));
+                    for (size_t c = 0; c < os.c; c++)
+                        out_px[c] *= inv;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+Tensor<float> max_pool2d(const Tensor<float>& input, const Pool2dParams& params)
+{
+    return pool2d<PoolOp::MAX>(input, params);
+}
+
+Tensor<float> avg_pool2d(const Tensor<float>& input, const Pool2dParams& params)
+{
+    return pool2d<PoolOp::AVG>(input, params);
+}
+
+}
@@ -0,0 +1,414 @@
+#include "tensile/einsum.h"
+#include "tensile/gemm.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Tensile {
+
+// Batched products of at most this many multiply-adds each are computed directly instead of through sgemm.
+static constexpr size_t SMALL_PRODUCT = 64;
+
+// Dimensions and strides of a group of axes, walked in row-major order.
+struct AxisGroup {
+    std::vector<size_t> dims;
+    std::vector<size_t> strides;
+
+    [[nodiscard]] size_t count() const
+    {
+        size_t n = 1;
+        for (size_t d : dims)
+            n *= d;
+        return n;
+    }
+
+    // Offset of the `flat`-th position of the group.
+    [[nodiscard]] size_t offset(size_t flat) const
+    {
+        size_t offset = 0;
+        for (size_t d = dims.size(); d-- > 0;) {
+            offset += flat % dims[d] * strides[d];
+            flat /= dims[d];
+        }
+        return offset;
+    }
+
+    // The single stride that walks the whole group as one axis, if there is one. Size-1 axes never matter.
+    [[nodiscard]] bool merged_stride(size_t& stride) const
+    {
+        stride = 0;
+        size_t expected = 0;
+        bool first = true;
+        for (size_t d = dims.size(); d-- > 0;) {
+            if (dims[d] == 1)
+                continue;
+            if (first)
+                stride = strides[d];
+            else if (strides[d] != expected)
+                return false;
+            expected = strides[d] * dims[d];
+            first = false;
+        }
+        return true;
+    }
+};
+
+// An operand part-way through a contraction: a strided view of any rank with one label per axis. Intermediates can
+// have more than MAX_DIM axes, so they are not Tensors. `storage` owns the data of terms computed here.
+struct EinsumTerm {
+    const float* data { nullptr };
+    std::string labels;
+    AxisGroup axes;
+    std::unique_ptr<float[]> storage;
+
+    [[nodiscard]] AxisGroup group(const std::string& wanted) const
+    {
+        AxisGroup g;
+        for (char label : wanted) {
+            size_t d = labels.find(label);
+            g.dims.push_back(axes.dims[d]);
+            g.strides.push_back(axes.strides[d]);
+        }
+        return g;
+    }
+};
+
+static bool has(const std::string& labels, char label) { return labels.find(label) != std::string::npos; }
+
+// Labels of `labels` that satisfy `pred`, in order.
+template <typename Pred> static std::string filter(const std::string& labels, Pred pred)
+{
+    std::string out;
+    for (char label : labels)
+        if (pred(label))
+            out.push_back(label);
+    return out;
+}
+
+static std::pair<std::vector<std::string>, std::string> parse_spec(std::string_view spec, size_t n_operands)
+{
+    std::string s;
+    for (char c : spec)
+        if (c != ' ')
+            s.push_back(c);
+
+    size_t arrow = s.find("->");
+    std::string lhs = s.substr(0, arrow);
+    std::vector<std::string> inputs(1);
+    for (char c : lhs) {
+        if (c == ',')
+            inputs.emplace_back();
+        else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+            inputs.back().push_back(c);
+        else
+            throw std::invalid_argument("einsum: invalid character in spec");
+    }
+    if (inputs.size() != n_operands)
+        throw std::invalid_argument("einsum: spec does not match the number of operands");
+
+    std::array<size_t, 128> counts {};
+    for (const auto& labels : inputs)
+        for (char c : labels)
+            counts[(size_t)c]++;
+
+    std::string output;
+    if (arrow == std::string::npos) {
+        for (size_t c = 0; c < counts.size(); c++)
+            if (counts[c] == 1)
+                output.push_back((char)c);
+        std::sort(output.begin(), output.end());
+    } else {
+        output = s.substr(arrow + 2);
+        for (size_t i = 0; i < output.size(); i++) {
+            char c = output[i];
+            bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+            if (!letter || counts[(size_t)c] == 0 || output.find(c) != i)
+                throw std::invalid_argument("einsum: output labels must be distinct labels of the inputs");
+        }
+    }
+    if (output.size() > MAX_DIM)
+        throw std::invalid_argument("einsum: output has more than 4 dimensions");
+    return { inputs, output };
+}
+
+// A view of `tensor` labelled by `labels`. A repeated label takes the diagonal, whose stride is the sum of the
+// strides of the axes it joins.
+static EinsumTerm make_term(const Tensor<float>& tensor, const std::string& labels, std::array<size_t, 128>& sizes)
+{
+    if (labels.size() != tensor.n_dims())
+        throw std::invalid_argument("einsum: operand has a different number of dimensions than its labels");
+
+    EinsumTerm term;
+    term.data = tensor.data();
+    for (size_t d = 0; d < labels.size(); d++) {
+        char label = labels[d];
+        size_t dim = tensor.shape()[d], stride = tensor.strides()[d];
+        if (sizes[(size_t)label] && sizes[(size_t)label] != dim)
+            throw std::invalid_argument(std::string("einsum: label '") + label + "' has inconsistent sizes");
+        sizes[(size_t)label] = dim;
+
+        size_t seen = term.labels.find(label);
+        if (seen != std::string::npos) {
+            term.axes.strides[seen] += stride;
+            continue;
+        }
+        term.labels.push_back(label);
+        term.axes.dims.push_back(dim);
+        term.axes.strides.push_back(stride);
+    }
+    return term;
+}
+
+static EinsumTerm owned_term(std::string labels, AxisGroup axes)
+{
+    EinsumTerm term;
+    term.labels = std::move(labels);
+    term.storage.reset(new float[axes.count()]);
+    term.data = term.storage.get();
+
+    // Row-major strides.
+    axes.strides.assign(axes.dims.size(), 1);
+    for (size_t d = axes.dims.size(); d-- > 1;)
+        axes.strides[d - 1] = axes.strides[d] * axes.dims[d];
+    term.axes = std::move(axes);
+    return term;
+}
+
+// Contiguous copy of `term` with its axes in the order of `order`.
+static EinsumTerm materialize(const EinsumTerm& term, const std::string& order)
+{
+    AxisGroup src = term.group(order);
+    EinsumTerm result = owned_term(order, src);
+    float* dst = result.storage.get();
+
+    // The innermost axis is walked directly; everything above it is unravelled once per row.
+    size_t cols = src.dims.empty() ? 1 : src.dims.back(), col_stride = src.dims.empty() ? 0 : src.strides.back();
+    AxisGroup rows = src;
+    if (!rows.dims.empty()) {
+        rows.dims.pop_back();
+        rows.strides.pop_back();
+    }
+    size_t n_rows = rows.count();
+
+#pragma omp parallel for num_threads(8) if (n_rows * cols > (1 << 15))
+    for (size_t r = 0; r < n_rows; r++) {
+        const float* row = term.data + rows.offset(r);
+        for (size_t c = 0; c < cols; c++)
+            dst[r * cols + c] = row[c * col_stride];
+    }
+    return result;
+}
+
+// Sums `term` over its axes whose labels are not in `keep`. The kept axes stay in their order.
+static EinsumTerm sum_out(EinsumTerm term, const std::string& keep)
+{
+    std::string kept = filter(term.labels, [&](char l) { return has(keep, l); });
+    if (kept.size() == term.labels.size())
+        return term;
+
+    std::string summed = filter(term.labels, [&](char l) { return !has(keep, l); });
+    AxisGroup out_axes = term.group(kept), sum_axes = term.group(summed);
+    EinsumTerm result = owned_term(kept, out_axes);
+    float* dst = result.storage.get();
+    size_t n_out = out_axes.count(), n_sum = sum_axes.count();
+
+#pragma omp parallel for num_threads(8) if (n_out * n_sum > (1 << 15))
+    for (size_t i = 0; i < n_out; i++) {
+        const float* base = term.data + out_axes.offset(i);
+        float acc = 0;
+        for (size_t j = 0; j < n_sum; j++)
+            acc += base[sum_axes.offset(j)];
+        dst[i] = acc;
+    }
+    return result;
+}
+
+// Single strides over the row and column label groups of a term, if it has them.
+static bool matrix_strides(const EinsumTerm& term, const std::string& rows, const std::string& cols, size_t& row,
+                           size_t& col)
+{
+    return term.group(rows).merged_stride(row) && term.group(cols).merged_stride(col);
+}
+
+// Contracts two terms into one holding the labels of `keep` they carry, laid out as [batch, M, N]:
+//   batch: in both and kept, M: only in a, N: only in b, K (summed by the GEMM): in both and not kept.
+// Each batch entry is one sgemm of [M, K] by [K, N], where M, K and N are each walked with a single stride.
+static EinsumTerm contract(EinsumTerm a, EinsumTerm b, const std::string& keep)
+{
+    a = sum_out(std::move(a), keep + b.labels);
+    b = sum_out(std::move(b), keep + a.labels);
+
+    std::string batch = filter(a.labels, [&](char l) { return has(b.labels, l) && has(keep, l); });
+    std::string k_labels = filter(a.labels, [&](char l) { return has(b.labels, l) && !has(keep, l); });
+    std::string m_labels = filter(a.labels, [&](char l) { return !has(b.labels, l); });
+    std::string n_labels = filter(b.labels, [&](char l) { return !has(a.labels, l); });
+
+    size_t a_row, a_col, b_row, b_col;
+    if (!matrix_strides(a, m_labels, k_labels, a_row, a_col)) {
+        a = materialize(a, batch + m_labels + k_labels);
+        matrix_strides(a, m_labels, k_labels, a_row, a_col);
+    }
+    if (!matrix_strides(b, k_labels, n_labels, b_row, b_col)) {
+        b = materialize(b, batch + k_labels + n_labels);
+        matrix_strides(b, k_labels, n_labels, b_row, b_col);
+    }
+
+    AxisGroup a_batch = a.group(batch), b_batch = b.group(batch);
+    AxisGroup m_axes = a.group(m_labels), n_axes = b.group(n_labels);
+    size_t m = m_axes.count(), k = a.group(k_labels).count(), n = n_axes.count();
+    size_t n_batch = a_batch.count();
+
+    AxisGroup out_axes = a_batch;
+    out_axes.dims.insert(out_axes.dims.end(), m_axes.dims.begin(), m_axes.dims.end());
+    out_axes.dims.insert(out_axes.dims.end(), n_axes.dims.begin(), n_axes.dims.end());
+    EinsumTerm result = owned_term(batch + m_labels + n_labels, out_axes);
+    float* c = result.storage.get();
+
+    // Products this small (elementwise specs, where every label is a batch label, are 1x1x1) and products with nothing
+    // to sum (K = 1, as in broadcasts and outer products) cost less than sgemm's packing and blocking setup, so they
+    // are multiplied directly.
+    if (k == 1 || m * n * k <= SMALL_PRODUCT) {
+#pragma omp parallel for num_threads(8) if (n_batch * m * n * k > (1 << 15))
+        for (size_t i = 0; i < n_batch; i++) {
+            const float* a_mat = a.data + a_batch.offset(i);
+            const float* b_mat = b.data + b_batch.offset(i);
+            float* c_mat = c + i * m * n;
+            for (size_t r = 0; r < m; r++) {
+                for (size_t col = 0; col < n; col++) {
+                    float acc = 0;
+                    for (size_t p = 0; p < k; p++)
+                        acc += a_mat[r * a_row + p * a_col] * b_mat[p * b_row + col * b_col];
+                    c_mat[r * n + col] = acc;
+                }
+            }
+        }
+        return result;
+    }
+
+    // Many small products are spread over threads; large ones are parallel inside sgemm.
+    bool parallel_batches = n_batch >= 8 && m * n * k <= (1 << 15);
+
+#pragma omp parallel for num_threads(8) if (parallel_batches)
+    for (size_t i = 0; i < n_batch; i++) {
+        MatrixRef a_mat { a.data + a_batch.offset(i), a_row, a_col };
+        MatrixRef b_mat { b.data + b_batch.offset(i), b_row, b_col };
+        sgemm(m, n, k, a_mat, b_mat, c + i * m * n, n, Epilogue {});
+    }
+    return result;
+}
+
+static size_t label_product(const std::string& labels, const std::array<size_t, 128>& sizes)
+{
+    size_t n = 1;
+    for (char l : labels)
+        n *= sizes[(size_t)l];
+    return n;
+}
+
+Tensor<float> einsum(std::string_view spec, const std::vector<Tensor<float>>& operands)
+{
+    if (operands.empty())
+        throw std::invalid_argument("einsum: no operands");
+
+    auto [inputs, output] = parse_spec(spec, operands.size());
+    std::array<size_t, 128> sizes {};
+    std::vector<EinsumTerm> terms;
+    for (size_t i = 0; i < operands.size(); i++)
+        terms.push_back(make_term(operands[i], inputs[i], sizes));
+
+    // Labels still needed once terms i and j have been merged: the output and every other term.
+    auto needed_besides = [&](size_t i, size_t j) {
+        std::string keep = output;
+        for (size_t t = 0; t < terms.size(); t++)
+            if (t != i && t != j)
+                keep += terms[t].labels;
+        return keep;
+    };
+
+    while (terms.size() > 1) {
+        size_t best_i = 0, best_j = 1;
+        std::pair<size_t, size_t> best_cost { std::numeric_limits<size_t>::max(), 0 };
+        for (size_t i = 0; i < terms.size(); i++) {
+            for (size_t j = i + 1; j < terms.size(); j++) {
+                std::string keep = needed_besides(i, j);
+                std::string both = terms[i].labels + filter(terms[j].labels, [&](char l) {
+                    return !has(terms[i].labels, l);
+                });
+                std::string kept = filter(both, [&](char l) { return has(keep, l); });
+                std::pair<size_t, size_t> cost { label_product(both, sizes), label_product(kept, sizes) };
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_i = i;
+                    best_j = j;
+                }
+            }
+        }
+
+        std::string keep = needed_besides(best_i, best_j);
+        EinsumTerm merged = contract(std::move(terms[best_i]), std::move(terms[best_j]), keep);
+        terms.erase(terms.begin() + (std::ptrdiff_t)best_j);
+        terms.erase(terms.begin() + (std::ptrdiff_t)best_i);
+        terms.push_back(std::move(merged));
+    }
+
+    EinsumTerm last = sum_out(std::move(terms[0]), output);
+    if (!last.storage || last.labels != output)
+        last = materialize(last, output);
+
+    std::vector<size_t> shape = last.axes.dims;
+    if (shape.empty())
+        shape.push_back(1);
+    return Tensor<float>(last.storage.release(), shape);
+}
+
+Tensor<float> tensordot(const Tensor<float>& a, const Tensor<float>& b, const std::vector<size_t>& a_axes,
+                        const std::vector<size_t>& b_axes)
+{
+    if (a_axes.size() != b_axes.size())
+        throw std::invalid_argument("tensordot: axis lists have different lengths");
+
+    std::string a_labels, b_labels(b.n_dims(), ' ');
+    for (size_t d = 0; d < a.n_dims(); d++)
+        a_labels.push_back((char)('a' + d));
+    for (size_t i = 0; i < a_axes.size(); i++) {
+        if (a_axes[i] >= a.n_dims() || b_axes[i] >= b.n_dims())
+            throw std::invalid_argument("Axis out of bounds");
+        if (b_labels[b_axes[i]] != ' ' || std::count(a_axes.begin(), a_axes.end(), a_axes[i]) > 1)
+            throw std::invalid_argument("tensordot: repeated axis");
+        b_labels[b_axes[i]] = a_labels[a_axes[i]];
+    }
+
+    std::string output;
+    for (size_t d = 0; d < a.n_dims(); d++)
+        if (std::find(a_axes.begin(), a_axes.end(), d) == a_axes.end())
+            output.push_back(a_labels[d]);
+    for (size_t d = 0; d < b.n_dims(); d++) {
+        if (b_labels[d] == ' ') {
+            b_labels[d] = (char)('A' + d);
+            output.push_back(b_labels[d]);
+        }
+    }
+
+    return einsum(a_labels + "," + b_labels + "->" + output, a, b);
+}
+
+Tensor<float> tensordot(const Tensor<float>& a, const Tensor<float>& b, size_t n)
+{
+    if (n > a.n_dims() || n > b.n_dims())
+        throw std::invalid_argument("tensordot: more contracted axes than dimensions");
+
+    std::vector<size_t> a_axes, b_axes;
+    for (size_t i = 0; i < n; i++) {
+        a_axes.push_back(a.n_dims() - n + i);
+        b_axes.push_back(i);
+    }
+    return tensordot(a, b, a_axes, b_axes);
+}
+
+}
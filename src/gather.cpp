@@ -0,0 +1,83 @@
+#include "tensile/gather.h"
+
+#include <algorithm>
+#include <immintrin.h>
+
+namespace Tensile {
+
+static constexpr size_t TAKE_CHUNK = 1 << 14;
+static constexpr size_t PARALLEL_WORK = 1 << 15;
+
+// out[i] = x[index[i]] with eight-wide gathers.
+static void take_block(const float* x, const int32_t* index, size_t n, float* out)
+{
+    size_t i = 0;
+    for (; i + 7 < n; i += 8) {
+        __m256i vindex = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + i));
+        _mm256_storeu_ps(out + i, _mm256_i32gather_ps(x, vindex, 4));
+    }
+    for (; i < n; i++)
+        out[i] = x[index[i]];
+}
+
+void take_f32(const float* x, const int32_t* index, size_t n, float* out)
+{
+    size_t n_chunks = (n + TAKE_CHUNK - 1) / TAKE_CHUNK;
+
+#pragma omp parallel for num_threads(8) if (n > PARALLEL_WORK)
+    for (size_t c = 0; c < n_chunks; c++) {
+        size_t start = c * TAKE_CHUNK;
+        take_block(x, index + start, std::min(TAKE_CHUNK, n - start), out + start);
+    }
+}
+
+// One row of gather_f32 with inner > 1: out[k] = line[index[k] * inner + k].
+static void gather_row(const float* line, const int32_t* index, size_t inner, float* out)
+{
+    __m256i vinner = _mm256_set1_epi32((int)inner);
+    __m256i k_offsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    size_t k = 0;
+    for (; k + 7 < inner; k += 8) {
+        __m256i vindex = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + k));
+        __m256i offsets = _mm256_add_epi32(_mm256_mullo_epi32(vindex, vinner), k_offsets);
+        _mm256_storeu_ps(out + k, _mm256_i32gather_ps(line + k, offsets, 4));
+    }
+    for (; k < inner; k++)
+        out[k] = line[(size_t)index[k] * inner + k];
+}
+
+void gather_f32(const float* x, size_t outer, size_t len, size_t inner, const int32_t* index, size_t n_index,
+                float* out)
+{
+    bool parallel = outer * n_index * inner > PARALLEL_WORK;
+
+    // Along the last axis every row is a plain take from its own line.
+    if (inner == 1) {
+#pragma omp parallel for num_threads(8) if (parallel)
+        for (size_t o = 0; o < outer; o++)
+            take_block(x + o * len, index + o * n_index, n_index, out + o * n_index);
+        return;
+    }
+
+    // Lane offsets index * inner + k are relative to the row start, so they stay in 32 bits unless a single
+    // [len, inner] slice does not.
+    bool fits = len * inner < (size_t)INT32_MAX;
+
+#pragma omp parallel for num_threads(8) collapse(2) if (parallel)
+    for (size_t o = 0; o < outer; o++) {
+        for (size_t j = 0; j < n_index; j++) {
+            const float* line = x + o * len * inner;
+            const int32_t* row_index = index + (o * n_index + j) * inner;
+            float* row_out = out + (o * n_index + j) * inner;
+            if (fits) {
+                gather_row(line, row_index, inner, row_out);
+            } else {
+                for (size_t k = 0; k < inner; k++)
+                    row_out[k] = line[(size_t)row_index[k] * inner + k];
+            }
+        }
+    }
+}
+
+}
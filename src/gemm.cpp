@@ -0,0 +1,470 @@
+#include "tensile/gemm.h"
+#include "tensile/simd_math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+#include <omp.h>
+#include <stdexcept>
+#include <vector>
+
+namespace Tensile {
+
+// Register tile of the micro-kernel: 6 rows x 16 columns keeps 12 accumulators, 2 B vectors and 1 A broadcast in the
+// 16 ymm registers. The cache blocks around it come from GemmConfig.
+static constexpr size_t MR = GEMM_MR;
+static constexpr size_t NR = GEMM_NR;
+
+static __m256 sigmoid_ps(__m256 x)
+{
+    __m256 one = _mm256_set1_ps(1.0f);
+    return _mm256_div_ps(one, _mm256_add_ps(one, exp_ps(_mm256_sub_ps(_mm256_setzero_ps(), x))));
+}
+
+// GELU with the tanh approximation, rewritten as x * sigmoid(2 * sqrt(2 / pi) * (x + 0.044715 x^3)).
+static constexpr float GELU_SCALE = 1.5957691216f;
+static constexpr float GELU_CUBIC = 0.044715f;
+
+static __m256 activate_ps(__m256 x, Activation activation)
+{
+    switch (activation) {
+    case Activation::RELU:
+        return _mm256_max_ps(x, _mm256_setzero_ps());
+    case Activation::SIGMOID:
+        return sigmoid_ps(x);
+    case Activation::GELU: {
+        __m256 inner = _mm256_fmadd_ps(_mm256_mul_ps(_mm256_set1_ps(GELU_CUBIC), x), _mm256_mul_ps(x, x), x);
+        return _mm256_mul_ps(x, sigmoid_ps(_mm256_mul_ps(_mm256_set1_ps(GELU_SCALE), inner)));
+    }
+    default:
+        return x;
+    }
+}
+
+static float activate(float x, Activation activation)
+{
+    switch (activation) {
+    case Activation::RELU:
+        return std::max(x, 0.0f);
+    case Activation::SIGMOID:
+        return 1.0f / (1.0f + std::exp(-x));
+    case Activation::GELU:
+        return x / (1.0f + std::exp(-GELU_SCALE * (x + GELU_CUBIC * x * x * x)));
+    default:
+        return x;
+    }
+}
+
+// Copies rows [0, mc) x columns [0, kc) of A into MR-row panels, column-major inside each panel, zero-padding the
+// last panel.
+static void pack_a(MatrixRef a, size_t mc, size_t kc, float* dst)
+{
+    for (size_t ir = 0; ir < mc; ir += MR) {
+        size_t mr = std::min(MR, mc - ir);
+        for (size_t p = 0; p < kc; p++) {
+            const float* src = a.data + ir * a.row_stride + p * a.col_stride;
+            for (size_t r = 0; r < mr; r++)
+                dst[r] = src[r * a.row_stride];
+            std::fill(dst + mr, dst + MR, 0.0f);
+            dst += MR;
+        }
+    }
+}
+
+// Copies one KC x NR panel of B, row-major inside the panel, zero-padding missing columns.
+static void pack_b_panel(MatrixRef b, size_t kc, size_t nr, float* dst)
+{
+    for (size_t p = 0; p < kc; p++) {
+        const float* src = b.data + p * b.row_stride;
+        if (b.col_stride == 1 && nr == NR) {
+            std::copy(src, src + NR, dst);
+        } else {
+            for (size_t j = 0; j < nr; j++)
+                dst[j] = src[j * b.col_stride];
+            std::fill(dst + nr, dst + NR, 0.0f);
+        }
+        dst += NR;
+    }
+}
+
+static __m256 load_bias(MatrixRef bias, size_t i, size_t j)
+{
+    const float* row = bias.data + i * bias.row_stride + j * bias.col_stride;
+    if (bias.col_stride == 0)
+        return _mm256_set1_ps(*row);
+    if (bias.col_stride == 1)
+        return _mm256_loadu_ps(row);
+
+    alignas(32) float values[8];
+    for (size_t l = 0; l < 8; l++)
+        values[l] = row[l * bias.col_stride];
+    return _mm256_load_ps(values);
+}
+
+struct TileStore {
+    const Epilogue& epilogue;
+    MatrixRef bias;
+    bool first; // first K block: C is initialized rather than accumulated into
+    bool last;  // last K block: bias and activation are applied
+};
+
+// Combines a tile's accumulators with C. Full tiles are finished in registers; edge tiles go through a scalar loop.
+static void store_tile(__m256 acc[MR][2], float* c, size_t ldc, size_t i0, size_t j0, size_t mr, size_t nr,
+                       const TileStore& store)
+{
+    const Epilogue& ep = store.epilogue;
+
+    if (mr == MR && nr == NR) {
+        __m256 alpha = _mm256_set1_ps(ep.alpha), beta = _mm256_set1_ps(ep.beta);
+        for (size_t r = 0; r < MR; r++) {
+            float* c_row = c + r * ldc;
+            for (size_t h = 0; h < 2; h++) {
+                __m256 value = _mm256_mul_ps(acc[r][h], alpha);
+                if (!store.first)
+                    value = _mm256_add_ps(value, _mm256_loadu_ps(c_row + h * 8));
+                else if (ep.beta != 0)
+                    value = _mm256_fmadd_ps(beta, _mm256_loadu_ps(c_row + h * 8), value);
+
+                if (store.last) {
+                    if (store.bias.data)
+                        value = _mm256_add_ps(value, load_bias(store.bias, i0 + r, j0 + h * 8));
+                    value = activate_ps(value, ep.activation);
+                }
+                _mm256_storeu_ps(c_row + h * 8, value);
+            }
+        }
+        return;
+    }
+
+    alignas(32) float tile[MR][NR];
+    for (size_t r = 0; r < MR; r++) {
+        _mm256_store_ps(tile[r], acc[r][0]);
+        _mm256_store_ps(tile[r] + 8, acc[r][1]);
+    }
+
+    for (size_t r = 0; r < mr; r++) {
+        float* c_row = c + r * ldc;
+        for (size_t j = 0; j < nr; j++) {
+            float value = tile[r][j] * ep.alpha;
+            if (!store.first)
+                value += c_row[j];
+            else if (ep.beta != 0)
+                value += ep.beta * c_row[j];
+
+            if (store.last) {
+                if (store.bias.data)
+                    value += store.bias.data[(i0 + r) * store.bias.row_stride + (j0 + j) * store.bias.col_stride];
+                value = activate(value, ep.activation);
+            }
+            c_row[j] = value;
+        }
+    }
+}
+
+// acc = A_panel[MR, kc] · B_panel[kc, NR] from packed panels.
+static void micro_kernel(size_t kc, const float* a, const float* b, __m256 acc[MR][2])
+{
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+    __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+    for (size_t p = 0; p < kc; p++) {
+        __m256 b0 = _mm256_loadu_ps(b), b1 = _mm256_loadu_ps(b + 8);
+        __m256 av;
+        av = _mm256_broadcast_ss(a + 0);
+        c00 = _mm256_fmadd_ps(av, b0, c00);
+        c01 = _mm256_fmadd_ps(av, b1, c01);
+        av = _mm256_broadcast_ss(a + 1);
+        c10 = _mm256_fmadd_ps(av, b0, c10);
+        c11 = _mm256_fmadd_ps(av, b1, c11);
+        av = _mm256_broadcast_ss(a + 2);
+        c20 = _mm256_fmadd_ps(av, b0, c20);
+        c21 = _mm256_fmadd_ps(av, b1, c21);
+        av = _mm256_broadcast_ss(a + 3);
+        c30 = _mm256_fmadd_ps(av, b0, c30);
+        c31 = _mm256_fmadd_ps(av, b1, c31);
+        av = _mm256_broadcast_ss(a + 4);
+        c40 = _mm256_fmadd_ps(av, b0, c40);
+        c41 = _mm256_fmadd_ps(av, b1, c41);
+        av = _mm256_broadcast_ss(a + 5);
+        c50 = _mm256_fmadd_ps(av, b0, c50);
+        c51 = _mm256_fmadd_ps(av, b1, c51);
+        a += MR;
+        b += NR;
+    }
+
+    acc[0][0] = c00, acc[0][1] = c01;
+    acc[1][0] = c10, acc[1][1] = c11;
+    acc[2][0] = c20, acc[2][1] = c21;
+    acc[3][0] = c30, acc[3][1] = c31;
+    acc[4][0] = c40, acc[4][1] = c41;
+    acc[5][0] = c50, acc[5][1] = c51;
+}
+
+void sgemm(size_t m, size_t n, size_t k, MatrixRef a, MatrixRef b, float* c, size_t ldc, const Epilogue& epilogue,
+           MatrixRef bias)
+{
+    sgemm_with(gemm_config(m, n, k), m, n, k, a, b, c, ldc, epilogue, bias);
+}
+
+static size_t round_up(size_t x, size_t to) { return (x + to - 1) / to * to; }
+
+// The GEMM itself. B is read from `packed` when it is given, and packed block by block from `b` otherwise.
+static void gemm_blocked(const GemmConfig& config, size_t m, size_t n, size_t k, MatrixRef a, MatrixRef b,
+                         const PackedMatrix* packed, float* c, size_t ldc, const Epilogue& epilogue, MatrixRef bias)
+{
+    const size_t MC = config.mc, KC = config.kc, NC = config.nc, PANELS_PER_TASK = config.panels_per_task;
+    if (!config.valid())
+        throw std::invalid_argument("Invalid GEMM blocking");
+
+    if (m == 0 || n == 0)
+        return;
+
+    if (k == 0) {
+        for (size_t i = 0; i < m; i++)
+            for (size_t j = 0; j < n; j++) {
+                float value = epilogue.beta != 0 ? epilogue.beta * c[i * ldc + j] : 0.0f;
+                if (bias.data)
+                    value += bias.data[i * bias.row_stride + j * bias.col_stride];
+                c[i * ldc + j] = activate(value, epilogue.activation);
+            }
+        return;
+    }
+
+    size_t m_panels = (m + MR - 1) / MR;
+    std::vector<float> packed_a(m_panels * MR * KC);
+    std::vector<float> packed_b(packed ? 0 : round_up(std::min(n, NC), NR) * KC);
+    bool parallel = m * n * k > (1 << 15);
+
+    for (size_t jc = 0; jc < n; jc += NC) {
+        size_t nc = std::min(NC, n - jc);
+        size_t n_panels = (nc + NR - 1) / NR;
+
+        for (size_t pc = 0; pc < k; pc += KC) {
+            size_t kc = std::min(KC, k - pc);
+            TileStore store { epilogue, bias, pc == 0, pc + kc == k };
+            const float* b_block = packed ? packed->block(pc, jc) : packed_b.data();
+
+#pragma omp parallel num_threads(config.threads) if (parallel)
+            {
+#pragma omp for schedule(static) nowait
+                for (size_t jp = 0; jp < (packed ? 0 : n_panels); jp++) {
+                    MatrixRef panel { b.data + pc * b.row_stride + (jc + jp * NR) * b.col_stride, b.row_stride,
+                                      b.col_stride };
+                    pack_b_panel(panel, kc, std::min(NR, nc - jp * NR), packed_b.data() + jp * NR * kc);
+                }
+
+#pragma omp for schedule(static)
+                for (size_t ic = 0; ic < m; ic += MC) {
+                    MatrixRef block { a.data + ic * a.row_stride + pc * a.col_stride, a.row_stride, a.col_stride };
+                    pack_a(block, std::min(MC, m - ic), kc, packed_a.data() + ic * kc);
+                }
+
+                size_t m_blocks = (m + MC - 1) / MC;
+                size_t n_tasks = (n_panels + PANELS_PER_TASK - 1) / PANELS_PER_TASK;
+
+#pragma omp for schedule(static)
+                for (size_t task = 0; task < m_blocks * n_tasks; task++) {
+                    size_t ic = task / n_tasks * MC, mc = std::min(MC, m - ic);
+                    size_t jp_end = std::min(n_panels, (task % n_tasks + 1) * PANELS_PER_TASK);
+
+                    for (size_t jp = task % n_tasks * PANELS_PER_TASK; jp < jp_end; jp++) {
+                        size_t j0 = jc + jp * NR, nr = std::min(NR, nc - jp * NR);
+                        const float* b_panel = b_block + jp * NR * kc;
+
+                        for (size_t ir = 0; ir < mc; ir += MR) {
+                            size_t i0 = ic + ir;
+                            __m256 acc[MR][2];
+                            micro_kernel(kc, packed_a.data() + i0 * kc, b_panel, acc);
+                            store_tile(acc, c + i0 * ldc + j0, ldc, i0, j0, std::min(MR, mc - ir), nr, store);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void sgemm_with(const GemmConfig& config, size_t m, size_t n, size_t k, MatrixRef a, MatrixRef b, float* c,
+                size_t ldc, const Epilogue& epilogue, MatrixRef bias)
+{
+    gemm_blocked(config, m, n, k, a, b, nullptr, c, ldc, epilogue, bias);
+}
+
+PackedMatrix::PackedMatrix(const Tensor<float>& b, size_t expected_m)
+    : PackedMatrix(b, gemm_config(expected_m, b.n_dims() == 2 ? b.shape()[1] : 0, b.shape()[0]))
+{
+}
+
+PackedMatrix::PackedMatrix(const Tensor<float>& b, const GemmConfig& config)
+    : config_(config)
+{
+    if (b.n_dims() != 2)
+        throw std::invalid_argument("Only 2D matrices can be packed");
+    if (!config.valid())
+        throw std::invalid_argument("Invalid GEMM blocking");
+
+    k_ = b.shape()[0];
+    n_ = b.shape()[1];
+    panels_.resize(round_up(n_, NR) * k_);
+    MatrixRef src { b.data(), b.strides()[0], b.strides()[1] };
+
+    // Every column block is round_up(nc, NR) * k floats, and its KC-row blocks follow each other inside it.
+    size_t n_panels = round_up(n_, NR) / NR;
+#pragma omp parallel for num_threads(config.threads) if (k_ * n_ > (1 << 15))
+    for (size_t p = 0; p < n_panels; p++) {
+        size_t j = p * NR, jc = j / config.nc * config.nc;
+        for (size_t pc = 0; pc < k_; pc += config.kc) {
+            size_t kc = std::min(config.kc, k_ - pc);
+            MatrixRef panel { src.data + pc * src.row_stride + j * src.col_stride, src.row_stride, src.col_stride };
+            pack_b_panel(panel, kc, std::min(NR, n_ - j), panels_.data() + offset(pc, jc) + (j - jc) * kc);
+        }
+    }
+}
+
+size_t PackedMatrix::offset(size_t pc, size_t jc) const
+{
+    return jc * k_ + round_up(std::min(config_.nc, n_ - jc), NR) * pc;
+}
+
+const float* PackedMatrix::block(size_t pc, size_t jc) const { return panels_.data() + offset(pc, jc); }
+
+Tensor<float> PackedMatrix::unpack() const
+{
+    auto result = Tensor<float>::empty({ k_, n_ });
+    float* dst = result.data();
+    for (size_t jc = 0; jc < n_; jc += config_.nc) {
+        for (size_t pc = 0; pc < k_; pc += config_.kc) {
+            size_t kc = std::min(config_.kc, k_ - pc);
+            const float* src = block(pc, jc);
+            for (size_t j = jc; j < std::min(n_, jc + config_.nc); j++) {
+                const float* panel = src + (j - jc) / NR * NR * kc + (j - jc) % NR;
+                for (size_t p = 0; p < kc; p++)
+                    dst[(pc + p) * n_ + j] = panel[p * NR];
+            }
+        }
+    }
+    return result;
+}
+
+void sgemm_packed(size_t m, MatrixRef a, const PackedMatrix& b, float* c, size_t ldc, const Epilogue& epilogue,
+                  MatrixRef bias)
+{
+    GemmConfig config = gemm_config(m, b.cols(), b.rows());
+    config.kc = b.config().kc;
+    config.nc = b.config().nc;
+    gemm_blocked(config, m, b.cols(), b.rows(), a, {}, &b, c, ldc, epilogue, bias);
+}
+
+static MatrixRef matrix_ref(const Tensor<float>& tensor)
+{
+    return { tensor.data(), tensor.strides()[0], tensor.strides()[1] };
+}
+
+// Strides that broadcast `bias` to [m, n], zero along its size-1 (or missing) dimensions.
+static MatrixRef bias_ref(const Tensor<float>& bias, size_t m, size_t n)
+{
+    auto shape = bias.shape();
+    auto strides = bias.strides();
+
+    if (bias.n_dims() == 1 && shape[0] == n)
+        return { bias.data(), 0, strides[0] };
+    if (bias.n_dims() == 2 && (shape[0] == m || shape[0] == 1) && (shape[1] == n || shape[1] == 1))
+        return { bias.data(), shape[0] == 1 ? 0 : strides[0], shape[1] == 1 ? 0 : strides[1] };
+
+    throw std::invalid_argument("Bias is not broadcastable to the matmul output");
+}
+
+static void check_operands(const Tensor<float>& a, const Tensor<float>& b)
+{
+    if (a.n_dims() != 2 || b.n_dims() != 2 || a.shape()[1] != b.shape()[0])
+        throw std::invalid_argument("Incompatible shapes for matrix multiplication");
+}
+
+static void check_output(const Tensor<float>& c, size_t m, size_t n)
+{
+    if (c.n_dims() != 2 || c.shape()[0] != m || c.shape()[1] != n)
+        throw std::invalid_argument("Output shape does not match the matmul output");
+    if (c.strides()[1] != 1 && n > 1)
+        throw std::invalid_argument("Output rows must be contiguous");
+}
+
+void matmul_fused_into(const Tensor<float>& a, const Tensor<float>& b, const Tensor<float>* bias, Tensor<float>& c,
+                       const Epilogue& epilogue)
+{
+    check_operands(a, b);
+    size_t m = a.shape()[0], k = a.shape()[1], n = b.shape()[1];
+    check_output(c, m, n);
+
+    sgemm(m, n, k, matrix_ref(a), matrix_ref(b), c.data(), c.strides()[0], epilogue,
+          bias ? bias_ref(*bias, m, n) : MatrixRef {});
+}
+
+Tensor<float> matmul_fused(const Tensor<float>& a, const Tensor<float>& b, const Epilogue& epilogue)
+{
+    check_operands(a, b);
+    size_t m = a.shape()[0], n = b.shape()[1];
+
+    Tensor<float> result(new float[m * n], { m, n });
+    Epilogue store_only = epilogue;
+    store_only.beta = 0;
+    matmul_fused_into(a, b, nullptr, result, store_only);
+    return result;
+}
+
+Tensor<float> matmul_fused(const Tensor<float>& a, const Tensor<float>& b, const Tensor<float>& bias,
+                           const Epilogue& epilogue)
+{
+    check_operands(a, b);
+    size_t m = a.shape()[0], n = b.shape()[1];
+
+    Tensor<float> result(new float[m * n], { m, n });
+    Epilogue store_only = epilogue;
+    store_only.beta = 0;
+    matmul_fused_into(a, b, &bias, result, store_only);
+    return result;
+}
+
+static void check_operands(const Tensor<float>& a, const PackedMatrix& b)
+{
+    if (a.n_dims() != 2 || a.shape()[1] != b.rows())
+        throw std::invalid_argument("Incompatible shapes for matrix multiplication");
+}
+
+void matmul_fused_into(const Tensor<float>& a, const PackedMatrix& b, const Tensor<float>* bias, Tensor<float>& c,
+                       const Epilogue& epilogue)
+{
+    check_operands(a, b);
+    size_t m = a.shape()[0], n = b.cols();
+    check_output(c, m, n);
+
+    sgemm_packed(m, matrix_ref(a), b, c.data(), c.strides()[0], epilogue, bias ? bias_ref(*bias, m, n) : MatrixRef {});
+}
+
+Tensor<float> matmul_fused(const Tensor<float>& a, const PackedMatrix& b, const Epilogue& epilogue)
+{
+    check_operands(a, b);
+
+    Tensor<float> result(new float[a.shape()[0] * b.cols()], { a.shape()[0], b.cols() });
+    Epilogue store_only = epilogue;
+    store_only.beta = 0;
+    matmul_fused_into(a, b, nullptr, result, store_only);
+    return result;
+}
+
+Tensor<float> matmul_fused(const Tensor<float>& a, const PackedMatrix& b, const Tensor<float>& bias,
+                           const Epilogue& epilogue)
+{
+    check_operands(a, b);
+
+    Tensor<float> result(new float[a.shape()[0] * b.cols()], { a.shape()[0], b.cols() });
+    Epilogue store_only = epilogue;
+    store_only.beta = 0;
+    matmul_fused_into(a, b, &bias, result, store_only);
+    return result;
+}
+
+}
@@ -0,0 +1,266 @@
+#include "tensile/gemm.h"
+#include "tensile/gemm_tune.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cpuid.h>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <omp.h>
+#include <shared_mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace Tensile {
+
+using BucketTable = std::map<ShapeBucket, GemmConfig>;
+
+// Every recorded configuration by CPU model, for this CPU and for any other found in a cache file.
+static std::map<std::string, BucketTable, std::less<>> tuning_table;
+static std::shared_mutex table_mutex;
+static std::once_flag cache_loaded;
+// Held while a bucket is being tuned, so that concurrent callers do not benchmark over each other.
+static std::mutex tuning_mutex;
+
+ShapeBucket shape_bucket(size_t m, size_t n, size_t k)
+{
+    auto bucket = [](size_t x) { return (uint8_t)std::bit_width(std::max(x, (size_t)1) - 1); };
+    return { bucket(m), bucket(n), bucket(k) };
+}
+
+const std::string& cpu_model()
+{
+    static const std::string model = [] {
+        unsigned regs[12] = {};
+        if (__get_cpuid_max(0x80000000, nullptr) < 0x80000004)
+            return std::string("unknown");
+        for (unsigned i = 0; i < 3; i++)
+            __get_cpuid(0x80000002 + i, &regs[4 * i], &regs[4 * i + 1], &regs[4 * i + 2], &regs[4 * i + 3]);
+
+        char brand[sizeof(regs) + 1] = {};
+        std::memcpy(brand, regs, sizeof(regs));
+        std::string name(brand);
+        name.erase(0, name.find_first_not_of(' '));
+        name.erase(name.find_last_not_of(' ') + 1);
+        std::replace(name.begin(), name.end(), '\t', ' ');
+        return name.empty() ? std::string("unknown") : name;
+    }();
+    return model;
+}
+
+std::string gemm_cache_path()
+{
+    if (const char* path = std::getenv("TENSILE_GEMM_CACHE"))
+        return path;
+    if (const char* home = std::getenv("HOME"))
+        return std::string(home) + "/.cache/tensile/gemm_tuning.txt";
+    return "gemm_tuning.txt";
+}
+
+static void ensure_loaded()
+{
+    std::call_once(cache_loaded, [] { load_gemm_tuning(gemm_cache_path()); });
+}
+
+static bool autotune_enabled()
+{
+    const char* value = std::getenv("TENSILE_GEMM_AUTOTUNE");
+    return value && *value && std::strcmp(value, "0") != 0;
+}
+
+// The recorded configuration for the bucket, or the defaults. Runs on every sgemm call, so it looks up this CPU's
+// entries by reference instead of building a key around a copy of the brand string.
+static GemmConfig recorded_config(size_t m, size_t n, size_t k, bool& found)
+{
+    std::shared_lock lock(table_mutex);
+    found = false;
+    auto cpu = tuning_table.find(cpu_model());
+    if (cpu == tuning_table.end())
+        return GemmConfig {};
+    auto it = cpu->second.find(shape_bucket(m, n, k));
+    found = it != cpu->second.end();
+    return found ? it->second : GemmConfig {};
+}
+
+GemmConfig gemm_config(size_t m, size_t n, size_t k)
+{
+    ensure_loaded();
+
+    bool found;
+    GemmConfig config = recorded_config(m, n, k, found);
+    if (found || !autotune_enabled() || omp_in_parallel() || m == 0 || n == 0 || k == 0)
+        return config;
+
+    std::lock_guard guard(tuning_mutex);
+    config = recorded_config(m, n, k, found);
+    if (found)
+        return config;
+
+    config = tune_gemm(m, n, k);
+    save_gemm_tuning(gemm_cache_path());
+    return config;
+}
+
+void set_gemm_config(size_t m, size_t n, size_t k, const GemmConfig& config)
+{
+    if (!config.valid())
+        throw std::invalid_argument("Invalid GEMM blocking");
+
+    std::unique_lock lock(table_mutex);
+    tuning_table[cpu_model()][shape_bucket(m, n, k)] = config;
+}
+
+void clear_gemm_tuning()
+{
+    std::unique_lock lock(table_mutex);
+    tuning_table.clear();
+}
+
+GemmConfig tune_gemm(size_t m, size_t n, size_t k)
+{
+    if (m == 0 || n == 0 || k == 0)
+        throw std::invalid_argument("Cannot tune an empty GEMM");
+    ensure_loaded();
+
+    std::vector<float> a(m * k), b(k * n), c(m * n);
+    for (size_t i = 0; i < a.size(); i++)
+        a[i] = 0.05f * (float)((int)(i * 7 % 17) - 8);
+    for (size_t i = 0; i < b.size(); i++)
+        b[i] = 0.05f * (float)((int)(i * 5 % 13) - 6);
+
+    using Clock = std::chrono::steady_clock;
+    auto run = [&](const GemmConfig& config) {
+        auto start = Clock::now();
+        sgemm_with(config, m, n, k, { a.data(), k, 1 }, { b.data(), n, 1 }, c.data(), n, Epilogue {});
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+
+    // Best of a few runs, as many as fit in about 50 ms.
+    auto measure = [&](const GemmConfig& config) {
+        double best = run(config);
+        size_t reps = std::clamp((size_t)(0.05 / std::max(best, 1e-9)), (size_t)1, (size_t)5);
+        for (size_t r = 0; r < reps; r++)
+            best = std::min(best, run(config));
+        return best;
+    };
+
+    bool found;
+    GemmConfig best = recorded_config(m, n, k, found);
+    run(best);
+    double best_time = measure(best);
+
+    // Blocks at least as large as the matrix all behave the same; only the first of them is timed.
+    auto round_up = [](size_t x, size_t to) { return (x + to - 1) / to * to; };
+    auto sweep = [&](auto GemmConfig::*field, const auto& values, size_t extent) {
+        for (auto value : values) {
+            GemmConfig candidate = best;
+            candidate.*field = value;
+            if (extent && std::min((size_t)value, extent) == std::min((size_t)(best.*field), extent))
+                continue;
+            if (candidate == best)
+                continue;
+
+            double time = measure(candidate);
+            if (time < best_time) {
+                best_time = time;
+                best = candidate;
+            }
+        }
+    };
+
+    std::vector<int> threads;
+    int procs = omp_get_num_procs();
+    for (int t = 1; t < procs; t *= 2)
+        threads.push_back(t);
+    threads.push_back(procs);
+
+    sweep(&GemmConfig::threads, threads, 0);
+    sweep(&GemmConfig::kc, std::vector<size_t> { 64, 128, 192, 256, 384, 512 }, k);
+    sweep(&GemmConfig::mc, std::vector<size_t> { 24, 48, 72, 96, 120, 144, 192, 240 }, round_up(m, GEMM_MR));
+    sweep(&GemmConfig::nc, std::vector<size_t> { 512, 1024, 2048, 3072, 4096, 8192 }, round_up(n, GEMM_NR));
+    sweep(&GemmConfig::panels_per_task, std::vector<size_t> { 1, 2, 4, 8 }, 0);
+
+    set_gemm_config(m, n, k, best);
+    return best;
+}
+
+bool load_gemm_tuning(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in)
+        return false;
+
+    std::map<std::pair<std::string, ShapeBucket>, GemmConfig> entries;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        size_t tab1 = line.find('\t'), tab2 = line.find('\t', tab1 + 1);
+        if (tab1 == std::string::npos || tab2 == std::string::npos)
+            continue;
+
+        std::istringstream bucket_fields(line.substr(tab1 + 1, tab2 - tab1 - 1));
+        std::istringstream config_fields(line.substr(tab2 + 1));
+        unsigned bm, bn, bk;
+        GemmConfig config;
+        if (!(bucket_fields >> bm >> bn >> bk)
+            || !(config_fields >> config.mc >> config.kc >> config.nc >> config.panels_per_task >> config.threads)
+            || !config.valid() || bm > 64 || bn > 64 || bk > 64)
+            continue;
+        entries[{ line.substr(0, tab1), ShapeBucket { (uint8_t)bm, (uint8_t)bn, (uint8_t)bk } }] = config;
+    }
+
+    std::unique_lock lock(table_mutex);
+    for (auto& [key, config] : entries)
+        tuning_table[key.first][key.second] = config;
+    return true;
+}
+
+bool save_gemm_tuning(const std::string& path)
+{
+    ensure_loaded();
+
+    std::error_code ec;
+    auto parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty())
+        std::filesystem::create_directories(parent, ec);
+
+    // Written next to the target and renamed over it, so readers never see half a file. The temporary name is unique
+    // to this process and call, so that concurrent writers of one cache each rename a complete file of their own.
+    static std::atomic<unsigned> saves { 0 };
+    std::string tmp = path + ".tmp." + std::to_string(getpid()) + "." + std::to_string(saves++);
+    auto fail = [&] {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    };
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out)
+            return fail();
+
+        out << "# tensile sgemm tuning: cpu\tm n k buckets (log2)\tmc kc nc panels_per_task threads\n";
+        std::shared_lock lock(table_mutex);
+        for (const auto& [cpu, buckets] : tuning_table)
+            for (const auto& [bucket, c] : buckets)
+                out << cpu << '\t' << (unsigned)bucket.m << ' ' << (unsigned)bucket.n << ' ' << (unsigned)bucket.k
+                    << '\t' << c.mc << ' ' << c.kc << ' ' << c.nc << ' ' << c.panels_per_task << ' ' << c.threads
+                    << '\n';
+        if (!out.flush())
+            return fail();
+    }
+
+    std::filesystem::rename(tmp, path, ec);
+    return ec ? fail() : true;
+}
+
+}
@@ -0,0 +1,178 @@
+#include "tensile/gemv.h"
+#include "tensile/simd_math.h"
+
+#include <algorithm>
+#include <immintrin.h>
+#include <vector>
+
+namespace Tensile {
+
+// Elements per unit of parallel work. Partial results are combined in chunk order.
+static constexpr size_t DOT_CHUNK = 1 << 14;
+static constexpr size_t GEMV_ROWS = 4;
+static constexpr size_t GEMV_T_COLS = 256;
+static constexpr size_t PARALLEL_WORK = 1 << 15;
+
+static float dot_contiguous(size_t n, const float* x, const float* y)
+{
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 31 < n; i += 32) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), acc1);
+        acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 16), _mm256_loadu_ps(y + i + 16), acc2);
+        acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 24), _mm256_loadu_ps(y + i + 24), acc3);
+    }
+    for (; i + 7 < n; i += 8)
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc0);
+
+    float sum = hsum_ps(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+    for (; i < n; i++)
+        sum += x[i] * y[i];
+    return sum;
+}
+
+float sdot(size_t n, const float* x, size_t incx, const float* y, size_t incy)
+{
+    if (incx != 1 || incy != 1) {
+        float sum = 0;
+        for (size_t i = 0; i < n; i++)
+            sum += x[i * incx] * y[i * incy];
+        return sum;
+    }
+
+    size_t n_chunks = (n + DOT_CHUNK - 1) / DOT_CHUNK;
+    if (n_chunks <= 1)
+        return dot_contiguous(n, x, y);
+
+    std::vector<float> partial(n_chunks);
+
+#pragma omp parallel for num_threads(8)
+    for (size_t c = 0; c < n_chunks; c++) {
+        size_t start = c * DOT_CHUNK;
+        partial[c] = dot_contiguous(std::min(DOT_CHUNK, n - start), x + start, y + start);
+    }
+
+    float sum = 0;
+    for (float p : partial)
+        sum += p;
+    return sum;
+}
+
+// Four rows at a time, so each load of x feeds four FMAs.
+static void gemv_rows4(size_t n, const float* a, size_t lda, const float* x, float* y)
+{
+    const float *a0 = a, *a1 = a + lda, *a2 = a + 2 * lda, *a3 = a + 3 * lda;
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+
+    size_t j = 0;
+    for (; j + 7 < n; j += 8) {
+        __m256 xv = _mm256_loadu_ps(x + j);
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a0 + j), xv, acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a1 + j), xv, acc1);
+        acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(a2 + j), xv, acc2);
+        acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(a3 + j), xv, acc3);
+    }
+
+    float y0 = hsum_ps(acc0), y1 = hsum_ps(acc1), y2 = hsum_ps(acc2), y3 = hsum_ps(acc3);
+    for (; j < n; j++) {
+        y0 += a0[j] * x[j];
+        y1 += a1[j] * x[j];
+        y2 += a2[j] * x[j];
+        y3 += a3[j] * x[j];
+    }
+    y[0] = y0, y[1] = y1, y[2] = y2, y[3] = y3;
+}
+
+void sgemv(size_t m, size_t n, const float* a, size_t lda, const float* x, float* y)
+{
+    // Too few rows to keep every thread busy: parallelize each row's dot product instead.
+    if (m < 8 * GEMV_ROWS && n > DOT_CHUNK) {
+        for (size_t i = 0; i < m; i++)
+            y[i] = sdot(n, a + i * lda, 1, x, 1);
+        return;
+    }
+
+    size_t m_blocks = m / GEMV_ROWS;
+
+#pragma omp parallel for num_threads(8) if (m * n > PARALLEL_WORK)
+    for (size_t b = 0; b < m_blocks; b++)
+        gemv_rows4(n, a + b * GEMV_ROWS * lda, lda, x, y + b * GEMV_ROWS);
+
+    for (size_t i = m_blocks * GEMV_ROWS; i < m; i++)
+        y[i] = dot_contiguous(n, a + i * lda, x);
+}
+
+// y[0, cols) = Σ_i x[i] * A[i, 0, cols): streams the rows of one column strip while the strip of y stays in
+// registers and L1.
+static void gemv_t_strip(size_t m, size_t cols, const float* a, size_t lda, const float* x, float* y)
+{
+    size_t j = 0;
+    for (; j + 31 < cols; j += 32) {
+        __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+        __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+        for (size_t i = 0; i < m; i++) {
+            const float* row = a + i * lda + j;
+            __m256 xv = _mm256_set1_ps(x[i]);
+            acc0 = _mm256_fmadd_ps(xv, _mm256_loadu_ps(row), acc0);
+            acc1 = _mm256_fmadd_ps(xv, _mm256_loadu_ps(row + 8), acc1);
+            acc2 = _mm256_fmadd_ps(xv, _mm256_loadu_ps(row + 16), acc2);
+            acc3 = _mm256_fmadd_ps(xv, _mm256_loadu_ps(row + 24), acc3);
+        }
+        _mm256_storeu_ps(y + j, acc0);
+        _mm256_storeu_ps(y + j + 8, acc1);
+        _mm256_storeu_ps(y + j + 16, acc2);
+        _mm256_storeu_ps(y + j + 24, acc3);
+    }
+
+    for (; j + 7 < cols; j += 8) {
+        __m256 acc = _mm256_setzero_ps();
+        for (size_t i = 0; i < m; i++)
+            acc = _mm256_fmadd_ps(_mm256_set1_ps(x[i]), _mm256_loadu_ps(a + i * lda + j), acc);
+        _mm256_storeu_ps(y + j, acc);
+    }
+
+    for (; j < cols; j++) {
+        float sum = 0;
+        for (size_t i = 0; i < m; i++)
+            sum += x[i] * a[i * lda + j];
+        y[j] = sum;
+    }
+}
+
+void sgemv_t(size_t m, size_t n, const float* a, size_t lda, const float* x, float* y)
+{
+    size_t n_strips = (n + GEMV_T_COLS - 1) / GEMV_T_COLS;
+    size_t n_row_chunks = (m + DOT_CHUNK - 1) / DOT_CHUNK;
+
+    if (n_strips >= 8 || n_row_chunks <= 1) {
+#pragma omp parallel for num_threads(8) if (m * n > PARALLEL_WORK)
+        for (size_t s = 0; s < n_strips; s++) {
+            size_t j0 = s * GEMV_T_COLS;
+            gemv_t_strip(m, std::min(GEMV_T_COLS, n - j0), a + j0, lda, x, y + j0);
+        }
+        return;
+    }
+
+    // Few, tall columns: also split the rows into fixed chunks, each producing a partial y, and add those in order.
+    std::vector<float> partial(n_row_chunks * n);
+
+#pragma omp parallel for num_threads(8) collapse(2)
+    for (size_t c = 0; c < n_row_chunks; c++) {
+        for (size_t s = 0; s < n_strips; s++) {
+            size_t i0 = c * DOT_CHUNK, j0 = s * GEMV_T_COLS;
+            gemv_t_strip(std::min(DOT_CHUNK, m - i0), std::min(GEMV_T_COLS, n - j0), a + i0 * lda + j0, lda, x + i0,
+                         partial.data() + c * n + j0);
+        }
+    }
+
+    std::copy(partial.begin(), partial.begin() + n, y);
+    for (size_t c = 1; c < n_row_chunks; c++)
+        for (size_t j = 0; j < n; j++)
+            y[j] += partial[c * n + j];
+}
+
+}
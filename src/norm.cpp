@@ -0,0 +1,220 @@
+#include "tensile/norm.h"
+#include "tensile/simd_math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+#include <limits>
+
+namespace Tensile {
+
+static constexpr size_t PARALLEL_WORK = 1 << 15;
+static constexpr float NEG_INF = -std::numeric_limits<float>::infinity();
+static constexpr float NAN_F = std::numeric_limits<float>::quiet_NaN();
+
+// Softmax of one line of `len` elements `stride` apart, one element at a time. Used for the lanes left over when the
+// lines are too few to fill a vector.
+static void softmax_line(const float* x, float* y, size_t len, size_t stride, bool log)
+{
+    float max = NEG_INF, sum = 0;
+    for (size_t k = 0; k < len; k++) {
+        float v = x[k * stride];
+        // Masked entries add nothing; skipping them also avoids exp(-inf - -inf) while max is still -inf.
+        if (v == NEG_INF)
+            continue;
+        if (v > max) {
+            sum *= std::exp(max - v);
+            max = v;
+        }
+        sum += std::exp(v - max);
+    }
+
+    // A fully masked line has no defined distribution: it is NaN throughout, as in the generic path.
+    if (max == NEG_INF) {
+        for (size_t k = 0; k < len; k++)
+            y[k * stride] = NAN_F;
+        return;
+    }
+
+    float log_sum = max + std::log(sum), inv_sum = 1 / sum;
+    for (size_t k = 0; k < len; k++)
+        y[k * stride] = log ? x[k * stride] - log_sum : std::exp(x[k * stride] - max) * inv_sum;
+}
+
+// Softmax of a contiguous row. Each lane keeps its own running maximum and sum, which are merged at the end.
+static void softmax_row(const float* x, float* y, size_t len, bool log)
+{
+    __m256 vmax = _mm256_set1_ps(NEG_INF), vsum = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 7 < len; i += 8) {
+        __m256 v = _mm256_loadu_ps(x + i);
+        __m256 new_max = _mm256_max_ps(vmax, v);
+        vsum = _mm256_fmadd_ps(vsum, exp_ps(_mm256_sub_ps(vmax, new_max)), exp_ps(_mm256_sub_ps(v, new_max)));
+        vmax = new_max;
+    }
+
+    float max = hmax_ps(vmax);
+    for (size_t t = i; t < len; t++)
+        max = std::max(max, x[t]);
+
+    if (max == NEG_INF) {
+        std::fill(y, y + len, NAN_F);
+        return;
+    }
+
+    float sum = hsum_ps(_mm256_mul_ps(vsum, exp_ps(_mm256_sub_ps(vmax, _mm256_set1_ps(max)))));
+    for (size_t t = i; t < len; t++)
+        sum += std::exp(x[t] - max);
+
+    float log_sum = max + std::log(sum), inv_sum = 1 / sum;
+    __m256 vmax_all = _mm256_set1_ps(max), vlog_sum = _mm256_set1_ps(log_sum), vinv = _mm256_set1_ps(inv_sum);
+    for (i = 0; i + 7 < len; i += 8) {
+        __m256 v = _mm256_loadu_ps(x + i);
+        __m256 out = log ? _mm256_sub_ps(v, vlog_sum) : _mm256_mul_ps(exp_ps(_mm256_sub_ps(v, vmax_all)), vinv);
+        _mm256_storeu_ps(y + i, out);
+    }
+    for (; i < len; i++)
+        y[i] = log ? x[i] - log_sum : std::exp(x[i] - max) * inv_sum;
+}
+
+// Softmax of eight adjacent lines at once (lines `stride` apart, elements contiguous across lines): every lane is an
+// independent line, so no horizontal reduction is needed.
+static void softmax_lines8(const float* x, float* y, size_t len, size_t stride, bool log)
+{
+    __m256 vmax = _mm256_set1_ps(NEG_INF), vsum = _mm256_setzero_ps();
+    for (size_t k = 0; k < len; k++) {
+        __m256 v = _mm256_loadu_ps(x + k * stride);
+        __m256 new_max = _mm256_max_ps(vmax, v);
+        vsum = _mm256_fmadd_ps(vsum, exp_ps(_mm256_sub_ps(vmax, new_max)), exp_ps(_mm256_sub_ps(v, new_max)));
+        vmax = new_max;
+    }
+
+    alignas(32) float sums[8];
+    _mm256_store_ps(sums, vsum);
+    for (float& s : sums)
+        s = std::log(s);
+    __m256 vlog_sum = _mm256_add_ps(vmax, _mm256_load_ps(sums));
+    __m256 vinv = _mm256_div_ps(_mm256_set1_ps(1.0f), vsum);
+
+    // Lanes whose line is fully masked come out NaN rather than whatever exp_ps makes of -inf - -inf.
+    __m256 masked = _mm256_cmp_ps(vmax, _mm256_set1_ps(NEG_INF), _CMP_EQ_OQ), vnan = _mm256_set1_ps(NAN_F);
+
+    for (size_t k = 0; k < len; k++) {
+        __m256 v = _mm256_loadu_ps(x + k * stride);
+        __m256 out = log ? _mm256_sub_ps(v, vlog_sum) : _mm256_mul_ps(exp_ps(_mm256_sub_ps(v, vmax)), vinv);
+        out = _mm256_blendv_ps(out, vnan, masked);
+        _mm256_storeu_ps(y + k * stride, out);
+    }
+}
+
+void softmax_f32(const float* x, float* y, size_t outer, size_t len, size_t inner, bool log)
+{
+    if (len == 0)
+        return;
+
+    bool parallel = outer * len * inner > PARALLEL_WORK;
+
+    if (inner == 1) {
+#pragma omp parallel for num_threads(8) if (parallel)
+        for (size_t o = 0; o < outer; o++)
+            softmax_row(x + o * len, y + o * len, len, log);
+        return;
+    }
+
+    size_t chunks = (inner + 7) / 8;
+
+#pragma omp parallel for num_threads(8) collapse(2) if (parallel)
+    for (size_t o = 0; o < outer; o++) {
+        for (size_t c = 0; c < chunks; c++) {
+            size_t j0 = c * 8, offset = o * len * inner + j0;
+            if (j0 + 8 <= inner) {
+                softmax_lines8(x + offset, y + offset, len, inner, log);
+            } else {
+                for (size_t j = 0; j0 + j < inner; j++)
+                    softmax_line(x + offset + j, y + offset + j, len, inner, log);
+            }
+        }
+    }
+}
+
+// Writes y = (x - shift) * scale * gamma + beta over one row, with gamma and beta optional.
+static void normalize_row(const float* x, float* y, size_t len, float shift, float scale, const float* gamma,
+                          const float* beta)
+{
+    __m256 vshift = _mm256_set1_ps(shift), vscale = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 7 < len; i += 8) {
+        __m256 v = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i), vshift), vscale);
+        if (gamma)
+            v = _mm256_mul_ps(v, _mm256_loadu_ps(gamma + i));
+        if (beta)
+            v = _mm256_add_ps(v, _mm256_loadu_ps(beta + i));
+        _mm256_storeu_ps(y + i, v);
+    }
+    for (; i < len; i++) {
+        float v = (x[i] - shift) * scale;
+        if (gamma)
+            v *= gamma[i];
+        if (beta)
+            v += beta[i];
+        y[i] = v;
+    }
+}
+
+void layer_norm_f32(const float* x, float* y, size_t rows, size_t len, const float* gamma, const float* beta,
+                    float eps)
+{
+    if (len == 0)
+        return;
+
+#pragma omp parallel for num_threads(8) if (rows * len > PARALLEL_WORK)
+    for (size_t r = 0; r < rows; r++) {
+        const float* row = x + r * len;
+
+        // Sums of (x - x[0]) and its square: shifting by a sample of the row keeps E[d^2] - E[d]^2 from cancelling
+        // catastrophically when the mean is large compared to the spread.
+        float shift = row[0];
+        __m256 vshift = _mm256_set1_ps(shift), vsum = _mm256_setzero_ps(), vsq = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 7 < len; i += 8) {
+            __m256 d = _mm256_sub_ps(_mm256_loadu_ps(row + i), vshift);
+            vsum = _mm256_add_ps(vsum, d);
+            vsq = _mm256_fmadd_ps(d, d, vsq);
+        }
+        float sum = hsum_ps(vsum), sq = hsum_ps(vsq);
+        for (; i < len; i++) {
+            float d = row[i] - shift;
+            sum += d;
+            sq += d * d;
+        }
+
+        float mean_d = sum / (float)len;
+        float var = std::max(sq / (float)len - mean_d * mean_d, 0.0f);
+        normalize_row(row, y + r * len, len, shift + mean_d, 1 / std::sqrt(var + eps), gamma, beta);
+    }
+}
+
+void rms_norm_f32(const float* x, float* y, size_t rows, size_t len, const float* gamma, float eps)
+{
+    if (len == 0)
+        return;
+
+#pragma omp parallel for num_threads(8) if (rows * len > PARALLEL_WORK)
+    for (size_t r = 0; r < rows; r++) {
+        const float* row = x + r * len;
+
+        __m256 vsq = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 7 < len; i += 8) {
+            __m256 v = _mm256_loadu_ps(row + i);
+            vsq = _mm256_fmadd_ps(v, v, vsq);
+        }
+        float sq = hsum_ps(vsq);
+        for (; i < len; i++)
+            sq += row[i] * row[i];
+
+        normalize_row(row, y + r * len, len, 0.0f, 1 / std::sqrt(sq / (float)len + eps), gamma, nullptr);
+    }
+}
+
+}
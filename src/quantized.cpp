@@ -0,0 +1,383 @@
+#include "tensile/quantized.h"
+
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+#include <stdexcept>
+
+namespace Tensile {
+
+static constexpr size_t PARALLEL_CHUNK = 1 << 16;
+
+static int8_t quantize_scalar(float value, float inv_scale, int32_t zero_point)
+{
+    float q = std::nearbyint(value * inv_scale) + (float)zero_point;
+    // std::clamp passes NaN through and converting it is undefined; like the vector path, NaN becomes QINT8_MIN.
+    if (std::isnan(q))
+        return (int8_t)QINT8_MIN;
+    return (int8_t)std::clamp(q, (float)QINT8_MIN, (float)QINT8_MAX);
+}
+
+// Quantizes `n` contiguous floats. With PerElement, `inv_scale` and `zero_point` are arrays parallel to `src`
+// (per-channel along the innermost axis); otherwise they point at a single value.
+template <bool PerElement>
+static void quantize_run(const float* src, int8_t* dst, size_t n, const float* inv_scale, const int32_t* zero_point)
+{
+    const __m256i qmin = _mm256_set1_epi32(QINT8_MIN), qmax = _mm256_set1_epi32(QINT8_MAX);
+    auto quantize8 = [&](size_t i) {
+        __m256 s = PerElement ? _mm256_loadu_ps(inv_scale + i) : _mm256_set1_ps(*inv_scale);
+        __m256i z = PerElement ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(zero_point + i))
+                               : _mm256_set1_epi32(*zero_point);
+        // Clamped before converting: cvtps_epi32 turns out-of-range values into INT32_MIN, whatever their sign.
+        __m256 lo = _mm256_cvtepi32_ps(_mm256_sub_epi32(qmin, z)), hi = _mm256_cvtepi32_ps(_mm256_sub_epi32(qmax, z));
+        __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), s), lo), hi);
+        return _mm256_add_epi32(_mm256_cvtps_epi32(x), z);
+    };
+
+    // packs_epi32/packs_epi16 interleave the 128-bit lanes; the permute restores element order.
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t i = 0;
+    for (; i + 31 < n; i += 32) {
+        __m256i lo = _mm256_packs_epi32(quantize8(i), quantize8(i + 8));
+        __m256i hi = _mm256_packs_epi32(quantize8(i + 16), quantize8(i + 24));
+        __m256i packed = _mm256_permutevar8x32_epi32(_mm256_packs_epi16(lo, hi), order);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+    }
+
+    for (; i < n; i++)
+        dst[i] = quantize_scalar(src[i], PerElement ? inv_scale[i] : *inv_scale,
+                                 PerElement ? zero_point[i] : *zero_point);
+}
+
+template <bool PerElement>
+static void dequantize_run(const int8_t* src, float* dst, size_t n, const float* scale, const int32_t* zero_point)
+{
+    size_t i = 0;
+    for (; i + 7 < n; i += 8) {
+        __m256 s = PerElement ? _mm256_loadu_ps(scale + i) : _mm256_set1_ps(*scale);
+        __m256i z = PerElement ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(zero_point + i))
+                               : _mm256_set1_epi32(*zero_point);
+        __m256i q = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(q, z)), s));
+    }
+
+    for (; i < n; i++)
+        dst[i] = (float)(src[i] - (PerElement ? zero_point[i] : *zero_point)) * (PerElement ? scale[i] : *scale);
+}
+
+// Splits a contiguous tensor into (outer, channel, inner) around `axis`.
+static std::array<size_t, 3> channel_extents(const std::array<size_t, MAX_DIM>& shape, size_t n_dims, size_t axis)
+{
+    size_t outer = 1, inner = 1;
+    for (size_t i = 0; i < axis; i++)
+        outer *= shape[i];
+    for (size_t i = axis + 1; i < n_dims; i++)
+        inner *= shape[i];
+    return { outer, shape[axis], inner };
+}
+
+// Applies `run(src_offset, n, channel)` to every run of elements sharing one channel, or to whole rows of channels
+// (channel = SIZE_MAX) when the channel axis is innermost.
+template <typename Run>
+static void for_each_channel_run(const std::array<size_t, MAX_DIM>& shape, size_t n_dims, size_t axis, Run run)
+{
+    auto [outer, channels, inner] = channel_extents(shape, n_dims, axis);
+
+    if (inner == 1) {
+#pragma omp parallel for num_threads(8) if (outer * channels > PARALLEL_CHUNK)
+        for (size_t o = 0; o < outer; o++)
+            run(o * channels, channels, SIZE_MAX);
+        return;
+    }
+
+#pragma omp parallel for num_threads(8) if (outer * channels * inner > PARALLEL_CHUNK)
+    for (size_t oc = 0; oc < outer * channels; oc++)
+        run(oc * inner, inner, oc % channels);
+}
+
+QuantizedTensor::QuantizedTensor(Clamped, Tensor<int8_t>&& values, std::vector<float> scales,
+                                 std::vector<int32_t> zero_points, std::optional<size_t> axis)
+    : values_(std::move(values))
+    , scales_(std::move(scales))
+    , zero_points_(std::move(zero_points))
+    , axis_(axis)
+{
+    if (axis_ && *axis_ >= values_.n_dims())
+        throw std::invalid_argument("Quantization axis out of bounds");
+    size_t expected = axis_ ? values_.shape()[*axis_] : 1;
+    if (scales_.size() != expected || zero_points_.size() != expected)
+        throw std::invalid_argument("Number of quantization parameters does not match the quantization axis");
+    for (auto zp : zero_points_)
+        if (zp < QINT8_MIN || zp > QINT8_MAX)
+            throw std::invalid_argument("Zero point out of the int8 range");
+}
+
+QuantizedTensor::QuantizedTensor(Tensor<int8_t>&& values, std::vector<float> scales, std::vector<int32_t> zero_points,
+                                 std::optional<size_t> axis)
+    : QuantizedTensor(Clamped {}, std::move(values), std::move(scales), std::move(zero_points), axis)
+{
+    // The int8 GEMM negates values with _mm256_sign_epi8, which cannot negate -128.
+    if (!values_.is_empty()) {
+        auto contiguous = values_.contiguous();
+        const int8_t* begin = contiguous.data();
+        const int8_t* end = begin + contiguous.size();
+        if (std::find(begin, end, INT8_MIN) != end)
+            throw std::invalid_argument("Quantized values must be in [-127, 127]");
+    }
+}
+
+QuantizedTensor QuantizedTensor::quantize(const Tensor<float>& tensor, float scale, int32_t zero_point)
+{
+    if (!(scale > 0))
+        throw std::invalid_argument("Quantization scale must be positive");
+
+    auto src = tensor.contiguous();
+    size_t n = tensor.size();
+    auto* data = new int8_t[n];
+    float inv_scale = 1.0f / scale;
+
+#pragma omp parallel for num_threads(8) if (n > PARALLEL_CHUNK)
+    for (size_t begin = 0; begin < n; begin += PARALLEL_CHUNK)
+        quantize_run<false>(src.data() + begin, data + begin, std::min(PARALLEL_CHUNK, n - begin), &inv_scale,
+                            &zero_point);
+
+    auto shape = tensor.shape();
+    Tensor<int8_t> values(data, { shape.begin(), shape.begin() + tensor.n_dims() });
+    return { Clamped {}, std::move(values), { scale }, { zero_point } };
+}
+
+QuantizedTensor QuantizedTensor::quantize_per_channel(const Tensor<float>& tensor, const std::vector<float>& scales,
+                                                      const std::vector<int32_t>& zero_points, size_t axis)
+{
+    if (axis >= tensor.n_dims())
+        throw std::invalid_argument("Quantization axis out of bounds");
+    if (scales.size() != tensor.shape()[axis] || zero_points.size() != tensor.shape()[axis])
+        throw std::invalid_argument("Number of quantization parameters does not match the quantization axis");
+
+    std::vector<float> inv_scales(scales.size());
+    for (size_t c = 0; c < scales.size(); c++) {
+        if (!(scales[c] > 0))
+            throw std::invalid_argument("Quantization scale must be positive");
+        inv_scales[c] = 1.0f / scales[c];
+    }
+
+    auto src = tensor.contiguous();
+    auto* data = new int8_t[tensor.size()];
+    for_each_channel_run(tensor.shape(), tensor.n_dims(), axis, [&](size_t offset, size_t n, size_t channel) {
+        if (channel == SIZE_MAX)
+            quantize_run<true>(src.data() + offset, data + offset, n, inv_scales.data(), zero_points.data());
+        else
+            quantize_run<false>(src.data() + offset, data + offset, n, &inv_scales[channel], &zero_points[channel]);
+    });
+
+    auto shape = tensor.shape();
+    Tensor<int8_t> values(data, { shape.begin(), shape.begin() + tensor.n_dims() });
+    return { Clamped {}, std::move(values), scales, zero_points, axis };
+}
+
+QuantizedTensor QuantizedTensor::quantize_dynamic(const Tensor<float>& tensor)
+{
+    if (tensor.is_empty() || tensor.size() == 0)
+        throw std::invalid_argument("Cannot choose quantization parameters for an empty tensor");
+
+    auto src = tensor.contiguous();
+    auto [min_it, max_it] = std::minmax_element(src.data(), src.data() + tensor.size());
+    float lo = std::min(0.0f, *min_it), hi = std::max(0.0f, *max_it);
+
+    float scale = (hi - lo) / (float)(QINT8_MAX - QINT8_MIN);
+    if (scale == 0)
+        scale = 1.0f;
+    auto zero_point = (int32_t)std::clamp(std::nearbyint((float)QINT8_MIN - lo / scale), (float)QINT8_MIN,
+                                          (float)QINT8_MAX);
+
+    return quantize(tensor, scale, zero_point);
+}
+
+QuantizedTensor QuantizedTensor::quantize_symmetric_per_channel(const Tensor<float>& tensor, size_t axis)
+{
+    if (axis >= tensor.n_dims())
+        throw std::invalid_argument("Quantization axis out of bounds");
+
+    auto src = tensor.contiguous();
+    auto [outer, channels, inner] = channel_extents(tensor.shape(), tensor.n_dims(), axis);
+    std::vector<float> abs_max(channels, 0.0f);
+    for (size_t o = 0; o < outer; o++)
+        for (size_t c = 0; c < channels; c++)
+            for (size_t i = 0; i < inner; i++)
+                abs_max[c] = std::max(abs_max[c], std::abs(src.data()[(o * channels + c) * inner + i]));
+
+    std::vector<float> scales(channels);
+    for (size_t c = 0; c < channels; c++)
+        scales[c] = abs_max[c] > 0 ? abs_max[c] / (float)QINT8_MAX : 1.0f;
+
+    return quantize_per_channel(tensor, scales, std::vector<int32_t>(channels, 0), axis);
+}
+
+Tensor<float> QuantizedTensor::dequantize() const
+{
+    auto src = values_.contiguous();
+    size_t n = values_.size();
+    auto* data = new float[n];
+
+    if (!axis_) {
+#pragma omp parallel for num_threads(8) if (n > PARALLEL_CHUNK)
+        for (size_t begin = 0; begin < n; begin += PARALLEL_CHUNK)
+            dequantize_run<false>(src.data() + begin, data + begin, std::min(PARALLEL_CHUNK, n - begin),
+                                  scales_.data(), zero_points_.data());
+    } else {
+        for_each_channel_run(values_.shape(), values_.n_dims(), *axis_, [&](size_t offset, size_t n, size_t channel) {
+            if (channel == SIZE_MAX)
+                dequantize_run<true>(src.data() + offset, data + offset, n, scales_.data(), zero_points_.data());
+            else
+                dequantize_run<false>(src.data() + offset, data + offset, n, &scales_[channel],
+                                      &zero_points_[channel]);
+        });
+    }
+
+    auto shape = values_.shape();
+    return Tensor<float>(data, { shape.begin(), shape.begin() + values_.n_dims() });
+}
+
+float QuantizedTensor::scale() const
+{
+    if (axis_)
+        throw std::logic_error("Per-channel quantized tensor has no single scale");
+    return scales_[0];
+}
+
+int32_t QuantizedTensor::zero_point() const
+{
+    if (axis_)
+        throw std::logic_error("Per-channel quantized tensor has no single zero point");
+    return zero_points_[0];
+}
+
+static int32_t hsum_epi32(__m256i v)
+{
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+// Dot products of one row of A with COLS rows of B^T, 32 int8 pairs per step. maddubs needs an unsigned first operand,
+// so A is made non-negative with abs() and its sign is moved onto B with sign(); with values in [-127, 127] the
+// int16 pair sums cannot saturate. madd against ones then widens the pairs into int32 accumulators.
+template <size_t COLS> static void dot_s8(const int8_t* a, const int8_t* bt, size_t k, int32_t* out)
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc[COLS];
+    for (size_t c = 0; c < COLS; c++)
+        acc[c] = _mm256_setzero_si256();
+
+    size_t p = 0;
+    for (; p + 31 < k; p += 32) {
+        __m256i a_vec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + p));
+        __m256i a_abs = _mm256_abs_epi8(a_vec);
+        for (size_t c = 0; c < COLS; c++) {
+            __m256i b_vec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bt + c * k + p));
+            __m256i pairs = _mm256_maddubs_epi16(a_abs, _mm256_sign_epi8(b_vec, a_vec));
+            acc[c] = _mm256_add_epi32(acc[c], _mm256_madd_epi16(pairs, ones));
+        }
+    }
+
+    for (size_t c = 0; c < COLS; c++) {
+        int32_t sum = hsum_epi32(acc[c]);
+        for (size_t q = p; q < k; q++)
+            sum += (int32_t)a[q] * (int32_t)bt[c * k + q];
+        out[c] = sum;
+    }
+}
+
+static void check_matmul(const QuantizedTensor& a, const QuantizedTensor& b)
+{
+    if (a.n_dims() != 2 || b.n_dims() != 2 || a.shape()[1] != b.shape()[0])
+        throw std::invalid_argument("Incompatible shapes for quantized matrix multiplication");
+    if ((a.axis() && *a.axis() != 0) || (b.axis() && *b.axis() != 1))
+        throw std::invalid_argument("Quantized matmul needs `a` quantized per row and `b` per column");
+}
+
+// Runs the int8 GEMM one output row at a time and hands each row of raw int32 accumulators, with zero-point
+// corrections already applied, to `epilogue(i, row)` while it is hot in cache. The operands must have passed
+// check_matmul().
+template <typename Epilogue>
+static void gemm_s8(const QuantizedTensor& a, const QuantizedTensor& b, Epilogue epilogue)
+{
+    size_t m = a.shape()[0], k = a.shape()[1], n = b.shape()[1];
+    auto a_values = a.int_repr().contiguous();
+    auto bt_values = b.int_repr().transpose().copy(); // pack B as [N, K] so both operands stream along K
+
+    const int8_t* a_data = a_values.data();
+    const int8_t* bt_data = bt_values.data();
+
+    std::vector<int64_t> b_col_sums(n, 0);
+    for (size_t j = 0; j < n; j++)
+        for (size_t p = 0; p < k; p++)
+            b_col_sums[j] += bt_data[j * k + p];
+
+    auto zp_a = [&](size_t i) { return (int64_t)a.zero_points()[a.axis() ? i : 0]; };
+    auto zp_b = [&](size_t j) { return (int64_t)b.zero_points()[b.axis() ? j : 0]; };
+
+#pragma omp parallel for num_threads(8)
+    for (size_t i = 0; i < m; i++) {
+        const int8_t* a_row = a_data + i * k;
+        std::vector<int32_t> acc(n);
+
+        size_t j = 0;
+        for (; j + 3 < n; j += 4)
+            dot_s8<4>(a_row, bt_data + j * k, k, acc.data() + j);
+        for (; j < n; j++)
+            dot_s8<1>(a_row, bt_data + j * k, k, acc.data() + j);
+
+        int64_t a_row_sum = 0;
+        for (size_t p = 0; p < k; p++)
+            a_row_sum += a_row[p];
+
+        // sum((qa - za) * (qb - zb)) = sum(qa * qb) - zb * sum(qa) - za * sum(qb) + k * za * zb
+        std::vector<int64_t> corrected(n);
+        for (size_t jj = 0; jj < n; jj++)
+            corrected[jj] = (int64_t)acc[jj] - zp_b(jj) * a_row_sum - zp_a(i) * b_col_sums[jj]
+                + (int64_t)k * zp_a(i) * zp_b(jj);
+
+        epilogue(i, corrected.data());
+    }
+}
+
+Tensor<float> quantized_matmul(const QuantizedTensor& a, const QuantizedTensor& b)
+{
+    check_matmul(a, b);
+    size_t m = a.shape()[0], n = b.shape()[1];
+    auto result = Tensor<float>::empty({ m, n });
+    float* data = result.data();
+
+    gemm_s8(a, b, [&](size_t i, const int64_t* row) {
+        float scale_a = a.scales()[a.axis() ? i : 0];
+        for (size_t j = 0; j < n; j++)
+            data[i * n + j] = (float)row[j] * scale_a * b.scales()[b.axis() ? j : 0];
+    });
+
+    return result;
+}
+
+QuantizedTensor quantized_matmul(const QuantizedTensor& a, const QuantizedTensor& b, float out_scale,
+                                 int32_t out_zero_point)
+{
+    if (!(out_scale > 0))
+        throw std::invalid_argument("Quantization scale must be positive");
+    check_matmul(a, b);
+
+    size_t m = a.shape()[0], n = b.shape()[1];
+    auto values = Tensor<int8_t>::empty({ m, n });
+    int8_t* data = values.data();
+    float inv_out_scale = 1.0f / out_scale;
+
+    gemm_s8(a, b, [&](size_t i, const int64_t* row) {
+        float scale_a = a.scales()[a.axis() ? i : 0] * inv_out_scale;
+        for (size_t j = 0; j < n; j++)
+            data[i * n + j] = quantize_scalar((float)row[j] * b.scales()[b.axis() ? j : 0], scale_a, out_zero_point);
+    });
+
+    return { QuantizedTensor::Clamped {}, std::move(values), { out_scale }, { out_zero_point } };
+}
+
+}
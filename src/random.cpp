@@ -0,0 +1,270 @@
+#include "tensile/random.h"
+#include "tensile/simd_math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+
+namespace Tensile {
+
+static constexpr uint32_t PHILOX_M0 = 0xD2511F53;
+static constexpr uint32_t PHILOX_M1 = 0xCD9E8D57;
+static constexpr uint32_t PHILOX_W0 = 0x9E3779B9;
+static constexpr uint32_t PHILOX_W1 = 0xBB67AE85;
+static constexpr int PHILOX_ROUNDS = 10;
+
+// Elements per unit of parallel work, a multiple of the 32 floats produced by one vector step.
+static constexpr size_t RAND_CHUNK = 1 << 14;
+static constexpr size_t PARALLEL_WORK = 1 << 16;
+
+static constexpr float TWO_PI = 6.28318530717958647692f;
+
+std::array<uint32_t, 4> philox4x32_10(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key)
+{
+    auto [c0, c1, c2, c3] = counter;
+    auto [k0, k1] = key;
+
+    for (int r = 0; r < PHILOX_ROUNDS; r++) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c0, p1 = (uint64_t)PHILOX_M1 * c2;
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0, n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t)p1;
+        c3 = (uint32_t)p0;
+        c0 = n0;
+        c2 = n2;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    return { c0, c1, c2, c3 };
+}
+
+std::array<uint32_t, 4> Philox4x32::block(uint64_t counter) const
+{
+    return philox4x32_10({ (uint32_t)counter, (uint32_t)(counter >> 32), 0, 0 },
+                         { (uint32_t)seed_, (uint32_t)(seed_ >> 32) });
+}
+
+// Lane-wise 32x32 -> 64 bit product split into high and low words. _mm256_mul_epu32 only multiplies the even
+// lanes, so the odd lanes go through a second multiply after shifting them down.
+static inline void mulhilo(__m256i m, __m256i a, __m256i& hi, __m256i& lo)
+{
+    __m256i even = _mm256_mul_epu32(m, a);
+    __m256i odd = _mm256_mul_epu32(m, _mm256_srli_epi64(a, 32));
+    lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+}
+
+// Blocks counter .. counter + 7 at once, lane j of x[w] holding word w of block counter + j.
+static void philox_blocks8(uint64_t seed, uint64_t counter, __m256i x[4])
+{
+    uint32_t lo = (uint32_t)counter;
+    __m256i c0 = _mm256_add_epi32(_mm256_set1_epi32((int)lo), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    // Lanes whose low word wrapped around carry into the high word (a compare mask is -1 where true).
+    __m256i bias = _mm256_set1_epi32((int)0x80000000);
+    __m256i wrapped
+        = _mm256_cmpgt_epi32(_mm256_xor_si256(_mm256_set1_epi32((int)lo), bias), _mm256_xor_si256(c0, bias));
+    __m256i c1 = _mm256_sub_epi32(_mm256_set1_epi32((int)(counter >> 32)), wrapped);
+    __m256i c2 = _mm256_setzero_si256(), c3 = _mm256_setzero_si256();
+
+    __m256i k0 = _mm256_set1_epi32((int)(uint32_t)seed), k1 = _mm256_set1_epi32((int)(uint32_t)(seed >> 32));
+    const __m256i m0 = _mm256_set1_epi32((int)PHILOX_M0), m1 = _mm256_set1_epi32((int)PHILOX_M1);
+    const __m256i w0 = _mm256_set1_epi32((int)PHILOX_W0), w1 = _mm256_set1_epi32((int)PHILOX_W1);
+
+    for (int r = 0; r < PHILOX_ROUNDS; r++) {
+        __m256i hi0, lo0, hi1, lo1;
+        mulhilo(m0, c0, hi0, lo0);
+        mulhilo(m1, c2, hi1, lo1);
+        c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), k0);
+        c1 = lo1;
+        c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), k1);
+        c3 = lo0;
+        k0 = _mm256_add_epi32(k0, w0);
+        k1 = _mm256_add_epi32(k1, w1);
+    }
+    x[0] = c0;
+    x[1] = c1;
+    x[2] = c2;
+    x[3] = c3;
+}
+
+// Top 24 bits of each word scaled to [0, 1).
+static inline __m256 unit_float(__m256i x)
+{
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(x, 8)), _mm256_set1_ps(1.0f / 16777216.0f));
+}
+
+// Stores v[w] (word w of eight blocks) in stream order: block 0 words 0-3, block 1 words 0-3, ...
+static inline void store_blocks8(float* out, const __m256 v[4])
+{
+    __m256 t0 = _mm256_unpacklo_ps(v[0], v[1]), t1 = _mm256_unpackhi_ps(v[0], v[1]);
+    __m256 t2 = _mm256_unpacklo_ps(v[2], v[3]), t3 = _mm256_unpackhi_ps(v[2], v[3]);
+    __m256 b04 = _mm256_shuffle_ps(t0, t2, 0x44), b15 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    __m256 b26 = _mm256_shuffle_ps(t1, t3, 0x44), b37 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    _mm256_storeu_ps(out, _mm256_permute2f128_ps(b04, b15, 0x20));
+    _mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(b26, b37, 0x20));
+    _mm256_storeu_ps(out + 16, _mm256_permute2f128_ps(b04, b15, 0x31));
+    _mm256_storeu_ps(out + 24, _mm256_permute2f128_ps(b26, b37, 0x31));
+}
+
+// Fills n floats from the blocks starting at `counter`, 32 at a time. A short tail is produced in full into a buffer
+// and truncated, so every element goes through the same arithmetic wherever the chunk boundaries fall.
+template <typename Transform>
+static void fill_blocks_f32(uint64_t seed, uint64_t counter, float* data, size_t n, Transform transform)
+{
+    for (size_t i = 0; i < n; i += 32, counter += 8) {
+        __m256i x[4];
+        __m256 v[4];
+        philox_blocks8(seed, counter, x);
+        transform(x, v);
+        if (i + 32 <= n) {
+            store_blocks8(data + i, v);
+        } else {
+            float tail[32];
+            store_blocks8(tail, v);
+            std::copy(tail, tail + (n - i), data + i);
+        }
+    }
+}
+
+// Runs fill(start, count) over fixed RAND_CHUNK slices of [0, n).
+template <typename Fill>
+static void parallel_chunks(size_t n, Fill fill)
+{
+    size_t n_chunks = (n + RAND_CHUNK - 1) / RAND_CHUNK;
+
+#pragma omp parallel for num_threads(8) if (n > PARALLEL_WORK)
+    for (size_t c = 0; c < n_chunks; c++) {
+        size_t start = c * RAND_CHUNK;
+        fill(start, std::min(RAND_CHUNK, n - start));
+    }
+}
+
+void Philox4x32::fill_uniform(float* data, size_t n, float low, float high)
+{
+    uint64_t seed = seed_, base = offset_;
+    __m256 vlow = _mm256_set1_ps(low), vrange = _mm256_set1_ps(high - low);
+    // low + u * (high - low) can round up to `high`; the largest float below it takes its place.
+    __m256 vtop = _mm256_set1_ps(high > low ? std::nextafter(high, low) : low);
+
+    parallel_chunks(n, [&](size_t start, size_t count) {
+        fill_blocks_f32(seed, base + start / 4, data + start, count, [&](const __m256i x[4], __m256 v[4]) {
+            for (int w = 0; w < 4; w++)
+                v[w] = _mm256_min_ps(_mm256_fmadd_ps(unit_float(x[w]), vrange, vlow), vtop);
+        });
+    });
+    offset_ += (n + 3) / 4;
+}
+
+void Philox4x32::fill_normal(float* data, size_t n, float mean, float stddev)
+{
+    uint64_t seed = seed_, base = offset_;
+    __m256 vmean = _mm256_set1_ps(mean), vstd = _mm256_set1_ps(stddev);
+
+    // Words (0, 1) and (2, 3) of each block are Box-Muller pairs. The radius uses a uniform in (0, 1] so the log is
+    // finite.
+    parallel_chunks(n, [&](size_t start, size_t count) {
+        fill_blocks_f32(seed, base + start / 4, data + start, count, [&](const __m256i x[4], __m256 v[4]) {
+            const __m256 ulp = _mm256_set1_ps(1.0f / 16777216.0f);
+            for (int w = 0; w < 4; w += 2) {
+                __m256 u = _mm256_add_ps(unit_float(x[w]), ulp);
+                __m256 radius = _mm256_sqrt_ps(_mm256_mul_ps(_mm256_set1_ps(-2.0f), log_ps(u)));
+                __m256 s, c;
+                sincos_ps(_mm256_mul_ps(unit_float(x[w + 1]), _mm256_set1_ps(TWO_PI)), s, c);
+                v[w] = _mm256_fmadd_ps(_mm256_mul_ps(radius, c), vstd, vmean);
+                v[w + 1] = _mm256_fmadd_ps(_mm256_mul_ps(radius, s), vstd, vmean);
+            }
+        });
+    });
+    offset_ += (n + 3) / 4;
+}
+
+// Words (hi, lo) of four blocks as doubles in [0, 1) with the top 53 of their 64 bits: hi * 2^21 + (lo >> 11) is
+// exact in a double. cvtepi32_pd is signed, so `hi` is converted with its top bit flipped and 2^31 added back.
+static inline __m256d unit_double4(__m128i hi, __m128i lo)
+{
+    __m256d high = _mm256_add_pd(_mm256_cvtepi32_pd(_mm_xor_si128(hi, _mm_set1_epi32((int)0x80000000))),
+                                 _mm256_set1_pd(2147483648.0));
+    __m256d low = _mm256_cvtepi32_pd(_mm_srli_epi32(lo, 11));
+    return _mm256_mul_pd(_mm256_fmadd_pd(high, _mm256_set1_pd(2097152.0), low),
+                         _mm256_set1_pd(1.0 / 9007199254740992.0));
+}
+
+// Stores the elements of four blocks in stream order: even[b] then odd[b] for each block b.
+static inline void store_pairs4(double* out, __m256d even, __m256d odd)
+{
+    __m256d lo = _mm256_unpacklo_pd(even, odd), hi = _mm256_unpackhi_pd(even, odd);
+    _mm256_storeu_pd(out, _mm256_permute2f128_pd(lo, hi, 0x20));
+    _mm256_storeu_pd(out + 4, _mm256_permute2f128_pd(lo, hi, 0x31));
+}
+
+// Fills n doubles from the blocks starting at `counter`, 16 at a time. Every block yields one pair: the transform maps
+// the unit doubles of words (0, 1) and (2, 3) of four blocks to their even and odd elements.
+template <typename Transform>
+static void fill_blocks_f64(uint64_t seed, uint64_t counter, double* data, size_t n, Transform transform)
+{
+    for (size_t i = 0; i < n; i += 16, counter += 8) {
+        __m256i x[4];
+        philox_blocks8(seed, counter, x);
+
+        double tail[16];
+        double* out = i + 16 <= n ? data + i : tail;
+        for (int h = 0; h < 2; h++) {
+            __m128i w[4];
+            for (int k = 0; k < 4; k++)
+                w[k] = h == 0 ? _mm256_castsi256_si128(x[k]) : _mm256_extracti128_si256(x[k], 1);
+            __m256d even, odd;
+            transform(unit_double4(w[0], w[1]), unit_double4(w[2], w[3]), even, odd);
+            store_pairs4(out + 8 * h, even, odd);
+        }
+        if (out == tail)
+            std::copy(tail, tail + (n - i), data + i);
+    }
+}
+
+void Philox4x32::fill_uniform(double* data, size_t n, double low, double high)
+{
+    uint64_t seed = seed_, base = offset_;
+    __m256d vlow = _mm256_set1_pd(low), vrange = _mm256_set1_pd(high - low);
+    __m256d vtop = _mm256_set1_pd(high > low ? std::nextafter(high, low) : low);
+
+    auto transform = [&](__m256d u01, __m256d u23, __m256d& even, __m256d& odd) {
+        even = _mm256_min_pd(_mm256_fmadd_pd(u01, vrange, vlow), vtop);
+        odd = _mm256_min_pd(_mm256_fmadd_pd(u23, vrange, vlow), vtop);
+    };
+    parallel_chunks(n, [&](size_t start, size_t count) {
+        fill_blocks_f64(seed, base + start / 2, data + start, count, transform);
+    });
+    offset_ += (n + 1) / 2;
+}
+
+void Philox4x32::fill_normal(double* data, size_t n, double mean, double stddev)
+{
+    uint64_t seed = seed_, base = offset_;
+    __m256d vmean = _mm256_set1_pd(mean), vstd = _mm256_set1_pd(stddev);
+
+    // One Box-Muller pair per block: the even element takes the cosine, the odd one the sine. There is no double
+    // vector log or sincos here, so those go through libm, once per pair.
+    auto transform = [&](__m256d u01, __m256d u23, __m256d& even, __m256d& odd) {
+        alignas(32) double u[4], theta[4], c[4], s[4];
+        _mm256_store_pd(u, _mm256_add_pd(u01, _mm256_set1_pd(1.0 / 9007199254740992.0)));
+        _mm256_store_pd(theta, _mm256_mul_pd(u23, _mm256_set1_pd(2 * M_PI)));
+        for (int b = 0; b < 4; b++) {
+            double radius = std::sqrt(-2 * std::log(u[b]));
+            c[b] = radius * std::cos(theta[b]);
+            s[b] = radius * std::sin(theta[b]);
+        }
+        even = _mm256_fmadd_pd(_mm256_load_pd(c), vstd, vmean);
+        odd = _mm256_fmadd_pd(_mm256_load_pd(s), vstd, vmean);
+    };
+    parallel_chunks(n, [&](size_t start, size_t count) {
+        fill_blocks_f64(seed, base + start / 2, data + start, count, transform);
+    });
+    offset_ += (n + 1) / 2;
+}
+
+Philox4x32& default_generator()
+{
+    static Philox4x32 generator;
+    return generator;
+}
+
+}
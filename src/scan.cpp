@@ -0,0 +1,172 @@
+#include "tensile/scan.h"
+
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+#include <limits>
+
+namespace Tensile {
+
+// Lines at least this long are scanned in parallel blocks when there are too few lines to spread over threads.
+static constexpr size_t PARALLEL_LINE = 1 << 16;
+static constexpr size_t LINE_BLOCKS = 8;
+static constexpr size_t INNER_BLOCK = 256;
+static constexpr size_t PARALLEL_WORK = 1 << 15;
+
+template <ScanOp Op> struct Scan;
+
+template <> struct Scan<ScanOp::SUM> {
+    static constexpr float identity = 0.0f;
+    static float apply(float a, float b) { return a + b; }
+    static __m256 apply(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+};
+
+template <> struct Scan<ScanOp::PROD> {
+    static constexpr float identity = 1.0f;
+    static float apply(float a, float b) { return a * b; }
+    static __m256 apply(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+};
+
+// _mm256_max_ps/_mm256_min_ps return their second operand when either is NaN, so a NaN in `a` is put back.
+template <> struct Scan<ScanOp::MAX> {
+    static constexpr float identity = -std::numeric_limits<float>::infinity();
+    static float apply(float a, float b) { return std::isnan(a) ? a : (b > a || std::isnan(b) ? b : a); }
+    static __m256 apply(__m256 a, __m256 b)
+    {
+        return _mm256_blendv_ps(_mm256_max_ps(a, b), a, _mm256_cmp_ps(a, a, _CMP_UNORD_Q));
+    }
+};
+
+template <> struct Scan<ScanOp::MIN> {
+    static constexpr float identity = std::numeric_limits<float>::infinity();
+    static float apply(float a, float b) { return std::isnan(a) ? a : (b < a || std::isnan(b) ? b : a); }
+    static __m256 apply(__m256 a, __m256 b)
+    {
+        return _mm256_blendv_ps(_mm256_min_ps(a, b), a, _mm256_cmp_ps(a, a, _CMP_UNORD_Q));
+    }
+};
+
+// Inclusive scan of the eight lanes of x: two shift-and-combine steps inside each 128-bit half, then the last lane
+// of the low half is combined into the high half. Vacated lanes are filled with the identity.
+template <ScanOp Op> static inline __m256 prefix8(__m256 x)
+{
+    using S = Scan<Op>;
+    const __m256 id = _mm256_set1_ps(S::identity);
+
+    __m256 shifted = _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4));
+    x = S::apply(_mm256_blend_ps(shifted, id, 0x11), x);
+    shifted = _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8));
+    x = S::apply(_mm256_blend_ps(shifted, id, 0x33), x);
+
+    __m256 low_last = _mm256_permute_ps(_mm256_permute2f128_ps(x, x, 0x00), 0xFF);
+    return S::apply(_mm256_blend_ps(id, low_last, 0xF0), x);
+}
+
+// Scans n contiguous elements, starting from `carry`.
+template <ScanOp Op> static void scan_contiguous(float* x, size_t n, float carry)
+{
+    using S = Scan<Op>;
+    __m256 vcarry = _mm256_set1_ps(carry);
+
+    size_t i = 0;
+    for (; i + 7 < n; i += 8) {
+        __m256 v = S::apply(vcarry, prefix8<Op>(_mm256_loadu_ps(x + i)));
+        _mm256_storeu_ps(x + i, v);
+        vcarry = _mm256_permute_ps(_mm256_permute2f128_ps(v, v, 0x11), 0xFF);
+    }
+
+    float running = i > 0 ? x[i - 1] : carry;
+    for (; i < n; i++)
+        x[i] = running = S::apply(running, x[i]);
+}
+
+// x[i] = op(carry, x[i]) over n contiguous elements.
+template <ScanOp Op> static void apply_carry(float* x, size_t n, float carry)
+{
+    using S = Scan<Op>;
+    __m256 vcarry = _mm256_set1_ps(carry);
+    size_t i = 0;
+    for (; i + 7 < n; i += 8)
+        _mm256_storeu_ps(x + i, S::apply(vcarry, _mm256_loadu_ps(x + i)));
+    for (; i < n; i++)
+        x[i] = S::apply(carry, x[i]);
+}
+
+// Three phases over a fixed number of blocks (so the result does not depend on the thread count): scan each block
+// locally, chain the block totals serially, then fold each block's incoming carry into it.
+template <ScanOp Op> static void scan_long_line(float* x, size_t n)
+{
+    using S = Scan<Op>;
+    size_t bounds[LINE_BLOCKS + 1];
+    for (size_t b = 0; b <= LINE_BLOCKS; b++)
+        bounds[b] = n * b / LINE_BLOCKS;
+
+#pragma omp parallel for num_threads(8)
+    for (size_t b = 0; b < LINE_BLOCKS; b++)
+        scan_contiguous<Op>(x + bounds[b], bounds[b + 1] - bounds[b], S::identity);
+
+    float carries[LINE_BLOCKS];
+    carries[0] = S::identity;
+    for (size_t b = 1; b < LINE_BLOCKS; b++)
+        carries[b] = S::apply(carries[b - 1], x[bounds[b] - 1]);
+
+#pragma omp parallel for num_threads(8)
+    for (size_t b = 1; b < LINE_BLOCKS; b++)
+        apply_carry<Op>(x + bounds[b], bounds[b + 1] - bounds[b], carries[b]);
+}
+
+template <ScanOp Op> static void scan_rows(float* x, size_t outer, size_t len, size_t inner)
+{
+    using S = Scan<Op>;
+    size_t n_blocks = (inner + INNER_BLOCK - 1) / INNER_BLOCK;
+
+#pragma omp parallel for num_threads(8) collapse(2) if (outer * len * inner > PARALLEL_WORK)
+    for (size_t o = 0; o < outer; o++) {
+        for (size_t b = 0; b < n_blocks; b++) {
+            size_t k0 = b * INNER_BLOCK, k1 = std::min(inner, k0 + INNER_BLOCK);
+            for (size_t j = 1; j < len; j++) {
+                float* row = x + (o * len + j) * inner;
+                const float* prev = row - inner;
+                size_t k = k0;
+                for (; k + 7 < k1; k += 8)
+                    _mm256_storeu_ps(row + k, S::apply(_mm256_loadu_ps(prev + k), _mm256_loadu_ps(row + k)));
+                for (; k < k1; k++)
+                    row[k] = S::apply(prev[k], row[k]);
+            }
+        }
+    }
+}
+
+template <ScanOp Op> static void scan_block(float* x, size_t outer, size_t len, size_t inner)
+{
+    if (inner > 1) {
+        scan_rows<Op>(x, outer, len, inner);
+        return;
+    }
+
+    if (outer < 8 && len >= PARALLEL_LINE) {
+        for (size_t o = 0; o < outer; o++)
+            scan_long_line<Op>(x + o * len, len);
+        return;
+    }
+
+#pragma omp parallel for num_threads(8) if (outer * len > PARALLEL_WORK)
+    for (size_t o = 0; o < outer; o++)
+        scan_contiguous<Op>(x + o * len, len, Scan<Op>::identity);
+}
+
+void scan_f32(float* x, size_t outer, size_t len, size_t inner, ScanOp op)
+{
+    switch (op) {
+    case ScanOp::SUM:
+        return scan_block<ScanOp::SUM>(x, outer, len, inner);
+    case ScanOp::PROD:
+        return scan_block<ScanOp::PROD>(x, outer, len, inner);
+    case ScanOp::MAX:
+        return scan_block<ScanOp::MAX>(x, outer, len, inner);
+    case ScanOp::MIN:
+        return scan_block<ScanOp::MIN>(x, outer, len, inner);
+    }
+}
+
+}
@@ -0,0 +1,189 @@
+#include "tensile/shared.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Tensile {
+
+static constexpr uint64_t SHARED_MAGIC = 0x74656e73696c6531; // "tensile1"
+static constexpr size_t MAX_NAME = 200;
+static constexpr const char* PREFIX = "tensile.";
+
+// First page of every shared tensor. It is written by the creator before anything else can attach, and only `refs`
+// and `ready` change afterwards.
+struct SharedHeader {
+    uint64_t magic;
+    std::atomic<uint32_t> refs;
+    std::atomic<uint32_t> ready;
+    uint32_t type_tag;
+    uint32_t n_dims;
+    uint64_t shape[4];
+    uint64_t bytes;
+    uint64_t inode;
+    char name[MAX_NAME + 1];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Reference counts must work across processes");
+
+static size_t header_bytes()
+{
+    static const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    return std::max(page, sizeof(SharedHeader));
+}
+
+static SharedHeader* header_of(const void* data)
+{
+    return reinterpret_cast<SharedHeader*>((char*)const_cast<void*>(data) - header_bytes());
+}
+
+static std::string object_name(const std::string& name)
+{
+    if (name.empty() || name.size() > MAX_NAME || name.find('/') != std::string::npos)
+        throw std::invalid_argument("Shared tensor names must be 1 to 200 characters without '/'");
+    return std::string("/") + PREFIX + name;
+}
+
+static std::runtime_error system_error(const std::string& what, const std::string& name)
+{
+    return std::runtime_error(what + " shared tensor " + name + ": " + std::strerror(errno));
+}
+
+void* shared_create(const std::string& name, size_t bytes, uint32_t type_tag, const std::vector<size_t>& shape)
+{
+    std::string object = object_name(name);
+    if (shape.size() > 4)
+        throw std::invalid_argument("Tensor shape cannot have more than 4 dimensions");
+
+    int fd = shm_open(object.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw system_error("Cannot create", name);
+
+    struct stat st {};
+    size_t total = header_bytes() + bytes;
+    void* base = fstat(fd, &st) == 0 && ftruncate(fd, (off_t)total) == 0
+        ? mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+        : MAP_FAILED;
+    close(fd);
+    if (base == MAP_FAILED) {
+        auto error = system_error("Cannot map", name);
+        shm_unlink(object.c_str());
+        throw error;
+    }
+
+    // The object starts zeroed, so attachers see ready == 0 until the header and elements are complete.
+    auto* header = new (base) SharedHeader {};
+    header->magic = SHARED_MAGIC;
+    header->refs.store(1, std::memory_order_relaxed);
+    header->type_tag = type_tag;
+    header->n_dims = (uint32_t)shape.size();
+    std::copy(shape.begin(), shape.end(), header->shape);
+    header->bytes = bytes;
+    header->inode = (uint64_t)st.st_ino;
+    std::memcpy(header->name, name.c_str(), name.size() + 1);
+    return (char*)base + header_bytes();
+}
+
+void shared_publish(void* data) { header_of(data)->ready.store(1, std::memory_order_release); }
+
+void* shared_attach(const std::string& name, uint32_t type_tag, bool writable, std::vector<size_t>& shape,
+                    size_t& bytes)
+{
+    std::string object = object_name(name);
+    int fd = shm_open(object.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0)
+        throw system_error("Cannot open", name);
+
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < header_bytes()) {
+        close(fd);
+        throw std::runtime_error("Shared tensor " + name + " is not initialized");
+    }
+
+    size_t total = (size_t)st.st_size;
+    void* base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        throw system_error("Cannot map", name);
+
+    auto* header = static_cast<SharedHeader*>(base);
+    auto fail = [&](const std::string& why) {
+        munmap(base, total);
+        return std::runtime_error("Shared tensor " + name + " " + why);
+    };
+    if (header->magic != SHARED_MAGIC || !header->ready.load(std::memory_order_acquire))
+        throw fail("is not published");
+    if (header->type_tag != type_tag)
+        throw fail("has a different element type");
+    if (header_bytes() + header->bytes > total)
+        throw fail("is truncated");
+
+    // A count that already reached zero belongs to a tensor being destroyed, which must not come back to life.
+    uint32_t refs = header->refs.load(std::memory_order_relaxed);
+    do {
+        if (refs == 0)
+            throw fail("is being released");
+    } while (!header->refs.compare_exchange_weak(refs, refs + 1, std::memory_order_acq_rel));
+
+    void* data = (char*)base + header_bytes();
+    if (!writable && header->bytes > 0)
+        mprotect(data, header->bytes, PROT_READ);
+
+    shape.assign(header->shape, header->shape + header->n_dims);
+    bytes = header->bytes;
+    return data;
+}
+
+// Unlinks the name of `header` unless it was removed and reused by a newer tensor, which must be left alone.
+static void unlink_own_name(const SharedHeader* header)
+{
+    std::string object = object_name(header->name);
+    int fd = shm_open(object.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0)
+        return;
+    struct stat st {};
+    bool same = fstat(fd, &st) == 0 && (uint64_t)st.st_ino == header->inode;
+    close(fd);
+    if (same)
+        shm_unlink(object.c_str());
+}
+
+void shared_release(void* data, size_t bytes)
+{
+    SharedHeader* header = header_of(data);
+    if (header->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        unlink_own_name(header);
+    munmap(header, header_bytes() + bytes);
+}
+
+uint32_t shared_references(const void* data) { return header_of(data)->refs.load(std::memory_order_relaxed); }
+
+std::vector<std::string> shared_names()
+{
+    // Linux exposes POSIX shared memory objects as files in /dev/shm.
+    std::vector<std::string> names;
+    DIR* dir = opendir("/dev/shm");
+    if (!dir)
+        return names;
+
+    size_t prefix = std::strlen(PREFIX);
+    while (dirent* entry = readdir(dir)) {
+        std::string file = entry->d_name;
+        if (file.size() > prefix && file.compare(0, prefix, PREFIX) == 0)
+            names.push_back(file.substr(prefix));
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+bool remove_shared(const std::string& name) { return shm_unlink(object_name(name).c_str()) == 0; }
+
+}
@@ -0,0 +1,208 @@
+#include "tensile/stream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "tensile/alloc.h"
+#include "tensile/gemm.h"
+
+namespace Tensile {
+
+// Columns per reduction task, and the tile size (in elements) from which a tile is reduced in parallel.
+static constexpr size_t COLUMN_CHUNK = 1 << 10;
+static constexpr size_t PARALLEL_WORK = 1 << 15;
+
+void matmul_streamed(const Tensor<float>& a, const Tensor<float>& b, Tensor<float>& c, const StreamOptions& options)
+{
+    if (a.n_dims() != 2 || b.n_dims() != 2 || a.shape()[1] != b.shape()[0])
+        throw std::invalid_argument("Incompatible shapes for matrix multiplication");
+
+    size_t m = a.shape()[0], k = a.shape()[1], n = b.shape()[1];
+    if (c.n_dims() != 2 || c.shape()[0] != m || c.shape()[1] != n)
+        throw std::invalid_argument("Output shape does not match the matmul output");
+    if (!a.is_contiguous() || !b.is_contiguous() || (c.strides()[1] != 1 && n > 1))
+        throw std::invalid_argument("Streamed matmul needs row-major operands and an output with contiguous rows");
+
+    const float* A = a.data();
+    const float* B = b.data();
+    float* C = c.data();
+    size_t ldc = c.strides()[0];
+    if (m == 0 || n == 0)
+        return;
+    if (k == 0) {
+        sgemm(m, n, 0, { A, k, 1 }, { B, n, 1 }, C, ldc, {});
+        return;
+    }
+
+    // Half the budget holds a block of rows of A and C, the rest two panels of B: the one being multiplied and the
+    // one being prefetched. When all of B fits it is read once and kept.
+    size_t budget = std::max(options.memory_budget / sizeof(float), (size_t)1);
+    size_t tm = std::clamp(budget / 2 / (n + k), (size_t)1, m);
+    size_t rest = budget - std::min(budget, tm * (n + k));
+    size_t tk = k * n <= rest ? k : std::clamp(rest / (2 * n), (size_t)1, k);
+
+    auto a_rows = [&](size_t i0, size_t rows) { prefetch_pages(A + i0 * k, rows * k * sizeof(float)); };
+    auto b_rows = [&](size_t k0, size_t rows) { prefetch_pages(B + k0 * n, rows * n * sizeof(float)); };
+    a_rows(0, tm);
+    b_rows(0, tk);
+
+    for (size_t i0 = 0; i0 < m; i0 += tm) {
+        size_t mi = std::min(tm, m - i0);
+        bool more_rows = i0 + mi < m;
+        if (more_rows)
+            a_rows(i0 + mi, std::min(tm, m - i0 - mi));
+
+        for (size_t k0 = 0; k0 < k; k0 += tk) {
+            size_t kk = std::min(tk, k - k0);
+            // The next panel of B is the following one, or the first one again for the next block of rows.
+            if (k0 + kk < k)
+                b_rows(k0 + kk, std::min(tk, k - k0 - kk));
+            else if (more_rows && tk < k)
+                b_rows(0, tk);
+
+            Epilogue accumulate { .alpha = 1, .beta = k0 == 0 ? 0.0f : 1.0f };
+            sgemm(mi, n, kk, { A + i0 * k + k0, k, 1 }, { B + k0 * n, n, 1 }, C + i0 * ldc, ldc, accumulate);
+            if (tk < k)
+                evict_pages(B + k0 * n, kk * n * sizeof(float));
+        }
+
+        // This block of C is final: start writing it back and let it and its rows of A go.
+        size_t c_bytes = ((mi - 1) * ldc + n) * sizeof(float);
+        flush_pages(C + i0 * ldc, c_bytes);
+        evict_pages(C + i0 * ldc, c_bytes);
+        evict_pages(A + i0 * k, mi * k * sizeof(float));
+    }
+}
+
+template <ReduceOp Op> static inline double combine(double acc, double value)
+{
+    if constexpr (Op == ReduceOp::MAX)
+        return acc >= value || std::isnan(acc) ? acc : value;
+    else if constexpr (Op == ReduceOp::MIN)
+        return acc <= value || std::isnan(acc) ? acc : value;
+    else
+        return acc + value;
+}
+
+template <ReduceOp Op> static constexpr double identity()
+{
+    if constexpr (Op == ReduceOp::MAX)
+        return -std::numeric_limits<double>::infinity();
+    else if constexpr (Op == ReduceOp::MIN)
+        return std::numeric_limits<double>::infinity();
+    else
+        return 0.0;
+}
+
+// Folds x, viewed as [outer * len, inner] rows, into acc[outer, inner] one tile of rows at a time. Within a tile every
+// (outer index, column chunk) pair is a separate task; when that gives too few tasks to fill the threads, the rows of
+// each pair are split further. Split parts keep their partial results in their own slot, merged in part order after
+// the parallel loop, so the result does not depend on which thread finishes first.
+template <ReduceOp Op>
+static void reduce_rows(const float* x, size_t outer, size_t len, size_t inner, size_t tile_rows, double* acc)
+{
+    size_t rows = outer * len, n_cols = (inner + COLUMN_CHUNK - 1) / COLUMN_CHUNK;
+    prefetch_pages(x, std::min(tile_rows, rows) * inner * sizeof(float));
+    std::vector<double> partials;
+
+    for (size_t r0 = 0; r0 < rows; r0 += tile_rows) {
+        size_t r1 = std::min(rows, r0 + tile_rows);
+        if (r1 < rows)
+            prefetch_pages(x + r1 * inner, std::min(tile_rows, rows - r1) * inner * sizeof(float));
+
+        size_t o_first = r0 / len, n_segments = (r1 - 1) / len - o_first + 1;
+        size_t parts = n_segments * n_cols < 8 ? 8 : 1;
+        size_t n_tasks = n_segments * n_cols * parts;
+        if (parts > 1)
+            partials.assign(n_tasks * COLUMN_CHUNK, identity<Op>());
+
+#pragma omp parallel for num_threads(8) if ((r1 - r0) * inner >= PARALLEL_WORK)
+        for (size_t task = 0; task < n_tasks; task++) {
+            size_t o = o_first + task / (n_cols * parts);
+            size_t c0 = task / parts % n_cols * COLUMN_CHUNK, c1 = std::min(inner, c0 + COLUMN_CHUNK);
+            size_t begin = std::max(r0, o * len), end = std::min(r1, (o + 1) * len);
+            size_t part = task % parts, step = (end - begin + parts - 1) / parts;
+            size_t p0 = std::min(end, begin + part * step), p1 = std::min(end, p0 + step);
+
+            double local[COLUMN_CHUNK];
+            double* partial = parts == 1 ? local : partials.data() + task * COLUMN_CHUNK;
+            if (parts == 1)
+                std::fill(partial, partial + (c1 - c0), identity<Op>());
+            for (size_t r = p0; r < p1; r++) {
+                const float* row = x + r * inner;
+                for (size_t c = c0; c < c1; c++)
+                    partial[c - c0] = combine<Op>(partial[c - c0], row[c]);
+            }
+
+            if (parts == 1) {
+                double* out = acc + o * inner;
+                for (size_t c = c0; c < c1; c++)
+                    out[c] = combine<Op>(out[c], partial[c - c0]);
+            }
+        }
+
+        // Tasks of one (segment, column chunk) pair are consecutive, in part order.
+        for (size_t task = 0; parts > 1 && task < n_tasks; task++) {
+            size_t o = o_first + task / (n_cols * parts);
+            size_t c0 = task / parts % n_cols * COLUMN_CHUNK, c1 = std::min(inner, c0 + COLUMN_CHUNK);
+            const double* partial = partials.data() + task * COLUMN_CHUNK;
+            double* out = acc + o * inner;
+            for (size_t c = c0; c < c1; c++)
+                out[c] = combine<Op>(out[c], partial[c - c0]);
+        }
+
+        evict_pages(x + r0 * inner, (r1 - r0) * inner * sizeof(float));
+    }
+}
+
+Tensor<float> reduce_streamed(const Tensor<float>& x, size_t axis, ReduceOp op, const StreamOptions& options)
+{
+    if (axis >= x.n_dims())
+        throw std::invalid_argument("Axis out of bounds");
+    if (!x.is_contiguous())
+        throw std::invalid_argument("Streamed reductions need a contiguous tensor");
+
+    auto shape = x.shape();
+    size_t outer = 1, inner = 1, len = shape[axis];
+    std::vector<size_t> out_shape;
+    for (size_t d = 0; d < x.n_dims(); d++) {
+        if (d < axis)
+            outer *= shape[d];
+        if (d > axis)
+            inner *= shape[d];
+        if (d != axis)
+            out_shape.push_back(shape[d]);
+    }
+    if (out_shape.empty())
+        out_shape.push_back(1);
+
+    std::vector<double> acc(outer * inner);
+    size_t tile_rows = std::max(options.memory_budget / 2 / std::max(inner * sizeof(float), (size_t)1), (size_t)1);
+    if (len > 0 && inner > 0) {
+        switch (op) {
+        case ReduceOp::MAX:
+            std::fill(acc.begin(), acc.end(), identity<ReduceOp::MAX>());
+            reduce_rows<ReduceOp::MAX>(x.data(), outer, len, inner, tile_rows, acc.data());
+            break;
+        case ReduceOp::MIN:
+            std::fill(acc.begin(), acc.end(), identity<ReduceOp::MIN>());
+            reduce_rows<ReduceOp::MIN>(x.data(), outer, len, inner, tile_rows, acc.data());
+            break;
+        default:
+            reduce_rows<ReduceOp::SUM>(x.data(), outer, len, inner, tile_rows, acc.data());
+        }
+    } else if (len == 0 && (op == ReduceOp::MAX || op == ReduceOp::MIN)) {
+        throw std::invalid_argument("Cannot take the maximum or minimum of an empty axis");
+    }
+
+    auto result = Tensor<float>::empty(out_shape);
+    double scale = op == ReduceOp::MEAN ? 1.0 / (double)len : 1.0;
+    for (size_t i = 0; i < acc.size(); i++)
+        result.data()[i] = (float)(acc[i] * scale);
+    return result;
+}
+
+}
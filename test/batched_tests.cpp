@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "tensile/tensor.h"
+#include "test_utils.h"
+
+using std::vector;
+using Tensile::Tensor;
+
+// Diagonally dominant matrices, so that every inverse is well conditioned.
+static Tensor<float> matrices(size_t batch, size_t n, size_t seed = 1)
+{
+    auto* data = new float[batch * n * n];
+    for (size_t b = 0; b < batch; b++)
+        for (size_t i = 0; i < n; i++)
+            for (size_t j = 0; j < n; j++)
+                data[(b * n + i) * n + j] = 0.1f * (float)((int)(((b + seed) * 31 + i * 7 + j * 3) % 11) - 5)
+                    + (i == j ? (float)n : 0.0f);
+    return Tensor<float>(data, { batch, n, n });
+}
+
+static vector<double> reference_matmul(const float* a, const float* b, size_t n)
+{
+    vector<double> c(n * n, 0.0);
+    for (size_t i = 0; i < n; i++)
+        for (size_t k = 0; k < n; k++)
+            for (size_t j = 0; j < n; j++)
+                c[i * n + j] += (double)a[i * n + k] * b[k * n + j];
+    return c;
+}
+
+// Determinant by Gaussian elimination in double precision.
+static double reference_det(vector<double> m, size_t n)
+{
+    double det = 1;
+    for (size_t c = 0; c < n; c++) {
+        size_t p = c;
+        for (size_t r = c + 1; r < n; r++)
+            if (std::abs(m[r * n + c]) > std::abs(m[p * n + c]))
+                p = r;
+        if (p != c) {
+            for (size_t j = 0; j < n; j++)
+                std::swap(m[c * n + j], m[p * n + j]);
+            det = -det;
+        }
+        det *= m[c * n + c];
+        for (size_t r = c + 1; r < n; r++) {
+            double f = m[r * n + c] / m[c * n + c];
+            for (size_t j = c; j < n; j++)
+                m[r * n + j] -= f * m[c * n + j];
+        }
+    }
+    return det;
+}
+
+TEST(BatchedTests, MatmulEveryOrder)
+{
+    // 37 is not a multiple of the eight matrices per block.
+    for (size_t n = 1; n <= 8; n++) {
+        auto a = matrices(37, n, 1), b = matrices(37, n, 2);
+        auto c = a * b;
+        for (size_t m = 0; m < 37; m++) {
+            auto expected = reference_matmul(a.data() + m * n * n, b.data() + m * n * n, n);
+            for (size_t e = 0; e < n * n; e++)
+                ASSERT_NEAR(c.data()[m * n * n + e], expected[e], 1e-4) << n;
+        }
+    }
+
+    // A single matrix broadcasts over the batch.
+    auto one = matrices(1, 4, 3), many = matrices(20, 4, 4);
+    auto c = one * many;
+    for (size_t m = 0; m < 20; m++) {
+        auto expected = reference_matmul(one.data(), many.data() + m * 16, 4);
+        for (size_t e = 0; e < 16; e++)
+            ASSERT_NEAR(c.data()[m * 16 + e], expected[e], 1e-4);
+    }
+}
+
+TEST(BatchedTests, InverseAndDet)
+{
+    for (size_t n = 1; n <= 8; n++) {
+        auto a = matrices(19, n);
+        auto inv = a.inverse();
+        auto det = a.det();
+        ASSERT_EQ(det.shape()[0], 19);
+
+        auto product = a * inv;
+        for (size_t m = 0; m < 19; m++) {
+            for (size_t i = 0; i < n; i++)
+                for (size_t j = 0; j < n; j++)
+                    ASSERT_NEAR(product.data()[(m * n + i) * n + j], i == j ? 1.0 : 0.0, 1e-5) << n;
+
+            vector<double> mat(a.data() + m * n * n, a.data() + (m + 1) * n * n);
+            double expected = reference_det(mat, n);
+            EXPECT_NEAR(det.data()[m], expected, 1e-5 * std::abs(expected)) << n;
+        }
+    }
+}
+
+TEST(BatchedTests, PivotingAndSingular)
+{
+    // Zero on the diagonal needs a row swap, which also flips the sign of the determinant.
+    auto swap = Tensor<float>(new float[9] { 0, 1, 0, 1, 0, 0, 0, 0, 2 }, { 3, 3 });
+    EXPECT_FLOAT_EQ(swap.det().data()[0], -2.0f);
+    auto inv = swap.inverse();
+    vector<float> expected { 0, 1, 0, 1, 0, 0, 0, 0, 0.5f };
+    EXPECT_EQ(vector<float>(inv.data(), inv.data() + 9), expected);
+
+    auto singular = Tensor<float>(new float[4] { 1, 2, 2, 4 }, { 2, 2 });
+    EXPECT_EQ(singular.det().data()[0], 0.0f);
+    auto zero = Tensor<float>::zeros({ 3, 3 });
+    EXPECT_EQ(zero.det().data()[0], 0.0f);
+
+    auto big = Tensor<float>::zeros({ 9, 9 });
+    EXPECT_THROW(big.inverse(), std::invalid_argument);
+    auto rect = Tensor<float>::zeros({ 2, 3 });
+    EXPECT_THROW(rect.det(), std::invalid_argument);
+}
+
+TEST(BatchedTests, Transform)
+{
+    // Translation by (1, 2, 3) after scaling by 2, applied to 3D points.
+    auto affine = Tensor<float>(new float[16] { 2, 0, 0, 1, 0, 2, 0, 2, 0, 0, 2, 3, 0, 0, 0, 1 }, { 4, 4 });
+    const size_t count = 5000;
+    auto* p = new float[count * 3];
+    for (size_t i = 0; i < count * 3; i++)
+        p[i] = (float)(i % 13) - 6;
+    auto points = Tensor<float>(p, { count, 3 });
+    auto moved = affine.transform(points);
+    ASSERT_EQ(moved.shape()[1], 3);
+    for (size_t i = 0; i < count; i++)
+        for (size_t k = 0; k < 3; k++)
+            ASSERT_EQ(moved.data()[i * 3 + k], 2 * p[i * 3 + k] + (float)(k + 1));
+
+    // Full-length vectors with a matrix per vector.
+    auto ms = matrices(11, 4);
+    auto vs = Tensor<float>::full({ 11, 4 }, 1.0f);
+    auto out = ms.transform(vs);
+    for (size_t i = 0; i < 11; i++)
+        for (size_t r = 0; r < 4; r++) {
+            float sum = 0;
+            for (size_t c = 0; c < 4; c++)
+                sum += ms.data()[(i * 4 + r) * 4 + c];
+            ASSERT_NEAR(out.data()[i * 4 + r], sum, 1e-5);
+        }
+
+    EXPECT_THROW(affine.transform(Tensor<float>::zeros({ 2, 2 })), std::invalid_argument);
+    EXPECT_THROW(ms.transform(Tensor<float>::zeros({ 3, 4 })), std::invalid_argument);
+}
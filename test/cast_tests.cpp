@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "tensile/tensor.h"
+
+using std::vector;
+using Tensile::CastMode;
+using Tensile::Tensor;
+
+// Runs `values`, repeated to a length that is not a multiple of any vector step, through cast() and compares every
+// element with the scalar conversion.
+template <typename S, typename D> static void check_cast(const vector<S>& values, CastMode mode, size_t n = 1003)
+{
+    vector<S> src(n);
+    for (size_t i = 0; i < n; i++)
+        src[i] = values[i % values.size()];
+
+    vector<D> dst(n);
+    Tensile::cast(src.data(), dst.data(), n, mode);
+    for (size_t i = 0; i < n; i++)
+        ASSERT_EQ(dst[i], Tensile::cast_value<D>(src[i], mode)) << i;
+}
+
+TEST(CastTests, FloatToInteger)
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN(), inf = std::numeric_limits<float>::infinity();
+    vector<float> values { 0.0f, -0.7f, 1.9f, -3.5f, 254.6f, 255.0f, 300.0f, -1e9f, 2147483520.0f, 2147483648.0f,
+                           -2147483648.0f, -3e9f, 3e9f, nan, inf, -inf, 65535.5f, -32768.9f };
+
+    for (auto mode : { CastMode::WRAP, CastMode::SATURATE }) {
+        check_cast<float, int32_t>(values, mode);
+        check_cast<float, uint8_t>(values, mode);
+        check_cast<float, int16_t>(values, mode);
+        check_cast<float, int64_t>(values, mode);
+    }
+
+    EXPECT_EQ(Tensile::cast_value<int32_t>(2147483648.0f, CastMode::WRAP), INT32_MAX);
+    EXPECT_EQ(Tensile::cast_value<int32_t>(-3e9f, CastMode::WRAP), INT32_MIN);
+    EXPECT_EQ(Tensile::cast_value<int32_t>(nan, CastMode::WRAP), 0);
+    EXPECT_EQ(Tensile::cast_value<int32_t>(-3.9f, CastMode::WRAP), -3);
+    EXPECT_EQ(Tensile::cast_value<uint8_t>(-1.0f, CastMode::WRAP), 0);
+
+    vector<double> doubles { 0.5, -0.5, 2147483647.9, 2147483648.0, -2147483648.9, -1e12, 1e12, std::nan(""), 42.0 };
+    check_cast<double, int32_t>(doubles, CastMode::WRAP);
+}
+
+TEST(CastTests, IntegerNarrowing)
+{
+    vector<int32_t> values { 0, 1, -1, 127, 128, -128, -129, 255, 256, 32767, 32768, -32768, -32769, 65535, 65536,
+                             INT32_MAX, INT32_MIN, 1000000, -1000000 };
+
+    for (auto mode : { CastMode::WRAP, CastMode::SATURATE }) {
+        check_cast<int32_t, int16_t>(values, mode);
+        check_cast<int32_t, uint16_t>(values, mode);
+        check_cast<int32_t, int8_t>(values, mode);
+        check_cast<int32_t, uint8_t>(values, mode);
+        check_cast<int32_t, int64_t>(values, mode);
+    }
+
+    EXPECT_EQ(Tensile::cast_value<int8_t>(200, CastMode::WRAP), -56);
+    EXPECT_EQ(Tensile::cast_value<int8_t>(200, CastMode::SATURATE), 127);
+    EXPECT_EQ(Tensile::cast_value<uint8_t>(-5, CastMode::SATURATE), 0);
+    EXPECT_EQ(Tensile::cast_value<uint16_t>(-1, CastMode::WRAP), 65535);
+
+    vector<int64_t> wide { 0, -1, INT32_MAX, (int64_t)INT32_MAX + 1, INT32_MIN, (int64_t)INT32_MIN - 1, INT64_MAX,
+                           INT64_MIN, 1LL << 40, -(1LL << 40) };
+    check_cast<int64_t, int32_t>(wide, CastMode::WRAP);
+    check_cast<int64_t, int32_t>(wide, CastMode::SATURATE);
+}
+
+TEST(CastTests, Widening)
+{
+    check_cast<int32_t, float>({ 0, 1, -7, 16777217, INT32_MAX, INT32_MIN }, CastMode::WRAP);
+    check_cast<int32_t, double>({ 0, 1, -7, 16777217, INT32_MAX, INT32_MIN }, CastMode::WRAP);
+    check_cast<uint8_t, float>({ 0, 1, 127, 128, 255 }, CastMode::WRAP);
+    check_cast<float, double>({ 0.1f, -2.5f, 1e30f, std::numeric_limits<float>::infinity() }, CastMode::WRAP);
+    check_cast<double, float>({ 0.1, -2.5, 1e300, 1e-300, 3.0000001 }, CastMode::WRAP);
+    check_cast<int16_t, float>({ 0, -32768, 32767, 5 }, CastMode::WRAP);
+}
+
+TEST(CastTests, Astype)
+{
+    auto ints = Tensor<int32_t>(new int32_t[6] { 1, -2, 3, 300, -300, 7 }, { 2, 3 });
+    auto floats = ints.astype<float>();
+    EXPECT_EQ(floats.shape(), ints.shape());
+    EXPECT_EQ(vector<float>(floats.data(), floats.data() + 6), (vector<float> { 1, -2, 3, 300, -300, 7 }));
+
+    auto bytes = ints.astype<uint8_t>(CastMode::SATURATE);
+    EXPECT_EQ(vector<uint8_t>(bytes.data(), bytes.data() + 6), (vector<uint8_t> { 1, 0, 3, 255, 0, 7 }));
+    auto wrapped = ints.astype<int8_t>();
+    EXPECT_EQ(wrapped.data()[3], (int8_t)44);
+
+    // A strided source is converted in logical order.
+    auto t = ints.transpose().astype<double>();
+    EXPECT_EQ(vector<double>(t.data(), t.data() + 6), (vector<double> { 1, 300, -2, -300, 3, 7 }));
+
+    auto halves = floats.astype<Tensile::float16>().astype<float>();
+    EXPECT_EQ(halves.flat_string(), floats.flat_string());
+    auto from_half = floats.astype<Tensile::bfloat16>().astype<int32_t>();
+    EXPECT_EQ(vector<int32_t>(from_half.data(), from_half.data() + 6), (vector<int32_t> { 1, -2, 3, 300, -300, 7 }));
+
+    // astype_into reuses a buffer, and a large tensor takes the parallel path.
+    const size_t n = 1 << 19;
+    auto* big = new double[n];
+    for (size_t i = 0; i < n; i++)
+        big[i] = (double)i * 0.5 - 1000.0;
+    auto source = Tensor<double>(big, { n });
+    auto out = Tensor<float>::empty({ n });
+    source.astype_into(out);
+    for (size_t i = 0; i < n; i++)
+        ASSERT_EQ(out.data()[i], (float)big[i]);
+
+    auto wrong = Tensor<float>::empty({ 2, 2 });
+    EXPECT_THROW(ints.astype_into(wrong), std::invalid_argument);
+    auto strided = Tensor<float>::empty({ 3, 2 }).transpose();
+    EXPECT_THROW(ints.astype_into(strided), std::invalid_argument);
+}
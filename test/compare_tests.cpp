@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "tensile/tensor.h"
+#include "test_utils.h"
+
+using std::vector;
+using Tensile::Tensor;
+
+static const float NaN = std::numeric_limits<float>::quiet_NaN();
+
+// Values in [-4, 4] with plenty of ties between the two patterns.
+static constexpr FloatPattern TIES { .scale = 1.0f, .modulus = 9, .step = 5 };
+
+template <typename T> static vector<T> values(const Tensor<T>& t)
+{
+    auto c = t.contiguous();
+    return vector<T>(c.data(), c.data() + c.size());
+}
+
+class CompareSizeTest : public ::testing::TestWithParam<size_t> { };
+
+TEST_P(CompareSizeTest, MatchesScalarComparisons)
+{
+    size_t n = GetParam();
+    auto a = float_tensor({ n }, TIES, 0);
+    auto b = float_tensor({ n }, TIES, 3);
+    a.data()[n / 2] = NaN;
+
+    auto eq = a.eq(b), ne = a.ne(b), lt = a.lt(b), le = a.le(b), gt = a.gt(b), ge = a.ge(b), gt0 = a.gt(0.0f);
+    for (size_t i = 0; i < n; i++) {
+        float x = a.data()[i], y = b.data()[i];
+        ASSERT_EQ(eq.data()[i], x == y) << i;
+        ASSERT_EQ(ne.data()[i], x != y) << i;
+        ASSERT_EQ(lt.data()[i], x < y) << i;
+        ASSERT_EQ(le.data()[i], x <= y) << i;
+        ASSERT_EQ(gt.data()[i], x > y) << i;
+        ASSERT_EQ(ge.data()[i], x >= y) << i;
+        ASSERT_EQ(gt0.data()[i], x > 0.0f) << i;
+    }
+}
+
+TEST_P(CompareSizeTest, WhereAndMaskedSelect)
+{
+    size_t n = GetParam();
+    auto a = float_tensor({ n }, TIES, 0);
+    auto b = float_tensor({ n }, TIES, 6);
+    auto mask = a.gt(b);
+
+    auto picked = Tensor<float>::where(mask, a, b);
+    vector<float> expected_select;
+    for (size_t i = 0; i < n; i++) {
+        ASSERT_EQ(picked.data()[i], std::max(a.data()[i], b.data()[i])) << i;
+        if (a.data()[i] > b.data()[i])
+            expected_select.push_back(a.data()[i]);
+    }
+
+    auto selected = a.masked_select(mask);
+    EXPECT_EQ(selected.size(), expected_select.size());
+    EXPECT_EQ(values(selected), expected_select);
+}
+
+TEST_P(CompareSizeTest, AllClose)
+{
+    size_t n = GetParam();
+    auto a = float_tensor({ n }, TIES, 0);
+    auto b = float_tensor({ n }, TIES, 0);
+    EXPECT_TRUE(a.allclose(b));
+
+    b.data()[n - 1] += 1e-6f;
+    EXPECT_TRUE(a.allclose(b, 1e-5, 1e-5));
+
+    b.data()[n - 1] += 1e-3f;
+    EXPECT_FALSE(a.allclose(b));
+    EXPECT_TRUE(a.allclose(b, 0, 1e-2));
+}
+
+INSTANTIATE_TEST_SUITE_P(CompareTests, CompareSizeTest, ::testing::Values(1, 7, 31, 33, 100, 70001, 200003));
+
+TEST(CompareTests, Broadcasting)
+{
+    auto a = float_tensor({ 3, 4 }, TIES, 0);
+    auto row_storage = float_tensor({ 1, 4 }, TIES, 3);
+    auto mask = a.lt(row_storage);
+    ASSERT_EQ(mask.shape()[0], 3);
+    ASSERT_EQ(mask.shape()[1], 4);
+    for (size_t i = 0; i < 3; i++)
+        for (size_t j = 0; j < 4; j++)
+            EXPECT_EQ(mask.data()[i * 4 + j], a.data()[i * 4 + j] < row_storage.data()[j]);
+
+    auto c = float_tensor({ 2, 3 }, TIES, 0);
+    EXPECT_THROW(a.eq(c), std::invalid_argument);
+}
+
+TEST(CompareTests, StridedOperands)
+{
+    auto storage = float_tensor({ 5, 6 }, TIES, 0);
+    auto t = storage.transpose();
+    auto other = t.contiguous();
+    auto mask = t.eq(other);
+    for (size_t i = 0; i < mask.size(); i++)
+        EXPECT_EQ(mask.data()[i], 1);
+    EXPECT_TRUE(t.allclose(other));
+    EXPECT_TRUE(t == other);
+}
+
+TEST(CompareTests, AllCloseSpecialValues)
+{
+    float inf = std::numeric_limits<float>::infinity();
+    auto a = Tensor<float>(new float[3] { inf, -inf, NaN }, { 3 });
+    auto b = Tensor<float>(new float[3] { inf, -inf, NaN }, { 3 });
+    EXPECT_FALSE(a.allclose(b));
+    EXPECT_TRUE(a.allclose(b, 1e-5, 1e-8, true));
+
+    auto c = Tensor<float>(new float[3] { inf, inf, NaN }, { 3 });
+    EXPECT_FALSE(a.allclose(c, 1e-5, 1e-8, true));
+
+    auto d = Tensor<float>(new float[2] { 1, 2 }, { 2 });
+    EXPECT_FALSE(a.allclose(d));
+}
+
+TEST(CompareTests, IntegerAndDouble)
+{
+    auto a = create_tensor({ 4, 5 });
+    auto mask = a.ge(10);
+    auto zeros = Tensor<int>::zeros({ 4, 5 });
+    auto clipped = Tensor<int>::where(mask, a, zeros);
+    for (size_t i = 0; i < 20; i++)
+        EXPECT_EQ(clipped.data()[i], i >= 10 ? (int)i : 0);
+
+    auto upper = a.masked_select(mask);
+    EXPECT_EQ(upper.size(), 10);
+    EXPECT_EQ(upper.data()[0], 10);
+
+    auto x = Tensor<double>::full({ 8 }, 1.0);
+    auto y = Tensor<double>::full({ 8 }, 1.0 + 1e-9);
+    EXPECT_TRUE(x.allclose(y));
+    EXPECT_FALSE(x.allclose(y, 0, 0));
+}
+
+TEST(CompareTests, MismatchedMaskThrows)
+{
+    auto a = float_tensor({ 4 }, TIES, 0);
+    auto mask = Tensor<uint8_t>::zeros({ 5 });
+    EXPECT_THROW(a.masked_select(mask), std::invalid_argument);
+    EXPECT_THROW(Tensor<float>::where(mask, a, a), std::invalid_argument);
+
+    auto none = a.masked_select(a.gt(100.0f));
+    EXPECT_EQ(none.size(), 0);
+}
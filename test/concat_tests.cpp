@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "tensile/tensor.h"
+#include "test_utils.h"
+
+using std::vector;
+using Tensile::Tensor;
+
+static Tensor<int> iota_tensor(const vector<size_t>& shape, int start = 0)
+{
+    return fill_tensor<int>(shape, [=](size_t i) { return start + (int)i; });
+}
+
+TEST(ConcatTests, EveryAxis)
+{
+    auto a = iota_tensor({ 2, 3 }), b = iota_tensor({ 2, 1 }, 100), c = iota_tensor({ 2, 2 }, 200);
+
+    auto cols = Tensor<int>::concat({ a, b, c }, 1);
+    ASSERT_EQ(cols.shape()[0], 2);
+    ASSERT_EQ(cols.shape()[1], 6);
+    EXPECT_EQ(cols.flat_string(), "[0, 1, 2, 100, 200, 201, 3, 4, 5, 101, 202, 203, ]");
+
+    auto rows = Tensor<int>::concat({ a, iota_tensor({ 1, 3 }, 50) });
+    ASSERT_EQ(rows.shape()[0], 3);
+    EXPECT_EQ(rows.flat_string(), "[0, 1, 2, 3, 4, 5, 50, 51, 52, ]");
+
+    // Strided inputs are copied in logical order.
+    auto t = Tensor<int>::concat({ a.transpose(), iota_tensor({ 3, 1 }, 9) }, 1);
+    EXPECT_EQ(t.flat_string(), "[0, 3, 9, 1, 4, 10, 2, 5, 11, ]");
+
+    auto x = iota_tensor({ 2, 2, 3 }), y = iota_tensor({ 2, 1, 3 }, 20);
+    auto middle = Tensor<int>::concat({ x, y }, 1);
+    EXPECT_EQ(middle.flat_string(), "[0, 1, 2, 3, 4, 5, 20, 21, 22, 6, 7, 8, 9, 10, 11, 23, 24, 25, ]");
+
+    EXPECT_THROW(Tensor<int>::concat({}), std::invalid_argument);
+    EXPECT_THROW(Tensor<int>::concat({ a, b }, 0), std::invalid_argument);
+    EXPECT_THROW(Tensor<int>::concat({ a, b }, 2), std::invalid_argument);
+    EXPECT_THROW(Tensor<int>::concat({ a, iota_tensor({ 6 }) }, 0), std::invalid_argument);
+}
+
+TEST(ConcatTests, ManyInputsInParallel)
+{
+    // Enough requests and elements to take the parallel path, including runs longer than one copy piece.
+    vector<Tensor<float>> parts;
+    size_t total = 0;
+    for (size_t i = 0; i < 300; i++) {
+        size_t len = 1 + (i * 37) % 1500;
+        parts.push_back(Tensor<float>::full({ len, 4 }, (float)i));
+        total += len;
+    }
+    parts.push_back(Tensor<float>::full({ 70000, 4 }, -1.0f));
+    total += 70000;
+
+    auto batch = Tensor<float>::concat(parts);
+    ASSERT_EQ(batch.shape()[0], total);
+
+    size_t row = 0;
+    for (size_t i = 0; i < parts.size(); i++) {
+        float expected = i < 300 ? (float)i : -1.0f;
+        for (size_t r = 0; r < parts[i].shape()[0]; r++, row++)
+            for (size_t c = 0; c < 4; c++)
+                ASSERT_EQ(batch.data()[row * 4 + c], expected);
+    }
+}
+
+TEST(ConcatTests, Stack)
+{
+    auto a = iota_tensor({ 2, 3 }), b = iota_tensor({ 2, 3 }, 10);
+
+    auto first = Tensor<int>::stack({ a, b });
+    ASSERT_EQ(first.n_dims(), 3);
+    EXPECT_EQ(first.shape()[0], 2);
+    EXPECT_EQ(first.flat_string(), "[0, 1, 2, 3, 4, 5, 10, 11, 12, 13, 14, 15, ]");
+
+    auto last = Tensor<int>::stack({ a, b }, 2);
+    EXPECT_EQ(last.shape()[2], 2);
+    EXPECT_EQ(last.flat_string(), "[0, 10, 1, 11, 2, 12, 3, 13, 4, 14, 5, 15, ]");
+
+    EXPECT_THROW(Tensor<int>::stack({ a, iota_tensor({ 3, 2 }) }), std::invalid_argument);
+    EXPECT_THROW(Tensor<int>::stack({ a, b }, 3), std::invalid_argument);
+    EXPECT_THROW(Tensor<int>::stack({ iota_tensor({ 1, 1, 1, 1 }) }), std::invalid_argument);
+}
+
+TEST(ConcatTests, SplitAndChunkAreViews)
+{
+    auto x = iota_tensor({ 7, 2 });
+    auto pieces = x.split(3);
+    ASSERT_EQ(pieces.size(), 3);
+    EXPECT_EQ(pieces[0].flat_string(), "[0, 1, 2, 3, 4, 5, ]");
+    EXPECT_EQ(pieces[2].shape()[0], 1);
+    EXPECT_EQ(pieces[2].flat_string(), "[12, 13, ]");
+    EXPECT_TRUE(pieces[1].shares_storage(x));
+
+    // Writes through a piece land in the original.
+    pieces[1][{ 0, 1 }] = -1;
+    EXPECT_EQ((x[{ 3, 1 }]), -1);
+
+    auto cols = x.split({ 1, 1 }, 1);
+    EXPECT_EQ(cols[1].flat_string(), "[1, 3, 5, -1, 9, 11, 13, ]");
+    EXPECT_FALSE(cols[1].is_contiguous());
+
+    auto chunks = x.chunk(3);
+    ASSERT_EQ(chunks.size(), 3);
+    EXPECT_EQ(chunks[0].shape()[0], 3);
+    EXPECT_EQ(chunks[2].shape()[0], 1);
+    EXPECT_EQ(x.chunk(10).size(), 7);
+
+    // Splitting a batch and concatenating it again gives the batch back.
+    EXPECT_EQ(Tensor<int>::concat(x.chunk(4)).flat_string(), x.flat_string());
+    EXPECT_EQ(Tensor<int>::concat(cols, 1).flat_string(), x.flat_string());
+
+    EXPECT_THROW(x.split({ 3, 3 }), std::invalid_argument);
+    EXPECT_THROW(x.split(0), std::invalid_argument);
+    EXPECT_THROW(x.chunk(0), std::invalid_argument);
+    EXPECT_THROW(x.split(1, 2), std::invalid_argument);
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "tensile/conv.h"
+#include "test_utils.h"
+
+using std::vector;
+using Tensile::Conv2dParams;
+using Tensile::Layout;
+using Tensile::Pool2dParams;
+using Tensile::Tensor;
+
+static constexpr FloatPattern VALUES { .scale = 0.1f, .modulus = 23 };
+
+// NCHW [n, c, h, w] -> NHWC [n, h, w, c]
+static Tensor<float> to_nhwc(const Tensor<float>& nchw)
+{
+    auto s = nchw.shape();
+    auto* data = new float[nchw.size()];
+    for (size_t n = 0; n < s[0]; n++)
+        for (size_t c = 0; c < s[1]; c++)
+            for (size_t h = 0; h < s[2]; h++)
+                for (size_t w = 0; w < s[3]; w++)
+                    data[((n * s[2] + h) * s[3] + w) * s[1] + c] = nchw.data()[((n * s[1] + c) * s[2] + h) * s[3] + w];
+    return Tensor<float>(data, { s[0], s[2], s[3], s[1] });
+}
+
+static vector<float> reference_conv(const Tensor<float>& in, const Tensor<float>& weight, const Tensor<float>* bias,
+                                    const Conv2dParams& p, vector<size_t>& out_shape)
+{
+    auto is = in.shape(), ws = weight.shape();
+    size_t oc_count = ws[0], cg = ws[1], kh = ws[2], kw = ws[3], og = oc_count / p.groups;
+    size_t oh_count = (is[2] + 2 * p.pad_h - p.dilation_h * (kh - 1) - 1) / p.stride_h + 1;
+    size_t ow_count = (is[3] + 2 * p.pad_w - p.dilation_w * (kw - 1) - 1) / p.stride_w + 1;
+    out_shape = { is[0], oc_count, oh_count, ow_count };
+
+    vector<float> out(is[0] * oc_count * oh_count * ow_count);
+    for (size_t n = 0; n < is[0]; n++)
+        for (size_t oc = 0; oc < oc_count; oc++)
+            for (size_t oh = 0; oh < oh_count; oh++)
+                for (size_t ow = 0; ow < ow_count; ow++) {
+                    double sum = bias ? bias->data()[oc] : 0;
+                    for (size_t c = 0; c < cg; c++)
+                        for (size_t i = 0; i < kh; i++)
+                            for (size_t j = 0; j < kw; j++) {
+                                long ih = (long)(oh * p.stride_h + i * p.dilation_h) - (long)p.pad_h;
+                                long iw = (long)(ow * p.stride_w + j * p.dilation_w) - (long)p.pad_w;
+                                if (ih < 0 || iw < 0 || ih >= (long)is[2] || iw >= (long)is[3])
+                                    continue;
+                                size_t ic = oc / og * cg + c;
+                                sum += (double)in.data()[((n * is[1] + ic) * is[2] + ih) * is[3] + iw]
+                                    * weight.data()[((oc * cg + c) * kh + i) * kw + j];
+                            }
+                    out[((n * oc_count + oc) * oh_count + oh) * ow_count + ow] = (float)sum;
+                }
+    return out;
+}
+
+// Runs the convolution in both layouts and checks each against the reference.
+static void check_conv(const vector<size_t>& in_shape, const vector<size_t>& weight_shape, const Conv2dParams& params,
+                       bool with_bias = true)
+{
+    auto in = float_tensor(in_shape, VALUES, 1);
+    auto weight = float_tensor(weight_shape, VALUES, 2);
+    auto bias = float_tensor({ weight_shape[0] }, VALUES, 3);
+    const Tensor<float>* bias_ptr = with_bias ? &bias : nullptr;
+
+    vector<size_t> out_shape;
+    auto expected = reference_conv(in, weight, bias_ptr, params, out_shape);
+
+    Conv2dParams nchw = params;
+    nchw.layout = Layout::NCHW;
+    auto out = Tensile::conv2d(in, weight, bias_ptr, nchw);
+    ASSERT_EQ(out.shape()[1], out_shape[1]);
+    ASSERT_EQ(out.shape()[2], out_shape[2]);
+    ASSERT_EQ(out.shape()[3], out_shape[3]);
+    expect_near(out, expected);
+
+    Conv2dParams nhwc = params;
+    nhwc.layout = Layout::NHWC;
+    auto expected_tensor = Tensor<float>(new float[expected.size()], out_shape);
+    std::copy(expected.begin(), expected.end(), expected_tensor.data());
+    auto expected_nhwc = to_nhwc(expected_tensor);
+    auto out_nhwc = Tensile::conv2d(to_nhwc(in), weight, bias_ptr, nhwc);
+    expect_near(out_nhwc, vector<float>(expected_nhwc.data(), expected_nhwc.data() + expected_nhwc.size()));
+}
+
+TEST(ConvTest, Im2colGemm)
+{
+    check_conv({ 2, 6, 9, 11 }, { 5, 6, 3, 3 }, {});
+    check_conv({ 1, 8, 10, 10 }, { 6, 8, 3, 2 }, { 2, 1, 1, 2, 1, 1, 1 }, false);
+    check_conv({ 1, 5, 12, 12 }, { 4, 5, 3, 3 }, { 1, 1, 2, 2, 2, 2, 1 });
+}
+
+TEST(ConvTest, PointwiseReadsInputDirectly)
+{
+    check_conv({ 2, 16, 5, 7 }, { 24, 16, 1, 1 }, {});
+}
+
+TEST(ConvTest, GroupedConvolution)
+{
+    check_conv({ 1, 12, 7, 7 }, { 4, 6, 3, 3 }, { 1, 1, 1, 1, 1, 1, 2 });
+}
+
+TEST(ConvTest, DepthwiseAndSingleChannel)
+{
+    check_conv({ 2, 10, 9, 9 }, { 10, 1, 3, 3 }, { 1, 1, 1, 1, 1, 1, 10 });
+    check_conv({ 1, 4, 11, 8 }, { 8, 1, 3, 3 }, { 2, 2, 1, 1, 1, 1, 4 });  // channel multiplier 2, stride 2
+    check_conv({ 1, 9, 13, 13 }, { 9, 1, 5, 5 }, { 1, 1, 4, 4, 2, 2, 9 }); // dilated
+    check_conv({ 3, 1, 8, 8 }, { 5, 1, 3, 3 }, { 1, 1, 1, 1, 1, 1, 1 });   // one input channel
+}
+
+TEST(ConvTest, SmallChannelDirect)
+{
+    // Direct in NHWC; NCHW lowers these to GEMM.
+    check_conv({ 2, 3, 9, 11 }, { 5, 3, 3, 3 }, {});                              // RGB input layer
+    check_conv({ 1, 4, 10, 10 }, { 6, 4, 3, 2 }, { 2, 1, 1, 2, 1, 1, 1 }, false); // stride 2, padding
+    check_conv({ 1, 3, 12, 12 }, { 4, 3, 3, 3 }, { 1, 1, 2, 2, 2, 2, 1 });        // dilated
+    check_conv({ 1, 6, 7, 7 }, { 4, 3, 3, 3 }, { 1, 1, 1, 1, 1, 1, 2 });          // two groups of three channels
+}
+
+TEST(ConvTest, InvalidShapes)
+{
+    auto in = float_tensor({ 1, 3, 5, 5 }, VALUES);
+    auto weight = float_tensor({ 4, 2, 3, 3 }, VALUES);
+    EXPECT_THROW(Tensile::conv2d(in, weight, nullptr), std::invalid_argument);
+
+    auto big = float_tensor({ 4, 3, 7, 7 }, VALUES);
+    EXPECT_THROW(Tensile::conv2d(in, big, nullptr), std::invalid_argument);
+
+    auto ok = float_tensor({ 4, 3, 3, 3 }, VALUES);
+    auto bias = float_tensor({ 3 }, VALUES);
+    EXPECT_THROW(Tensile::conv2d(in, ok, &bias), std::invalid_argument);
+}
+
+static vector<float> reference_pool(const Tensor<float>& in, const Pool2dParams& p, bool max)
+{
+    auto s = in.shape();
+    size_t oh_count = (s[2] + 2 * p.pad_h - p.kernel_h) / p.stride_h + 1;
+    size_t ow_count = (s[3] + 2 * p.pad_w - p.kernel_w) / p.stride_w + 1;
+
+    vector<float> out;
+    for (size_t nc = 0; nc < s[0] * s[1]; nc++)
+        for (size_t oh = 0; oh < oh_count; oh++)
+            for (size_t ow = 0; ow < ow_count; ow++) {
+                float acc = max ? -std::numeric_limits<float>::infinity() : 0;
+                size_t count = 0;
+                for (size_t i = 0; i < p.kernel_h; i++)
+                    for (size_t j = 0; j < p.kernel_w; j++) {
+                        long ih = (long)(oh * p.stride_h + i) - (long)p.pad_h;
+                        long iw = (long)(ow * p.stride_w + j) - (long)p.pad_w;
+                        if (ih < 0 || iw < 0 || ih >= (long)s[2] || iw >= (long)s[3])
+                            continue;
+                        float v = in.data()[(nc * s[2] + ih) * s[3] + iw];
+                        acc = max ? std::max(acc, v) : acc + v;
+                        count++;
+                    }
+                out.push_back(max ? acc : acc / (float)count);
+            }
+    return out;
+}
+
+TEST(ConvTest, Pooling)
+{
+    auto in = float_tensor({ 2, 11, 9, 10 }, VALUES, 4);
+    for (Pool2dParams p : { Pool2dParams {}, Pool2dParams { 3, 3, 2, 2, 1, 1 }, Pool2dParams { 3, 2, 1, 1, 1, 0 } }) {
+        for (bool max : { true, false }) {
+            auto expected = reference_pool(in, p, max);
+            p.layout = Layout::NCHW;
+            auto out = max ? Tensile::max_pool2d(in, p) : Tensile::avg_pool2d(in, p);
+            expect_near(out, expected);
+
+            auto s = out.shape();
+            auto expected_tensor = Tensor<float>(new float[expected.size()], { s[0], s[1], s[2], s[3] });
+            std::copy(expected.begin(), expected.end(), expected_tensor.data());
+            auto expected_nhwc = to_nhwc(expected_tensor);
+
+            p.layout = Layout::NHWC;
+            auto out_nhwc = max ? Tensile::max_pool2d(to_nhwc(in), p) : Tensile::avg_pool2d(to_nhwc(in), p);
+            expect_near(out_nhwc, vector<float>(expected_nhwc.data(), expected_nhwc.data() + expected_nhwc.size()));
+        }
+    }
+
+    EXPECT_THROW(Tensile::max_pool2d(in, { 2, 2, 2, 2, 2, 0 }), std::invalid_argument);
+}
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "tensile/einsum.h"
+#include "test_utils.h"
+
+using std::string;
+using std::vector;
+using Tensile::Tensor;
+
+// Brute force over every assignment of the labels: out[output labels] += product of the operands.
+static vector<double> reference(const vector<string>& inputs, const string& output,
+                                const vector<const Tensor<float>*>& operands)
+{
+    std::map<char, size_t> sizes;
+    for (size_t t = 0; t < inputs.size(); t++)
+        for (size_t d = 0; d < inputs[t].size(); d++)
+            sizes[inputs[t][d]] = operands[t]->shape()[d];
+
+    string labels;
+    size_t total = 1, out_size = 1;
+    for (auto [label, size] : sizes) {
+        labels.push_back(label);
+        total *= size;
+    }
+    for (char c : output)
+        out_size *= sizes[c];
+
+    vector<double> out(out_size, 0.0);
+    std::map<char, size_t> at;
+    for (size_t flat = 0; flat < total; flat++) {
+        for (size_t i = labels.size(), rem = flat; i-- > 0;) {
+            at[labels[i]] = rem % sizes[labels[i]];
+            rem /= sizes[labels[i]];
+        }
+
+        double product = 1;
+        for (size_t t = 0; t < inputs.size(); t++) {
+            size_t offset = 0;
+            for (size_t d = 0; d < inputs[t].size(); d++)
+                offset += at[inputs[t][d]] * operands[t]->strides()[d];
+            product *= operands[t]->data()[offset];
+        }
+
+        size_t o = 0;
+        for (char c : output)
+            o = o * sizes[c] + at[c];
+        out[o] += product;
+    }
+    return out;
+}
+
+static void expect_matches(const Tensor<float>& result, const vector<double>& expected)
+{
+    ASSERT_EQ(result.size(), expected.size());
+    auto c = result.contiguous();
+    for (size_t i = 0; i < expected.size(); i++)
+        ASSERT_NEAR(c.data()[i], expected[i], 1e-4) << i;
+}
+
+TEST(EinsumTests, PairwiseContractions)
+{
+    auto a = float_tensor({ 7, 5 }, 1), b = float_tensor({ 5, 9 }, 2), c = float_tensor({ 9, 5 }, 3);
+    expect_matches(Tensile::einsum("ij,jk->ik", a, b), reference({ "ij", "jk" }, "ik", { &a, &b }));
+    expect_matches(Tensile::einsum("ij,kj->ik", a, c), reference({ "ij", "kj" }, "ik", { &a, &c }));
+    expect_matches(Tensile::einsum("ij,jk->ki", a, b), reference({ "ij", "jk" }, "ki", { &a, &b }));
+
+    // Nothing to sum: outer and elementwise products.
+    auto v = float_tensor({ 3 }, 4);
+    expect_matches(Tensile::einsum("ij,k->ijk", a, v), reference({ "ij", "k" }, "ijk", { &a, &v }));
+    auto a2 = float_tensor({ 7, 5 }, 5);
+    expect_matches(Tensile::einsum("ij,ij->ij", a, a2), reference({ "ij", "ij" }, "ij", { &a, &a2 }));
+
+    // Implicit output: labels used once, alphabetically.
+    auto implicit = Tensile::einsum("ij,jk", a, b);
+    EXPECT_EQ(implicit.shape()[0], 7);
+    EXPECT_EQ(implicit.shape()[1], 9);
+}
+
+TEST(EinsumTests, BatchedAndHigherRank)
+{
+    auto x = float_tensor({ 4, 6, 5 }, 1), y = float_tensor({ 4, 5, 3 }, 2);
+    expect_matches(Tensile::einsum("bij,bjk->bik", x, y), reference({ "bij", "bjk" }, "bik", { &x, &y }));
+
+    // Attention-style scores with the batch axis in the middle and two contracted axes.
+    auto q = float_tensor({ 3, 2, 4, 5 }, 3), k = float_tensor({ 3, 2, 6, 5 }, 4);
+    expect_matches(Tensile::einsum("bhqd,bhkd->bhqk", q, k), reference({ "bhqd", "bhkd" }, "bhqk", { &q, &k }));
+    expect_matches(Tensile::einsum("bhqd,bhkd->hqk", q, k), reference({ "bhqd", "bhkd" }, "hqk", { &q, &k }));
+
+    // Many small batches are spread over threads.
+    auto s = float_tensor({ 64, 4, 4 }, 5), t = float_tensor({ 64, 4, 4 }, 6);
+    expect_matches(Tensile::einsum("bij,bjk->bik", s, t), reference({ "bij", "bjk" }, "bik", { &s, &t }));
+}
+
+TEST(EinsumTests, LargeElementwiseAndBroadcast)
+{
+    // Every label is a batch label, so each output element is a 1x1x1 product; these must not go through sgemm one
+    // element at a time.
+    auto a = float_tensor({ 1000, 1000 }, 1), b = float_tensor({ 1000, 1000 }, 2);
+    auto product = Tensile::einsum("ij,ij->ij", a, b);
+    vector<float> expected(a.size());
+    for (size_t i = 0; i < a.size(); i++)
+        expected[i] = a.data()[i] * b.data()[i];
+    expect_near(product, expected);
+
+    auto v = float_tensor({ 1000 }, 3);
+    auto scaled = Tensile::einsum("ij,j->ij", a, v);
+    for (size_t i = 0; i < a.size(); i++)
+        expected[i] = a.data()[i] * v.data()[i % 1000];
+    expect_near(scaled, expected);
+}
+
+TEST(EinsumTests, SingleOperand)
+{
+    auto m = float_tensor({ 6, 6 }, 2);
+    expect_matches(Tensile::einsum("ii->i", m), reference({ "ii" }, "i", { &m }));
+    expect_matches(Tensile::einsum("ii", m), reference({ "ii" }, "", { &m }));
+    expect_matches(Tensile::einsum("ij->ji", m), reference({ "ij" }, "ji", { &m }));
+    expect_matches(Tensile::einsum("ij->", m), reference({ "ij" }, "", { &m }));
+    expect_matches(Tensile::einsum("ij->j", m), reference({ "ij" }, "j", { &m }));
+}
+
+TEST(EinsumTests, MultiOperandChain)
+{
+    // The greedy order contracts the small end first; the value must not depend on the order.
+    auto a = float_tensor({ 40, 3 }, 1), b = float_tensor({ 3, 30 }, 2), c = float_tensor({ 30, 2 }, 3);
+    auto d = float_tensor({ 2, 20 }, 4);
+    expect_matches(Tensile::einsum("ij,jk,kl,lm->im", a, b, c, d),
+                   reference({ "ij", "jk", "kl", "lm" }, "im", { &a, &b, &c, &d }));
+
+    // A label shared by three operands stays until its last use.
+    auto x = float_tensor({ 4, 5 }, 5), y = float_tensor({ 4, 6 }, 6), z = float_tensor({ 4, 5, 6 }, 7);
+    expect_matches(Tensile::einsum("ij,ik,ijk->i", x, y, z), reference({ "ij", "ik", "ijk" }, "i", { &x, &y, &z }));
+}
+
+TEST(EinsumTests, StridedOperands)
+{
+    auto storage = float_tensor({ 9, 7 }, 1);
+    auto at = storage.transpose();
+    auto b = float_tensor({ 4, 9, 5 }, 2);
+    auto bp = b.permute({ 1, 0, 2 });
+    expect_matches(Tensile::einsum("ij,jbk->bik", at, bp), reference({ "ij", "jbk" }, "bik", { &at, &bp }));
+}
+
+TEST(EinsumTests, Tensordot)
+{
+    auto a = float_tensor({ 3, 4, 5 }, 1), b = float_tensor({ 4, 5, 6 }, 2);
+    expect_matches(Tensile::tensordot(a, b, 2), reference({ "abc", "bcd" }, "ad", { &a, &b }));
+
+    auto c = float_tensor({ 5, 2, 3 }, 3);
+    expect_matches(Tensile::tensordot(a, c, { 0, 2 }, { 2, 0 }), reference({ "abc", "cxa" }, "bx", { &a, &c }));
+
+    EXPECT_THROW(Tensile::tensordot(a, c, { 1 }, { 0 }), std::invalid_argument);
+    EXPECT_THROW(Tensile::tensordot(a, b, 4), std::invalid_argument);
+}
+
+TEST(EinsumTests, InvalidSpecs)
+{
+    auto a = float_tensor({ 2, 3 }), b = float_tensor({ 4, 5 });
+    EXPECT_THROW(Tensile::einsum("ij,jk->ik", a, b), std::invalid_argument);
+    EXPECT_THROW(Tensile::einsum("ij->ik", a), std::invalid_argument);
+    EXPECT_THROW(Tensile::einsum("ijk->i", a), std::invalid_argument);
+    EXPECT_THROW(Tensile::einsum("ij,kl", a), std::invalid_argument);
+    EXPECT_THROW(Tensile::einsum("i.j->i", a), std::invalid_argument);
+}
+
+TEST(PermuteTests, ReordersAxesWithoutCopying)
+{
+    auto t = create_tensor({ 2, 3, 4 });
+    auto p = t.permute({ 2, 0, 1 });
+    EXPECT_EQ(p.shape(), (std::array<size_t, 4> { 4, 2, 3, 0 }));
+    EXPECT_TRUE(p.shares_storage(t));
+    auto c = p.contiguous();
+    for (size_t i = 0; i < 4; i++)
+        for (size_t j = 0; j < 2; j++)
+            for (size_t k = 0; k < 3; k++)
+                EXPECT_EQ(c.data()[(i * 2 + j) * 3 + k], (int)((j * 3 + k) * 4 + i));
+
+    EXPECT_THROW(t.permute({ 0, 0, 1 }), std::invalid_argument);
+    EXPECT_THROW(t.permute({ 0, 1 }), std::invalid_argument);
+}
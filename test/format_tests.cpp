@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include "tensile/tensor.h"
+#include "test_utils.h"
+
+using Tensile::FormatOptions;
+using Tensile::Tensor;
+
+TEST(FormatTests, NestedMatchesLayout)
+{
+    auto t = create_tensor({ 3, 4 });
+    EXPECT_EQ(t.to_string(), "Tensor([\n  [0, 1, 2, 3], \n  [4, 5, 6, 7], \n  [8, 9, 10, 11]\n], shape=[3, 4])");
+
+    auto v = create_tensor({ 5 });
+    EXPECT_EQ(v.to_string(), "Tensor([0, 1, 2, 3, 4], shape=[5])");
+
+    auto c = create_tensor({ 2, 1, 2 });
+    EXPECT_EQ(c.to_string(), "Tensor([\n  [\n    [0, 1]\n  ], \n  [\n    [2, 3]\n  ]\n], shape=[2, 1, 2])");
+
+    EXPECT_EQ(Tensor<int>().to_string(), "Tensor([], shape=[])");
+}
+
+TEST(FormatTests, FlatAndStrided)
+{
+    auto t = create_tensor({ 2, 3 });
+    EXPECT_EQ(t.flat_string(), "[0, 1, 2, 3, 4, 5, ]");
+    auto tt = t.transpose();
+    EXPECT_EQ(tt.flat_string(), "[0, 3, 1, 4, 2, 5, ]");
+    EXPECT_EQ(tt.to_string(), "Tensor([\n  [0, 3], \n  [1, 4], \n  [2, 5]\n], shape=[3, 2])");
+}
+
+TEST(FormatTests, FloatingPrecision)
+{
+    auto f = Tensor<float>(new float[3] { 1.5f, -0.25f, 100.0f }, { 3 });
+    // Same digits as std::to_string by default.
+    EXPECT_EQ(f.flat_string(), "[" + std::to_string(1.5f) + ", " + std::to_string(-0.25f) + ", "
+                  + std::to_string(100.0f) + ", ]");
+    EXPECT_EQ(f.to_string({ .precision = 2 }), "Tensor([1.50, -0.25, 100.00], shape=[3])");
+
+    auto h = Tensor<Tensile::float16>::full({ 2 }, Tensile::float16(0.5f));
+    EXPECT_EQ(h.flat_string({ .precision = 1, .threshold = SIZE_MAX }), "[0.5, 0.5, ]");
+
+    auto big = Tensor<double>::full({ 1 }, 1e300);
+    EXPECT_EQ(big.flat_string().size(), std::to_string(1e300).size() + 4);
+}
+
+TEST(FormatTests, Summarization)
+{
+    auto t = create_tensor({ 10, 10 });
+    FormatOptions opts { .threshold = 50, .edge_items = 2 };
+    EXPECT_EQ(t.to_string(opts), "Tensor([\n  [0, 1, ..., 8, 9], \n  [10, 11, ..., 18, 19], \n  ..., \n"
+                                 "  [80, 81, ..., 88, 89], \n  [90, 91, ..., 98, 99]\n], shape=[10, 10])");
+    EXPECT_EQ(t.flat_string(opts), "[0, 1, ..., 98, 99, ]");
+
+    // Below the threshold nothing is elided, and flat_string never summarizes by default.
+    EXPECT_EQ(t.to_string().find("..."), std::string::npos);
+    auto large = create_tensor({ 2000 });
+    EXPECT_EQ(large.flat_string().find("..."), std::string::npos);
+    EXPECT_EQ(large.to_string(), "Tensor([0, 1, 2, ..., 1997, 1998, 1999], shape=[2000])");
+}
+
+TEST(FormatTests, StreamsMatchStrings)
+{
+    auto t = create_tensor({ 40, 50 });
+    FormatOptions full { .threshold = SIZE_MAX };
+
+    std::ostringstream nested, flat, summarized;
+    t.write(nested, full);
+    t.write_flat(flat);
+    summarized << t;
+
+    EXPECT_EQ(nested.str(), t.to_string(full));
+    EXPECT_EQ(flat.str(), t.flat_string());
+    EXPECT_EQ(summarized.str(), t.to_string());
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "tensile/tensor.h"
+#include "test_utils.h"
+
+using std::vector;
+using Tensile::Tensor;
+
+static Tensor<float> iota_float(const vector<size_t>& shape)
+{
+    return fill_tensor<float>(shape, [](size_t i) { return (float)i * 0.5f; });
+}
+
+// Pseudo-random indices in [0, bound).
+template <typename I> static Tensor<I> indices(const vector<size_t>& shape, size_t bound, size_t seed = 1)
+{
+    return fill_tensor<I>(shape, [=](size_t i) { return (i * 7919 + seed * 104729) % bound; });
+}
+
+TEST(GatherTests, IndexSelectRows)
+{
+    // Embedding lookup: rows of a [vocab, dim] table.
+    auto table = iota_float({ 50, 24 });
+    auto ids = Tensor<int64_t>(new int64_t[4] { 3, 0, 49, 3 }, { 4 });
+    auto rows = table.index_select(0, ids);
+
+    ASSERT_EQ(rows.shape()[0], 4);
+    ASSERT_EQ(rows.shape()[1], 24);
+    for (size_t i = 0; i < 4; i++)
+        for (size_t k = 0; k < 24; k++)
+            EXPECT_EQ(rows.data()[i * 24 + k], table.data()[ids.data()[i] * 24 + k]);
+}
+
+TEST(GatherTests, IndexSelectInnerAxes)
+{
+    auto x = iota_float({ 3, 20, 5 });
+    auto idx = indices<int32_t>({ 11 }, 20);
+    auto mid = x.index_select(1, idx);
+    for (size_t o = 0; o < 3; o++)
+        for (size_t i = 0; i < 11; i++)
+            for (size_t k = 0; k < 5; k++)
+                ASSERT_EQ(mid.data()[(o * 11 + i) * 5 + k], x.data()[(o * 20 + idx.data()[i]) * 5 + k]);
+
+    auto last_idx = indices<int32_t>({ 13 }, 5);
+    auto last = x.index_select(2, last_idx);
+    for (size_t r = 0; r < 60; r++)
+        for (size_t i = 0; i < 13; i++)
+            ASSERT_EQ(last.data()[r * 13 + i], x.data()[r * 5 + last_idx.data()[i]]);
+
+    auto ints = create_tensor({ 4, 3 });
+    auto picked = ints.index_select(1, Tensor<int>(new int[2] { 2, 0 }, { 2 }));
+    EXPECT_EQ(picked.flat_string(), "[2, 0, 5, 3, 8, 6, 11, 9, ]");
+}
+
+TEST(GatherTests, Take)
+{
+    auto x = iota_float({ 300, 301 });
+    auto idx = indices<int64_t>({ 100, 777 }, x.size());
+    auto taken = x.take(idx);
+
+    ASSERT_EQ(taken.shape()[0], 100);
+    ASSERT_EQ(taken.shape()[1], 777);
+    for (size_t i = 0; i < idx.size(); i++)
+        ASSERT_EQ(taken.data()[i], x.data()[idx.data()[i]]);
+
+    // Indices address the row-major order, also for strided views.
+    auto storage = create_tensor({ 2, 3 });
+    auto t = storage.transpose();
+    auto flat = t.take(Tensor<int>(new int[3] { 0, 1, 5 }, { 3 }));
+    EXPECT_EQ(flat.flat_string(), "[0, 3, 5, ]");
+}
+
+TEST(GatherTests, Gather)
+{
+    for (size_t axis = 0; axis < 3; axis++) {
+        auto x = iota_float({ 6, 7, 9 });
+        vector<size_t> index_shape { 6, 7, 9 };
+        index_shape[axis] = 12;
+        auto idx = indices<int32_t>(index_shape, x.shape()[axis], axis);
+        auto g = x.gather(axis, idx);
+
+        auto s = x.strides();
+        for (size_t i = 0; i < index_shape[0]; i++) {
+            for (size_t j = 0; j < index_shape[1]; j++) {
+                for (size_t k = 0; k < index_shape[2]; k++) {
+                    size_t p = (i * index_shape[1] + j) * index_shape[2] + k;
+                    size_t pos[3] = { i, j, k };
+                    pos[axis] = idx.data()[p];
+                    ASSERT_EQ(g.data()[p], x.data()[pos[0] * s[0] + pos[1] * s[1] + pos[2] * s[2]]) << axis;
+                }
+            }
+        }
+    }
+
+    auto d = Tensor<double>::full({ 2, 3 }, 1.0);
+    EXPECT_THROW(d.gather(1, indices<int>({ 3, 3 }, 3)), std::invalid_argument);
+    EXPECT_THROW(d.gather(1, Tensor<int>::full({ 2, 1 }, 3)), std::out_of_range);
+}
+
+TEST(GatherTests, ScatterAndScatterAdd)
+{
+    auto base = Tensor<float>::zeros({ 4, 5 });
+    auto idx = Tensor<int>(new int[6] { 0, 4, 2, 4, 4, 1 }, { 2, 3 });
+    auto src = Tensor<float>(new float[6] { 1, 2, 3, 4, 5, 6 }, { 2, 3 });
+
+    // Along axis 1 with index [2, 3]: the index must cover every row of the target outside the axis.
+    EXPECT_THROW(base.scatter(1, idx, src), std::invalid_argument);
+
+    auto target = Tensor<float>::zeros({ 2, 5 });
+    auto s = target.scatter(1, idx, src);
+    EXPECT_EQ(s.flat_string({ .precision = 0, .threshold = SIZE_MAX }), "[1, 0, 3, 0, 2, 0, 6, 0, 0, 5, ]");
+
+    auto a = target.scatter_add(1, idx, src);
+    EXPECT_EQ(a.flat_string({ .precision = 0, .threshold = SIZE_MAX }), "[1, 0, 3, 0, 2, 0, 6, 0, 0, 9, ]");
+
+    // The original is left untouched.
+    for (size_t i = 0; i < target.size(); i++)
+        EXPECT_EQ(target.data()[i], 0.0f);
+}
+
+// Many colliding indices along axis 0: the sums must come out bit-identical to a serial accumulation in index order.
+TEST(GatherTests, ScatterAddDeterministic)
+{
+    const size_t rows = 4000, cols = 96, targets = 17;
+    auto idx = indices<int32_t>({ rows, cols }, targets);
+    auto src_storage = iota_float({ rows, cols });
+    auto src = src_storage * 0.001f;
+    auto base = Tensor<float>::full({ targets, cols }, 0.25f);
+    auto out = base.scatter_add(0, idx, src);
+
+    vector<float> expected(targets * cols, 0.25f);
+    for (size_t j = 0; j < rows; j++)
+        for (size_t k = 0; k < cols; k++)
+            expected[idx.data()[j * cols + k] * cols + k] += src.data()[j * cols + k];
+    EXPECT_EQ(vector<float>(out.data(), out.data() + out.size()), expected);
+
+    // Plain scatter keeps the last write in index order.
+    auto last = base.scatter(0, idx, src);
+    vector<float> expected_last(targets * cols, 0.25f);
+    for (size_t j = 0; j < rows; j++)
+        for (size_t k = 0; k < cols; k++)
+            expected_last[idx.data()[j * cols + k] * cols + k] = src.data()[j * cols + k];
+    EXPECT_EQ(vector<float>(last.data(), last.data() + last.size()), expected_last);
+}
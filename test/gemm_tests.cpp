@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "tensile/gemm.h"
+#include "test_utils.h"
+
+using std::vector;
+using Tensile::Activation;
+using Tensile::Epilogue;
+using Tensile::Tensor;
+
+static float reference_activation(float x, Activation activation)
+{
+    switch (activation) {
+    case Activation::RELU:
+        return std::max(x, 0.0f);
+    case Activation::SIGMOID:
+        return 1.0f / (1.0f + std::exp(-x));
+    case Activation::GELU:
+        return 0.5f * x * (1.0f + std::tanh(0.7978845608f * (x + 0.044715f * x * x * x)));
+    default:
+        return x;
+    }
+}
+
+// activation(alpha * a·b + beta * c + bias) computed element by element; `bias(i, j)` returns the broadcast bias.
+template <typename Bias>
+static vector<float> reference(const Tensor<float>& a, const Tensor<float>& b, const vector<float>& c,
+                               const Epilogue& ep, Bias bias)
+{
+    size_t m = a.shape()[0], k = a.shape()[1], n = b.shape()[1];
+    auto ac = a.contiguous(), bc = b.contiguous();
+    vector<float> out(m * n);
+    for (size_t i = 0; i < m; i++)
+        for (size_t j = 0; j < n; j++) {
+            double sum = 0;
+            for (size_t p = 0; p < k; p++)
+                sum += (double)ac.data()[i * k + p] * bc.data()[p * n + j];
+            float value = ep.alpha * (float)sum + bias(i, j);
+            if (ep.beta != 0)
+                value += ep.beta * c[i * n + j];
+            out[i * n + j] = reference_activation(value, ep.activation);
+        }
+    return out;
+}
+
+TEST(GemmTest, PlainProductMatchesMatmul)
+{
+    // Odd sizes exercise the edge tiles; k > 256 splits the inner dimension into several blocks.
+    for (auto [m, k, n] : vector<std::array<size_t, 3>> { { 1, 1, 1 }, { 7, 13, 17 }, { 64, 300, 40 } }) {
+        auto a = float_tensor({ m, k }, 1), b = float_tensor({ k, n }, 2);
+        expect_near(Tensile::matmul_fused(a, b), reference(a, b, {}, {}, [](size_t, size_t) { return 0.0f; }));
+    }
+}
+
+TEST(GemmTest, BiasAndActivations)
+{
+    auto a = float_tensor({ 19, 33 }, 3), b = float_tensor({ 33, 21 }, 4);
+    auto bias = float_tensor({ 21 }, 5);
+    auto bias_at = [&](size_t, size_t j) { return bias.data()[j]; };
+
+    for (auto activation : { Activation::NONE, Activation::RELU, Activation::GELU, Activation::SIGMOID }) {
+        Epilogue ep { 0.5f, 0, activation };
+        expect_near(Tensile::matmul_fused(a, b, bias, ep), reference(a, b, {}, ep, bias_at));
+    }
+}
+
+TEST(GemmTest, BroadcastBiasShapes)
+{
+    auto a = float_tensor({ 9, 10 }, 1), b = float_tensor({ 10, 18 }, 2);
+    Epilogue ep { 1, 0, Activation::RELU };
+
+    auto row = float_tensor({ 1, 18 }, 3);
+    expect_near(Tensile::matmul_fused(a, b, row, ep),
+                reference(a, b, {}, ep, [&](size_t, size_t j) { return row.data()[j]; }));
+
+    auto column = float_tensor({ 9, 1 }, 4);
+    expect_near(Tensile::matmul_fused(a, b, column, ep),
+                reference(a, b, {}, ep, [&](size_t i, size_t) { return column.data()[i]; }));
+
+    auto full = float_tensor({ 9, 18 }, 5);
+    expect_near(Tensile::matmul_fused(a, b, full, ep),
+                reference(a, b, {}, ep, [&](size_t i, size_t j) { return full.data()[i * 18 + j]; }));
+
+    auto wrong = float_tensor({ 18, 9 });
+    EXPECT_THROW(Tensile::matmul_fused(a, b, wrong, ep), std::invalid_argument);
+}
+
+TEST(GemmTest, StridedOperands)
+{
+    auto a = float_tensor({ 20, 12 }, 1), b = float_tensor({ 17, 20 }, 2);
+    auto at = a.transpose(), bt = b.transpose();
+
+    expect_near(Tensile::matmul_fused(at, bt), reference(at, bt, {}, {}, [](size_t, size_t) { return 0.0f; }));
+}
+
+TEST(GemmTest, AccumulatesIntoOutputWithBeta)
+{
+    auto a = float_tensor({ 13, 260 }, 1), b = float_tensor({ 260, 35 }, 2);
+    auto c = float_tensor({ 13, 35 }, 3);
+    auto bias = float_tensor({ 35 }, 4);
+    vector<float> c_before(c.data(), c.data() + c.size());
+
+    Epilogue ep { 2, 0.5f, Activation::NONE };
+    Tensile::matmul_fused_into(a, b, &bias, c, ep);
+
+    expect_near(c, reference(a, b, c_before, ep, [&](size_t, size_t j) { return bias.data()[j]; }));
+}
+
+TEST(GemmTest, InvalidShapes)
+{
+    auto a = float_tensor({ 3, 4 }), b = float_tensor({ 5, 6 });
+    EXPECT_THROW(Tensile::matmul_fused(a, b), std::invalid_argument);
+
+    auto b_ok = float_tensor({ 4, 6 }), c = float_tensor({ 6, 3 });
+    EXPECT_THROW(Tensile::matmul_fused_into(a, b_ok, nullptr, c), std::invalid_argument);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tensile/gemm.h"
+#include "tensile/gemm_tune.h"
+#include "test_utils.h"
+
+using std::vector;
+using Tensile::GemmConfig;
+using Tensile::MatrixRef;
+
+// Starts each test from an empty table, after the first-use load of the default cache has happened.
+class GemmTuneTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        Tensile::gemm_config(1, 1, 1);
+        Tensile::clear_gemm_tuning();
+    }
+
+    void TearDown() override { Tensile::clear_gemm_tuning(); }
+};
+
+TEST_F(GemmTuneTest, BlockingsAgree)
+{
+    const size_t m = 77, n = 133, k = 301;
+    auto a = float_tensor({ m, k }, 1), b = float_tensor({ k, n }, 2);
+    vector<float> expected(m * n);
+    Tensile::sgemm(m, n, k, { a.data(), k, 1 }, { b.data(), n, 1 }, expected.data(), n, {});
+
+    for (GemmConfig config : { GemmConfig { 6, 32, 16, 1, 1 }, GemmConfig { 48, 64, 64, 2, 3 },
+                               GemmConfig { 240, 512, 8192, 8, 8 } }) {
+        vector<float> c(m * n);
+        Tensile::sgemm_with(config, m, n, k, { a.data(), k, 1 }, { b.data(), n, 1 }, c.data(), n, {});
+        for (size_t i = 0; i < c.size(); i++)
+            ASSERT_NEAR(c[i], expected[i], 1e-4) << config.mc << " " << config.kc << " " << config.nc;
+    }
+
+    vector<float> c(m * n);
+    EXPECT_THROW(Tensile::sgemm_with(GemmConfig { 100, 64, 64, 1, 1 }, m, n, k, { a.data(), k, 1 },
+                                     { b.data(), n, 1 }, c.data(), n, {}),
+                 std::invalid_argument);
+}
+
+TEST_F(GemmTuneTest, Buckets)
+{
+    auto bucket = Tensile::shape_bucket(1, 64, 65);
+    EXPECT_EQ(bucket.m, 0);
+    EXPECT_EQ(bucket.n, 6);
+    EXPECT_EQ(bucket.k, 7);
+
+    GemmConfig custom { 48, 128, 1024, 2, 1 };
+    Tensile::set_gemm_config(100, 100, 100, custom);
+    EXPECT_EQ(Tensile::gemm_config(65, 128, 120), custom);
+    EXPECT_EQ(Tensile::gemm_config(64, 128, 120), GemmConfig {});
+    EXPECT_FALSE(Tensile::cpu_model().empty());
+}
+
+TEST_F(GemmTuneTest, CacheRoundTrip)
+{
+    std::string path = ::testing::TempDir() + "tensile_gemm_tuning_test.txt";
+    {
+        // An entry for another machine must survive a load and save.
+        std::ofstream out(path);
+        out << "# comment\nSome Other CPU\t5 5 5\t72 128 2048 1 16\nnot an entry\n";
+    }
+
+    GemmConfig custom { 96, 192, 4096, 8, 2 };
+    Tensile::set_gemm_config(500, 20, 3000, custom);
+    ASSERT_TRUE(Tensile::load_gemm_tuning(path));
+    ASSERT_TRUE(Tensile::save_gemm_tuning(path));
+
+    Tensile::clear_gemm_tuning();
+    EXPECT_EQ(Tensile::gemm_config(500, 20, 3000), GemmConfig {});
+    ASSERT_TRUE(Tensile::load_gemm_tuning(path));
+    EXPECT_EQ(Tensile::gemm_config(500, 20, 3000), custom);
+
+    std::ifstream in(path);
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT_NE(text.find("Some Other CPU\t5 5 5\t72 128 2048 1 16\n"), std::string::npos);
+    EXPECT_NE(text.find(Tensile::cpu_model() + "\t9 5 12\t96 192 4096 8 2\n"), std::string::npos);
+    EXPECT_EQ(text.find("not an entry"), std::string::npos);
+
+    std::remove(path.c_str());
+    EXPECT_FALSE(Tensile::load_gemm_tuning(path));
+}
+
+TEST_F(GemmTuneTest, ConcurrentSaves)
+{
+    auto dir = std::filesystem::path(::testing::TempDir()) / "tensile_gemm_tuning_concurrent";
+    std::filesystem::remove_all(dir);
+    std::string path = (dir / "cache.txt").string();
+
+    for (size_t i = 0; i < 20; i++)
+        Tensile::set_gemm_config(1 << i, 64, 64, GemmConfig { 48, 64, 64, 2, 3 });
+
+    // Every writer renames a complete file of its own, and no temporary file is left behind.
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 8; t++)
+        writers.emplace_back([&] {
+            for (int r = 0; r < 10; r++)
+                EXPECT_TRUE(Tensile::save_gemm_tuning(path));
+        });
+    for (auto& writer : writers)
+        writer.join();
+
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator()), 1);
+    Tensile::clear_gemm_tuning();
+    ASSERT_TRUE(Tensile::load_gemm_tuning(path));
+    EXPECT_EQ(Tensile::gemm_config(1 << 19, 64, 64), (GemmConfig { 48, 64, 64, 2, 3 }));
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_F(GemmTuneTest, TuneRecordsWinner)
+{
+    auto tuned = Tensile::tune_gemm(40, 48, 64);
+    EXPECT_TRUE(tuned.valid());
+    EXPECT_EQ(Tensile::gemm_config(40, 48, 64), tuned);
+
+    // Products in the same bucket now run with the tuned blocking.
+    const size_t m = 33, n = 40, k = 50;
+    auto a = float_tensor({ m, k }, 3), b = float_tensor({ k, n }, 4);
+    vector<float> c(m * n);
+    Tensile::sgemm(m, n, k, { a.data(), k, 1 }, { b.data(), n, 1 }, c.data(), n, {});
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            float expected = 0;
+            for (size_t p = 0; p < k; p++)
+                expected += a.data()[i * k + p] * b.data()[p * n + j];
+            ASSERT_NEAR(c[i * n + j], expected, 1e-4);
+        }
+    }
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "tensile/tensor.h"
+#include "test_utils.h"
+
+using std::vector;
+using Ind = std::vector<size_t>;
+using Tensile::Tensor;
+
+static constexpr FloatPattern VALUES { .scale = 0.25f, .modulus = 11 };
+
+static float element(const Tensor<float>& tensor, size_t i, size_t j)
+{
+    auto strides = tensor.strides();
+    return tensor.data()[i * strides[0] + j * strides[1]];
+}
+
+static vector<float> reference_matvec(const Tensor<float>& a, const Tensor<float>& x)
+{
+    vector<float> y(a.shape()[0], 0.0f);
+    for (size_t i = 0; i < a.shape()[0]; i++)
+        for (size_t j = 0; j < a.shape()[1]; j++)
+            y[i] += element(a, i, j) * x.data()[j * x.strides()[0]];
+    return y;
+}
+
+static vector<float> reference_vecmat(const Tensor<float>& x, const Tensor<float>& a)
+{
+    vector<float> y(a.shape()[1], 0.0f);
+    for (size_t i = 0; i < a.shape()[0]; i++)
+        for (size_t j = 0; j < a.shape()[1]; j++)
+            y[j] += x.data()[i * x.strides()[0]] * element(a, i, j);
+    return y;
+}
+
+TEST(GemvTest, Dot)
+{
+    for (size_t n : { 1, 7, 40, 50000 }) {
+        auto x = float_tensor({ n }, VALUES, 1), y = float_tensor({ n }, VALUES, 2);
+        double expected = 0;
+        for (size_t i = 0; i < n; i++)
+            expected += (double)x.data()[i] * y.data()[i];
+        ASSERT_NEAR(x.dot(y), expected, 1e-3 * (1 + std::abs(expected)));
+    }
+
+    auto t = create_tensor({ 3, 4 });
+    auto column = t["0:3, 1:2"].view({ 3 }); // strided view: [1, 5, 9]
+    auto row = t["1:2, 0:3"].view({ 3 });    // [4, 5, 6]
+    ASSERT_EQ(column.dot(row), 1 * 4 + 5 * 5 + 9 * 6);
+
+    EXPECT_THROW(float_tensor({ 3 }, VALUES).dot(float_tensor({ 4 }, VALUES)), std::invalid_argument);
+}
+
+TEST(GemvTest, MatvecRowMajorAndTransposed)
+{
+    // Shapes around the 4-row blocks, the 256-column strips and the row-chunked split of the kernels.
+    for (auto [m, n] : vector<std::array<size_t, 2>> { { 1, 1 }, { 5, 9 }, { 37, 300 }, { 3, 40000 } }) {
+        auto a = float_tensor({ m, n }, VALUES, 1);
+        auto x = float_tensor({ n }, VALUES, 2);
+        expect_near(a.matvec(x), reference_matvec(a, x), 1e-3f);
+        expect_near(a * x, reference_matvec(a, x), 1e-3f);
+
+        auto storage = float_tensor({ n, m }, VALUES, 3);
+        auto at = storage.transpose();
+        expect_near(at.matvec(x), reference_matvec(at, x), 1e-3f);
+    }
+}
+
+TEST(GemvTest, VecmatRowMajorAndTransposed)
+{
+    for (auto [m, n] : vector<std::array<size_t, 2>> { { 1, 1 }, { 9, 5 }, { 300, 37 }, { 40000, 3 }, { 20000, 600 } }) {
+        auto a = float_tensor({ m, n }, VALUES, 1);
+        auto x = float_tensor({ m }, VALUES, 2);
+        expect_near(x.vecmat(a), reference_vecmat(x, a), 1e-3f);
+        expect_near(x * a, reference_vecmat(x, a), 1e-3f);
+
+        auto storage = float_tensor({ n, m }, VALUES, 3);
+        auto at = storage.transpose();
+        expect_near(x.vecmat(at), reference_vecmat(x, at), 1e-3f);
+    }
+}
+
+TEST(GemvTest, SlicedOperands)
+{
+    auto a = float_tensor({ 10, 12 }, VALUES);
+    auto block = a["2:8, 1:11"];
+    auto pairs = float_tensor({ 10, 2 }, VALUES);
+    auto x = pairs["0:10, 0:1"].view({ 10 }); // stride 2
+
+    expect_near(block.matvec(x), reference_matvec(block, x), 1e-3f);
+}
+
+TEST(GemvTest, IntegerMatvecAndVecmat)
+{
+    auto a = create_tensor({ 2, 3 }); // [[0, 1, 2], [3, 4, 5]]
+    auto x = create_tensor({ 3 });    // [0, 1, 2]
+    auto y = create_tensor({ 2 });    // [0, 1]
+
+    auto ax = a * x;
+    ASSERT_EQ(ax.n_dims(), 1);
+    ASSERT_EQ((ax[Ind { 0 }]), 5);
+    ASSERT_EQ((ax[Ind { 1 }]), 14);
+
+    auto ya = y * a;
+    ASSERT_EQ(ya.n_dims(), 1);
+    ASSERT_EQ((ya[Ind { 0 }]), 3);
+    ASSERT_EQ((ya[Ind { 1 }]), 4);
+    ASSERT_EQ((ya[Ind { 2 }]), 5);
+
+    EXPECT_THROW(a * y, std::invalid_argument);
+}
+
+// A half accumulator stops at 2048 (float16) or 256 (bfloat16) when summing ones; the products accumulate in fp32.
+template <typename H> static void check_half_accumulation()
+{
+    auto ones = Tensor<H>::ones({ 4096 });
+    ASSERT_EQ((float)ones.dot(ones), 4096.0f);
+
+    auto ax = Tensor<H>::ones({ 2, 4096 }) * ones;
+    ASSERT_EQ((float)ax[Ind { 0 }], 4096.0f);
+    ASSERT_EQ((float)ax[Ind { 1 }], 4096.0f);
+
+    auto xa = ones * Tensor<H>::ones({ 4096, 2 });
+    ASSERT_EQ((float)xa[Ind { 0 }], 4096.0f);
+    ASSERT_EQ((float)xa[Ind { 1 }], 4096.0f);
+}
+
+TEST(GemvTest, Float16AccumulatesInFloat) { check_half_accumulation<Tensile::float16>(); }
+
+TEST(GemvTest, BFloat16AccumulatesInFloat) { check_half_accumulation<Tensile::bfloat16>(); }
+
+TEST(GemvTest, Outer)
+{
+    auto x = create_tensor({ 3 });
+    auto y = create_tensor({ 4 });
+    auto result = x.outer(y);
+
+    ASSERT_EQ(result.n_dims(), 2);
+    ASSERT_EQ(result.shape()[0], 3);
+    ASSERT_EQ(result.shape()[1], 4);
+    for (size_t i = 0; i < 3; i++)
+        for (size_t j = 0; j < 4; j++)
+            ASSERT_EQ((result[Ind { i, j }]), (int)(i * j));
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "tensile/graph.h"
+#include "test_utils.h"
+
+using std::vector;
+using Ind = std::vector<size_t>;
+using Tensile::Graph;
+using Tensile::Tensor;
+
+static FloatPattern pattern(float scale) { return { .scale = scale, .modulus = 13, .step = 5 }; }
+
+TEST(GraphTest, DenseLayerFusesBiasAndActivation)
+{
+    auto w = float_tensor({ 5, 6 }, pattern(0.1f));
+    auto b = float_tensor({ 1, 6 }, pattern(0.05f), 3);
+
+    Graph<float> g;
+    auto x = g.input({ 4, 5 });
+    auto y = ((x * g.constant(w)) + g.constant(b)).exp() * 0.5f;
+    auto plan = g.compile({ y });
+
+    // matmul + one fused elementwise kernel for add, exp and scale
+    ASSERT_EQ(plan.n_kernels(), 2);
+
+    auto input = float_tensor({ 4, 5 }, pattern(0.2f), 1);
+    plan.run({ input });
+
+    auto h = input * w;
+    auto z = h + b;
+    expect_near(plan.output(0), z.exp() * 0.5f);
+}
+
+TEST(GraphTest, ElementwiseFusesIntoReduction)
+{
+    Graph<float> g;
+    auto x = g.input({ 3, 5 });
+    auto y = g.input({ 3, 5 });
+    auto s = (x.elementwise_mul(y) - x).exp().sum(1, true);
+    auto plan = g.compile({ s });
+
+    ASSERT_EQ(plan.n_kernels(), 1);
+
+    auto a = float_tensor({ 3, 5 }, pattern(0.1f)), c = float_tensor({ 3, 5 }, pattern(0.3f), 2);
+    plan.run({ a, c });
+
+    auto p = a.elementwise_mul(c);
+    auto d = p - a;
+    expect_near(plan.output(0), d.exp().sum(1, true));
+}
+
+TEST(GraphTest, SharedIntermediateIsMaterialized)
+{
+    Graph<float> g;
+    auto x = g.input({ 2, 3 });
+    auto e = x.exp();
+    auto y = e + e.reciprocal();
+    auto plan = g.compile({ y });
+
+    ASSERT_EQ(plan.n_kernels(), 2);
+
+    auto a = float_tensor({ 2, 3 }, pattern(0.4f));
+    plan.run({ a });
+
+    auto expected = a.exp();
+    expect_near(plan.output(0), expected + expected.reciprocal());
+}
+
+TEST(GraphTest, TransposeIsAStridedRead)
+{
+    auto w = float_tensor({ 5, 4 }, pattern(0.1f), 7);
+
+    Graph<float> g;
+    auto x = g.input({ 3, 4 });
+    auto y = x * g.constant(w).transpose();
+    auto plan = g.compile({ y });
+
+    ASSERT_EQ(plan.n_kernels(), 1);
+
+    auto a = float_tensor({ 3, 4 }, pattern(0.2f));
+    plan.run({ a });
+
+    expect_near(plan.output(0), a * w.transpose());
+}
+
+TEST(GraphTest, ArenaReusesDeadIntermediates)
+{
+    auto w1 = float_tensor({ 6, 6 }, pattern(0.05f), 1);
+    auto w2 = float_tensor({ 6, 6 }, pattern(0.05f), 2);
+    auto w3 = float_tensor({ 6, 6 }, pattern(0.05f), 3);
+    auto w4 = float_tensor({ 6, 6 }, pattern(0.05f), 4);
+
+    Graph<float> g;
+    auto x = g.input({ 6, 6 });
+    auto y = (((x * g.constant(w1)) * g.constant(w2)) * g.constant(w3)) * g.constant(w4);
+    auto plan = g.compile({ y });
+
+    ASSERT_EQ(plan.n_kernels(), 4);
+    ASSERT_LT(plan.arena_size(), plan.intermediate_size());
+    ASSERT_EQ(plan.arena_size(), 2 * 40);
+
+    auto a = float_tensor({ 6, 6 }, pattern(0.1f));
+    plan.run({ a });
+
+    auto h1 = a * w1;
+    auto h2 = h1 * w2;
+    auto h3 = h2 * w3;
+    expect_near(plan.output(0), h3 * w4);
+}
+
+TEST(GraphTest, ReplayWithNewInputs)
+{
+    auto w = float_tensor({ 6, 2 }, pattern(0.3f));
+
+    Graph<float> g;
+    auto x = g.input({ 300, 6 });
+    auto h = x * g.constant(w);
+    auto y = -(h + 1.0f);
+    auto s = h.sum(0, false);
+    auto plan = g.compile({ y, s, x });
+
+    for (size_t seed = 0; seed < 3; seed++) {
+        auto input = float_tensor({ 300, 6 }, pattern(0.1f), seed);
+        plan.run({ input });
+
+        auto product = input * w;
+        auto shifted = product + 1.0f;
+        expect_near(plan.output(0), -shifted);
+        expect_near(plan.output(1), product.sum(0, false));
+        expect_near(plan.output(2), input);
+    }
+}
+
+TEST(GraphTest, InvalidGraphs)
+{
+    Graph<float> g;
+    auto x = g.input({ 3, 4 });
+    auto y = g.input({ 5, 4 });
+
+    EXPECT_THROW(x + y, std::invalid_argument);
+    EXPECT_THROW(x * y, std::invalid_argument);
+    EXPECT_THROW(x.sum(2, false), std::invalid_argument);
+
+    auto plan = g.compile({ x + x });
+    auto wrong = float_tensor({ 4, 3 }, pattern(1.0f));
+    EXPECT_THROW(plan.run({ wrong }), std::invalid_argument);
+}
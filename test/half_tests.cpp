@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "tensile/tensor.h"
+#include "test_utils.h"
+
+using std::vector;
+using Ind = std::vector<size_t>;
+using Tensile::bfloat16;
+using Tensile::float16;
+using Tensile::Tensor;
+
+static_assert(Tensile::TensorType<float16>);
+static_assert(Tensile::TensorType<bfloat16>);
+static_assert(Tensile::CompatibleTypes<float16, float16>);
+// Mixed half/float arithmetic has no kernels; convert with astype() first.
+static_assert(!Tensile::CompatibleTypes<float16, float> && !Tensile::CompatibleTypes<float, bfloat16>);
+static_assert(!Tensile::CompatibleTypes<float16, bfloat16>);
+static_assert(sizeof(float16) == 2 && sizeof(bfloat16) == 2);
+
+// Element i of the test inputs: small multiples of `scale`, exact in both half types.
+static auto pattern(float scale)
+{
+    return [=](size_t i) { return scale * (float)((int)(i % 17) - 8); };
+}
+
+TEST(HalfTest, Float16ScalarConversion)
+{
+    EXPECT_EQ(float16(1.0f).bits, 0x3C00);
+    EXPECT_EQ(float16(-2.0f).bits, 0xC000);
+    EXPECT_EQ((float)float16(0.5f), 0.5f);
+    EXPECT_EQ((float)float16(65504.0f), 65504.0f);
+    EXPECT_TRUE(std::isinf((float)float16(1e6f)));
+    EXPECT_TRUE(std::isnan((float)float16(std::numeric_limits<float>::quiet_NaN())));
+}
+
+TEST(HalfTest, BFloat16ScalarConversion)
+{
+    EXPECT_EQ(bfloat16(1.0f).bits, 0x3F80);
+    EXPECT_EQ((float)bfloat16(3.0f), 3.0f);
+    // 1 + 2^-8 is exactly halfway between two bfloat16 values and rounds to the even one.
+    EXPECT_EQ((float)bfloat16(1.0f + 1.0f / 256), 1.0f);
+    EXPECT_EQ((float)bfloat16(1.0f + 3.0f / 256), 1.0f + 1.0f / 64);
+    EXPECT_TRUE(std::isnan((float)bfloat16(std::numeric_limits<float>::quiet_NaN())));
+}
+
+template <typename H> void check_vector_conversion()
+{
+    vector<float> src(21);
+    for (size_t i = 0; i < src.size(); i++)
+        src[i] = 0.37f * (float)i - 3.0f;
+    src[5] = std::numeric_limits<float>::quiet_NaN();
+    src[6] = std::numeric_limits<float>::infinity();
+
+    vector<H> half(src.size());
+    vector<float> back(src.size());
+    Tensile::convert(src.data(), half.data(), src.size());
+    Tensile::convert(half.data(), back.data(), src.size());
+
+    for (size_t i = 0; i < src.size(); i++) {
+        EXPECT_EQ(half[i].bits, H(src[i]).bits) << "at " << i;
+        if (i != 5) {
+            EXPECT_EQ(back[i], (float)H(src[i])) << "at " << i;
+        }
+    }
+    EXPECT_TRUE(std::isnan(back[5]));
+}
+
+TEST(HalfTest, Float16VectorConversion) { check_vector_conversion<float16>(); }
+
+TEST(HalfTest, BFloat16VectorConversion) { check_vector_conversion<bfloat16>(); }
+
+template <typename H> void check_elementwise()
+{
+    auto a = fill_tensor<H>({ 3, 7 }, pattern(0.5f));
+    auto b = fill_tensor<H>({ 3, 7 }, pattern(0.25f));
+
+    auto sum = a + b;
+    auto diff = a - b;
+    auto prod = a.elementwise_mul(b);
+
+    for (size_t i = 0; i < 3; i++) {
+        for (size_t j = 0; j < 7; j++) {
+            float x = a[Ind { i, j }];
+            float y = b[Ind { i, j }];
+            EXPECT_EQ(((float)sum[Ind { i, j }]), (float)H(x + y));
+            EXPECT_EQ(((float)diff[Ind { i, j }]), (float)H(x - y));
+            EXPECT_EQ(((float)prod[Ind { i, j }]), (float)H(x * y));
+        }
+    }
+}
+
+TEST(HalfTest, Float16Elementwise) { check_elementwise<float16>(); }
+
+TEST(HalfTest, BFloat16Elementwise) { check_elementwise<bfloat16>(); }
+
+TEST(HalfTest, BroadcastFallsBackToScalarPath)
+{
+    auto a = fill_tensor<float16>({ 3, 1 }, pattern(1.0f));
+    auto b = fill_tensor<float16>({ 1, 4 }, pattern(1.0f));
+
+    auto sum = a + b;
+
+    ASSERT_EQ(sum.shape()[0], 3);
+    ASSERT_EQ(sum.shape()[1], 4);
+    EXPECT_EQ(((float)sum[Ind { 2, 3 }]), -6.0f + -5.0f);
+}
+
+template <typename H> void check_matmul(size_t m, size_t k, size_t n)
+{
+    auto a = fill_tensor<H>({ m, k }, pattern(0.125f));
+    auto b = fill_tensor<H>({ k, n }, pattern(0.25f));
+
+    auto c = a.matmul_accumulate_f32(b);
+    auto c_half = a * b;
+
+    ASSERT_EQ(c.shape()[0], m);
+    ASSERT_EQ(c.shape()[1], n);
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            float expected = 0;
+            for (size_t p = 0; p < k; p++)
+                expected += (float)a[Ind { i, p }] * (float)b[Ind { p, j }];
+            EXPECT_NEAR((c[Ind { i, j }]), expected, 1e-3f);
+            EXPECT_EQ(((float)c_half[Ind { i, j }]), (float)H(expected));
+        }
+    }
+}
+
+TEST(HalfTest, Float16Matmul) { check_matmul<float16>(9, 13, 19); }
+
+TEST(HalfTest, BFloat16Matmul) { check_matmul<bfloat16>(5, 32, 16); }
+
+TEST(HalfTest, BatchedMatmulBroadcasts)
+{
+    auto a = fill_tensor<float16>({ 3, 2, 4 }, pattern(1.0f));
+    auto b = fill_tensor<float16>({ 1, 4, 8 }, pattern(1.0f));
+
+    auto c = a.matmul_accumulate_f32(b);
+
+    ASSERT_EQ(c.n_dims(), 3);
+    ASSERT_EQ(c.shape()[0], 3);
+    for (size_t bt = 0; bt < 3; bt++) {
+        float expected = 0;
+        for (size_t p = 0; p < 4; p++)
+            expected += (float)a[Ind { bt, 1, p }] * (float)b[Ind { 0, p, 5 }];
+        EXPECT_EQ((c[Ind { bt, 1, 5 }]), expected);
+    }
+}
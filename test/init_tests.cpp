@@ -36,4 +36,42 @@ TEST(TensorConstructorTest, InvalidShape)
 {
     std::initializer_list<size_t> shape = { 1, 2, 3, 4, 5 };
     EXPECT_THROW(Tensor<int>(nullptr, shape), std::invalid_argument);
-}
\ No newline at end of file
+}
+
+TEST(TensorInitialization, FillFactories)
+{
+    auto ones = Tensor<float>::ones({ 3, 5 });
+    auto full = Tensor<int>::full({ 2, 3, 4 }, 7);
+    auto zeros = Tensor<double>::zeros({ 4, 4 });
+    EXPECT_EQ(full.shape()[2], 4);
+
+    for (size_t i = 0; i < ones.size(); i++)
+        EXPECT_EQ(ones.data()[i], 1.0f);
+    for (size_t i = 0; i < full.size(); i++)
+        EXPECT_EQ(full.data()[i], 7);
+    for (size_t i = 0; i < zeros.size(); i++)
+        EXPECT_EQ(zeros.data()[i], 0.0);
+
+    auto empty = Tensor<float>::empty({ 6, 7 });
+    EXPECT_EQ(empty.size(), 42);
+    EXPECT_NE(empty.data(), nullptr);
+}
+
+// Large enough for the parallel fill and the mapped zero path.
+TEST(TensorInitialization, LargeFillFactories)
+{
+    auto full = Tensor<float>::full({ 1024, 1031 }, -2.5f);
+    for (size_t i = 0; i < full.size(); i++)
+        ASSERT_EQ(full.data()[i], -2.5f);
+
+    auto zeros = Tensor<float>::zeros({ 2048, 1031 });
+    for (size_t i = 0; i < zeros.size(); i++)
+        ASSERT_EQ(zeros.data()[i], 0.0f);
+
+    // Mapped storage is writable and survives moves.
+    zeros.data()[12345] = 3.0f;
+    Tensor<float> moved = std::move(zeros);
+    EXPECT_EQ(moved.data()[12345], 3.0f);
+    moved = Tensor<float>::zeros({ 4096, 1024 });
+    EXPECT_EQ(moved.data()[4096 * 1024 - 1], 0.0f);
+}
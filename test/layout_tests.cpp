@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "tensile/gemm.h"
+#include "test_utils.h"
+
+using std::vector;
+using Tensile::Epilogue;
+using Tensile::GemmConfig;
+using Tensile::MemoryOrder;
+using Tensile::PackedMatrix;
+using Tensile::Tensor;
+
+TEST(LayoutTests, ColumnMajor)
+{
+    // A Fortran-ordered 2 x 3 matrix: columns are contiguous.
+    Tensor<float> f(new float[6] { 1, 4, 2, 5, 3, 6 }, { 2, 3 }, MemoryOrder::COLUMN_MAJOR);
+    EXPECT_EQ(f.strides()[0], 1);
+    EXPECT_EQ(f.strides()[1], 2);
+    EXPECT_TRUE(f.has_order(MemoryOrder::COLUMN_MAJOR));
+    EXPECT_FALSE(f.has_order(MemoryOrder::ROW_MAJOR));
+    EXPECT_EQ(f.flat_string(), "[1.000000, 2.000000, 3.000000, 4.000000, 5.000000, 6.000000, ]");
+
+    auto c = f.with_order(MemoryOrder::ROW_MAJOR);
+    EXPECT_TRUE(c.has_order(MemoryOrder::ROW_MAJOR));
+    EXPECT_EQ(vector<float>(c.data(), c.data() + 6), (vector<float> { 1, 2, 3, 4, 5, 6 }));
+
+    // Converting back gives the original storage order, and converting to the current order is free.
+    auto back = c.with_order(MemoryOrder::COLUMN_MAJOR);
+    EXPECT_EQ(vector<float>(back.data(), back.data() + 6), (vector<float> { 1, 4, 2, 5, 3, 6 }));
+    EXPECT_TRUE(f.with_order(MemoryOrder::COLUMN_MAJOR).shares_storage(f));
+
+    // A transposed row-major matrix is column-major, and a vector is in both orders.
+    auto t = float_tensor({ 3, 4 }).transpose();
+    EXPECT_TRUE(t.has_order(MemoryOrder::COLUMN_MAJOR));
+    auto v = float_tensor({ 5 });
+    EXPECT_TRUE(v.has_order(MemoryOrder::ROW_MAJOR) && v.has_order(MemoryOrder::COLUMN_MAJOR));
+
+    auto e = Tensor<float>::empty({ 2, 3, 4 }, MemoryOrder::COLUMN_MAJOR);
+    EXPECT_EQ(e.strides()[2], 6);
+}
+
+TEST(LayoutTests, ElementwiseKeepsColumnMajor)
+{
+    auto a = float_tensor({ 3, 5, 2 }, 1).with_order(MemoryOrder::COLUMN_MAJOR);
+    auto b = float_tensor({ 3, 5, 2 }, 2).with_order(MemoryOrder::COLUMN_MAJOR);
+
+    auto sum = a + b;
+    EXPECT_TRUE(sum.has_order(MemoryOrder::COLUMN_MAJOR));
+    auto expected = a.contiguous() + b.contiguous();
+    EXPECT_EQ(sum.flat_string(), expected.flat_string());
+
+    auto ex = a.exp();
+    EXPECT_TRUE(ex.has_order(MemoryOrder::COLUMN_MAJOR));
+    EXPECT_EQ(ex.flat_string(), a.contiguous().exp().flat_string());
+
+    // Mixed orders fall back to the strided loop and a row-major result.
+    auto mixed = a + b.contiguous();
+    EXPECT_TRUE(mixed.has_order(MemoryOrder::ROW_MAJOR));
+    EXPECT_EQ(mixed.flat_string(), expected.flat_string());
+}
+
+TEST(LayoutTests, PackedWeights)
+{
+    // Small blocks so that the weights span several KC x NC blocks and a partial NR panel.
+    GemmConfig config { 12, 32, 48, 2, 4 };
+    const size_t m = 29, k = 75, n = 101;
+    auto a = float_tensor({ m, k }, 3);
+    auto w = float_tensor({ k, n }, 4);
+
+    PackedMatrix packed(w, config);
+    EXPECT_EQ(packed.rows(), k);
+    EXPECT_EQ(packed.cols(), n);
+    EXPECT_EQ(packed.unpack().flat_string(), w.flat_string());
+
+    auto expected = Tensile::matmul_fused(a, w);
+    for (int call = 0; call < 2; call++) {
+        auto c = Tensile::matmul_fused(a, packed);
+        for (size_t i = 0; i < m * n; i++)
+            ASSERT_NEAR(c.data()[i], expected.data()[i], 1e-4);
+    }
+
+    // Column-major weights pack to the same panels, and the epilogue still applies.
+    PackedMatrix from_columns(w.with_order(MemoryOrder::COLUMN_MAJOR), config);
+    auto bias = float_tensor({ n }, 5);
+    Epilogue relu { .activation = Tensile::Activation::RELU };
+    auto fused = Tensile::matmul_fused(a, from_columns, bias, relu);
+    auto reference = Tensile::matmul_fused(a, w, bias, relu);
+    for (size_t i = 0; i < m * n; i++)
+        ASSERT_NEAR(fused.data()[i], reference.data()[i], 1e-4);
+
+    PackedMatrix default_blocking(w);
+    auto d = Tensile::matmul_fused(a, default_blocking);
+    for (size_t i = 0; i < m * n; i++)
+        ASSERT_NEAR(d.data()[i], expected.data()[i], 1e-4);
+
+    EXPECT_THROW(Tensile::matmul_fused(float_tensor({ m, k + 1 }), packed), std::invalid_argument);
+    EXPECT_THROW(PackedMatrix(float_tensor({ 2, 3, 4 })), std::invalid_argument);
+}
@@ -32,4 +32,43 @@ TEST(Tensor2dMatmulTest, SliceMatmul)
     ASSERT_EQ((result[Ind { 0, 1 }]), 35);
     ASSERT_EQ((result[Ind { 1, 0 }]), 40);
     ASSERT_EQ((result[Ind { 1, 1 }]), 59);
-}
\ No newline at end of file
+}
+
+TEST(Tensor2dMatmulTest, FloatMatmulLongInnerDim)
+{
+    // Inner dimension longer than one eight-wide vector, with a remainder.
+    size_t m = 3, k = 11, n = 5;
+    auto* a_data = new float[m * k];
+    auto* b_data = new float[k * n];
+    for (size_t i = 0; i < m * k; i++)
+        a_data[i] = (float)(i % 7) - 3;
+    for (size_t i = 0; i < k * n; i++)
+        b_data[i] = (float)(i % 5) - 2;
+
+    Tensile::Tensor<float> a(a_data, { m, k });
+    Tensile::Tensor<float> b(b_data, { k, n });
+    const auto result = a * b;
+
+    for (size_t i = 0; i < m; i++)
+        for (size_t j = 0; j < n; j++) {
+            float expected = 0;
+            for (size_t p = 0; p < k; p++)
+                expected += a_data[i * k + p] * b_data[p * n + j];
+            ASSERT_FLOAT_EQ((result[Ind { i, j }]), expected);
+        }
+}
+
+TEST(Tensor2dMatmulTest, FloatMatmulOfTransposedViews)
+{
+    auto at = float_tensor({ 40, 33 }, 1), bt = float_tensor({ 50, 40 }, 2);
+    const auto result = at.transpose() * bt.transpose();
+
+    ASSERT_EQ(result.shape()[0], 33);
+    ASSERT_EQ(result.shape()[1], 50);
+    std::vector<float> expected(33 * 50);
+    for (size_t i = 0; i < 33; i++)
+        for (size_t j = 0; j < 50; j++)
+            for (size_t p = 0; p < 40; p++)
+                expected[i * 50 + j] += at.data()[p * 33 + i] * bt.data()[j * 40 + p];
+    expect_near(result, expected);
+}
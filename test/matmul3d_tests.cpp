@@ -36,3 +36,23 @@ TEST(Tensor3dMatmulTest, Matmul)
     ASSERT_EQ((r3[Ind { 0, 1, 0 }]), 378);
     ASSERT_EQ((r3[Ind { 0, 1, 1 }]), 407);
 }
+
+TEST(Tensor3dMatmulTest, FloatBroadcastNonSquare)
+{
+    // Large enough per product for sgemm; the right-hand side is broadcast over the batch and read transposed.
+    auto a = float_tensor({ 3, 5, 7 }, 1);
+    auto bt = float_tensor({ 1, 9, 7 }, 2);
+    auto b = bt.permute({ 0, 2, 1 });
+    auto result = a * b;
+
+    ASSERT_EQ(result.shape()[0], 3);
+    ASSERT_EQ(result.shape()[1], 5);
+    ASSERT_EQ(result.shape()[2], 9);
+    std::vector<float> expected(3 * 5 * 9);
+    for (size_t t = 0; t < 3; t++)
+        for (size_t i = 0; i < 5; i++)
+            for (size_t j = 0; j < 9; j++)
+                for (size_t p = 0; p < 7; p++)
+                    expected[(t * 5 + i) * 9 + j] += a.data()[(t * 5 + i) * 7 + p] * bt.data()[j * 7 + p];
+    expect_near(result, expected);
+}
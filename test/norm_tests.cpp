@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "tensile/tensor.h"
+#include "test_utils.h"
+
+using std::vector;
+using Tensile::bfloat16;
+using Tensile::Tensor;
+
+static FloatPattern pattern(float scale) { return { .scale = scale, .modulus = 19 }; }
+
+// Reference softmax / log-softmax along `axis` in double, on a contiguous tensor.
+template <typename T> static vector<double> reference_softmax(const Tensor<T>& t, size_t axis, bool log)
+{
+    auto shape = t.shape();
+    size_t outer = 1, inner = 1, len = shape[axis];
+    for (size_t d = 0; d < axis; d++)
+        outer *= shape[d];
+    for (size_t d = axis + 1; d < t.n_dims(); d++)
+        inner *= shape[d];
+
+    vector<double> out(t.size());
+    for (size_t o = 0; o < outer; o++)
+        for (size_t j = 0; j < inner; j++) {
+            size_t base = o * len * inner + j;
+            double max = -INFINITY, sum = 0;
+            for (size_t k = 0; k < len; k++)
+                max = std::max(max, (double)(float)t.data()[base + k * inner]);
+            for (size_t k = 0; k < len; k++)
+                sum += std::exp((double)(float)t.data()[base + k * inner] - max);
+            for (size_t k = 0; k < len; k++) {
+                double v = (double)(float)t.data()[base + k * inner] - max;
+                out[base + k * inner] = log ? v - std::log(sum) : std::exp(v) / sum;
+            }
+        }
+    return out;
+}
+
+template <typename T> static void expect_near(const Tensor<T>& actual, const vector<double>& expected, double tol)
+{
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++)
+        ASSERT_NEAR((double)(float)actual.data()[i], expected[i], tol * (1 + std::abs(expected[i]))) << "at " << i;
+}
+
+TEST(NormTest, SoftmaxAlongEveryAxis)
+{
+    // The middle axes have inner strides of 8 lanes plus a scalar remainder.
+    auto t = float_tensor({ 3, 5, 4, 11 }, pattern(0.3f));
+    for (size_t axis = 0; axis < 4; axis++) {
+        expect_near(t.softmax(axis), reference_softmax(t, axis, false), 1e-5);
+        expect_near(t.log_softmax(axis), reference_softmax(t, axis, true), 1e-5);
+    }
+}
+
+TEST(NormTest, SoftmaxLongRowsAndRowSums)
+{
+    auto t = float_tensor({ 70, 1000 }, pattern(0.05f), 3);
+    auto s = t.softmax(1);
+    expect_near(s, reference_softmax(t, 1, false), 1e-5);
+
+    for (size_t r = 0; r < 70; r++) {
+        double sum = 0;
+        for (size_t c = 0; c < 1000; c++)
+            sum += s.data()[r * 1000 + c];
+        ASSERT_NEAR(sum, 1.0, 1e-5);
+    }
+}
+
+TEST(NormTest, SoftmaxIsStableForLargeInputs)
+{
+    auto* data = new float[10] { 1000, 1001, 1002, 999, -1000, 88, 89, 90, 1003, 1000 };
+    Tensor<float> t(data, { 10 });
+
+    auto s = t.softmax(0);
+    auto ls = t.log_softmax(0);
+    for (size_t i = 0; i < 10; i++) {
+        ASSERT_TRUE(std::isfinite(s.data()[i]));
+        ASSERT_TRUE(std::isfinite(ls.data()[i]));
+    }
+    expect_near(s, reference_softmax(t, 0, false), 1e-5);
+    expect_near(ls, reference_softmax(t, 0, true), 1e-5);
+}
+
+TEST(NormTest, SoftmaxMaskedEntriesAreExactlyZero)
+{
+    // 19 elements: two full vectors and a scalar tail, along rows (softmax_row) and columns (softmax_lines8).
+    auto* data = new float[19 * 8];
+    for (size_t i = 0; i < 19; i++)
+        for (size_t j = 0; j < 8; j++)
+            data[i * 8 + j] = i % 2 == 0 ? 1.0f : -INFINITY;
+    Tensor<float> columns(data, { 19, 8 });
+    auto rows = columns.transpose().copy();
+
+    for (auto [t, axis] : { std::pair { &rows, size_t(1) }, std::pair { &columns, size_t(0) } }) {
+        auto s = t->softmax(axis);
+        auto ls = t->log_softmax(axis);
+        for (size_t i = 0; i < t->size(); i++) {
+            if (std::isinf(t->data()[i])) {
+                ASSERT_EQ(s.data()[i], 0.0f) << "at " << i;
+                ASSERT_EQ(ls.data()[i], -INFINITY) << "at " << i;
+            } else {
+                ASSERT_NEAR(s.data()[i], 0.1, 1e-6) << "at " << i;
+            }
+        }
+    }
+}
+
+TEST(NormTest, SoftmaxMaskedLeadingEntryInLeftoverLanes)
+{
+    // Along axis 0 with inner = 9, column 8 goes through the one-lane path, and its line starts with -inf.
+    auto* data = new float[3 * 9];
+    for (size_t i = 0; i < 27; i++)
+        data[i] = i < 9 ? -INFINITY : 1.0f;
+    Tensor<float> t(data, { 3, 9 });
+
+    auto s = t.softmax(0);
+    for (size_t j = 0; j < 9; j++) {
+        ASSERT_EQ(s.data()[j], 0.0f) << "column " << j;
+        ASSERT_FLOAT_EQ(s.data()[9 + j], 0.5f) << "column " << j;
+        ASSERT_FLOAT_EQ(s.data()[18 + j], 0.5f) << "column " << j;
+    }
+}
+
+TEST(NormTest, SoftmaxFullyMaskedLinesAreNaN)
+{
+    for (size_t n : { 8, 16, 9 }) {
+        // Rows: row 0 is fully masked (softmax_row, vector body and scalar tail).
+        auto rows = fill_tensor<float>({ 2, n }, [&](size_t i) { return i < n ? -INFINITY : 0.1f * (float)(i % 5); });
+        // Columns with inner = 9: columns 0 and 3 go through softmax_lines8 and column 8 through the one-lane path.
+        auto columns = fill_tensor<float>({ n, 9 }, [](size_t i) {
+            size_t j = i % 9;
+            return j == 0 || j == 3 || j == 8 ? -INFINITY : 0.1f * (float)(i % 7);
+        });
+
+        for (auto [t, axis] : { std::pair { &rows, size_t(1) }, std::pair { &columns, size_t(0) } }) {
+            auto s = t->softmax(axis);
+            auto ls = t->log_softmax(axis);
+            auto expected = reference_softmax(*t, axis, false);
+            for (size_t i = 0; i < t->size(); i++) {
+                bool masked = axis == 1 ? i < n : (i % 9 == 0 || i % 9 == 3 || i % 9 == 8);
+                if (masked) {
+                    ASSERT_TRUE(std::isnan(s.data()[i])) << "n = " << n << ", axis " << axis << ", at " << i;
+                    ASSERT_TRUE(std::isnan(ls.data()[i])) << "n = " << n << ", axis " << axis << ", at " << i;
+                } else {
+                    ASSERT_NEAR(s.data()[i], expected[i], 1e-5) << "n = " << n << ", axis " << axis << ", at " << i;
+                }
+            }
+        }
+    }
+}
+
+TEST(NormTest, SoftmaxOfStridedViewAndOtherTypes)
+{
+    auto t = float_tensor({ 6, 9 }, pattern(0.2f));
+    auto tt = t.transpose();
+    expect_near(tt.softmax(1), reference_softmax(tt.contiguous(), 1, false), 1e-5);
+
+    auto d = float_tensor({ 4, 7 }, pattern(0.2f)).astype<double>();
+    expect_near(d.log_softmax(0), reference_softmax(d, 0, true), 1e-6);
+
+    auto h = float_tensor({ 3, 8 }, pattern(0.25f)).astype<bfloat16>();
+    expect_near(h.softmax(1), reference_softmax(h, 1, false), 1e-2);
+}
+
+static vector<double> reference_norm(const Tensor<float>& t, const float* gamma, const float* beta, double eps,
+                                     bool rms)
+{
+    size_t len = t.shape()[t.n_dims() - 1], rows = t.size() / len;
+    vector<double> out(t.size());
+    for (size_t r = 0; r < rows; r++) {
+        const float* row = t.data() + r * len;
+        double mean = 0, sq = 0;
+        for (size_t i = 0; i < len; i++)
+            mean += row[i];
+        mean = rms ? 0 : mean / len;
+        for (size_t i = 0; i < len; i++)
+            sq += (row[i] - mean) * (row[i] - mean);
+        double scale = 1 / std::sqrt(sq / len + eps);
+        for (size_t i = 0; i < len; i++)
+            out[r * len + i] = (row[i] - mean) * scale * (gamma ? gamma[i] : 1) + (beta ? beta[i] : 0);
+    }
+    return out;
+}
+
+TEST(NormTest, LayerNorm)
+{
+    auto t = float_tensor({ 2, 7, 45 }, pattern(0.1f));
+    auto gamma = float_tensor({ 45 }, pattern(0.2f), 1);
+    auto beta = float_tensor({ 45 }, pattern(0.1f), 2);
+
+    expect_near(t.layer_norm(gamma, beta), reference_norm(t, gamma.data(), beta.data(), 1e-5, false), 1e-4);
+    expect_near(t.layer_norm(), reference_norm(t, nullptr, nullptr, 1e-5, false), 1e-4);
+
+    auto wrong = float_tensor({ 44 }, pattern(1.0f));
+    EXPECT_THROW(t.layer_norm(wrong, beta), std::invalid_argument);
+}
+
+TEST(NormTest, LayerNormWithLargeMean)
+{
+    // A large offset cancels catastrophically in E[x^2] - E[x]^2 unless the sums are shifted.
+    auto* data = new float[64];
+    for (size_t i = 0; i < 64; i++)
+        data[i] = 10000.0f + (float)(i % 4);
+    Tensor<float> t(data, { 64 });
+
+    expect_near(t.layer_norm(), reference_norm(t, nullptr, nullptr, 1e-5, false), 1e-3);
+}
+
+TEST(NormTest, RmsNorm)
+{
+    auto t = float_tensor({ 300, 129 }, pattern(0.1f), 5);
+    auto gamma = float_tensor({ 129 }, pattern(0.2f), 1);
+
+    expect_near(t.rms_norm(gamma), reference_norm(t, gamma.data(), nullptr, 1e-6, true), 1e-4);
+    expect_near(t.rms_norm(), reference_norm(t, nullptr, nullptr, 1e-6, true), 1e-4);
+}
@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "tensile/quantized.h"
+#include "test_utils.h"
+
+using std::vector;
+using Ind = std::vector<size_t>;
+using Tensile::QuantizedTensor;
+using Tensile::Tensor;
+
+static FloatPattern pattern(float scale) { return { .scale = scale, .modulus = 23 }; }
+
+TEST(QuantizedTensorTest, PerTensorRoundTrip)
+{
+    auto tensor = float_tensor({ 5, 13 }, pattern(0.5f));
+    auto q = QuantizedTensor::quantize(tensor, 0.5f, 3);
+
+    ASSERT_FALSE(q.is_per_channel());
+    ASSERT_EQ(q.scale(), 0.5f);
+    ASSERT_EQ(q.zero_point(), 3);
+    ASSERT_EQ((q.int_repr()[Ind { 0, 1 }]), (int)std::lround(tensor[Ind { 0, 1 }] / 0.5f) + 3);
+
+    auto back = q.dequantize();
+    for (size_t i = 0; i < 5; i++)
+        for (size_t j = 0; j < 13; j++)
+            ASSERT_FLOAT_EQ((back[Ind { i, j }]), (tensor[Ind { i, j }]));
+}
+
+TEST(QuantizedTensorTest, QuantizeSaturates)
+{
+    auto* data = new float[40];
+    for (size_t i = 0; i < 40; i++)
+        data[i] = (i % 2 == 0 ? 1.0f : -1.0f) * 1000.0f;
+    Tensor<float> tensor(data, { 40 });
+
+    auto q = QuantizedTensor::quantize(tensor, 1.0f, 0);
+
+    for (size_t i = 0; i < 40; i++)
+        ASSERT_EQ((q.int_repr()[Ind { i }]), i % 2 == 0 ? Tensile::QINT8_MAX : Tensile::QINT8_MIN);
+}
+
+TEST(QuantizedTensorTest, OutliersSaturateInVectorAndTail)
+{
+    // Elements 0-31 go through the vector path and 32-39 through the scalar tail; both must clamp the same way.
+    auto* data = new float[40];
+    for (size_t i = 0; i < 40; i++)
+        data[i] = 0.001f * (float)i;
+    for (size_t i : { 3, 35 })
+        data[i] = 1e7f;
+    for (size_t i : { 4, 36 })
+        data[i] = -1e7f;
+    data[10] = data[38] = INFINITY;
+    data[11] = data[39] = -INFINITY;
+    Tensor<float> tensor(data, { 40 });
+
+    auto q = QuantizedTensor::quantize(tensor, 0.001f, 5);
+
+    for (size_t i : { 3, 35, 10, 38 })
+        EXPECT_EQ((q.int_repr()[Ind { i }]), Tensile::QINT8_MAX) << i;
+    for (size_t i : { 4, 36, 11, 39 })
+        EXPECT_EQ((q.int_repr()[Ind { i }]), Tensile::QINT8_MIN) << i;
+    EXPECT_EQ((q.int_repr()[Ind { 20 }]), 25);
+    EXPECT_EQ((q.int_repr()[Ind { 33 }]), 38);
+}
+
+TEST(QuantizedTensorTest, NaNQuantizesToMinInVectorAndTail)
+{
+    // Element 7 goes through the vector path and element 37 through the scalar tail.
+    auto* data = new float[40];
+    for (size_t i = 0; i < 40; i++)
+        data[i] = 0.001f * (float)i;
+    data[7] = data[37] = NAN;
+    Tensor<float> tensor(data, { 40 });
+
+    for (int32_t zero_point : { 0, 5, -20 }) {
+        auto q = QuantizedTensor::quantize(tensor, 0.001f, zero_point);
+        EXPECT_EQ((q.int_repr()[Ind { 7 }]), Tensile::QINT8_MIN) << zero_point;
+        EXPECT_EQ((q.int_repr()[Ind { 37 }]), Tensile::QINT8_MIN) << zero_point;
+        EXPECT_EQ((q.int_repr()[Ind { 33 }]), 33 + zero_point) << zero_point;
+    }
+}
+
+TEST(QuantizedTensorTest, QuantizeRoundsToNearestEven)
+{
+    auto* data = new float[4] { 0.5f, 1.5f, 2.5f, -0.5f };
+    Tensor<float> tensor(data, { 4 });
+
+    auto q = QuantizedTensor::quantize(tensor, 1.0f, 0);
+
+    ASSERT_EQ(q.int_repr().flat_string(), "[0, 2, 2, 0, ]");
+}
+
+TEST(QuantizedTensorTest, PerChannelRoundTrip)
+{
+    auto tensor = float_tensor({ 3, 4, 9 }, pattern(0.25f));
+
+    for (size_t axis = 0; axis < 3; axis++) {
+        auto q = QuantizedTensor::quantize_symmetric_per_channel(tensor, axis);
+        ASSERT_TRUE(q.is_per_channel());
+        ASSERT_EQ(q.scales().size(), tensor.shape()[axis]);
+
+        auto back = q.dequantize();
+        for (size_t i = 0; i < 3; i++)
+            for (size_t j = 0; j < 4; j++)
+                for (size_t k = 0; k < 9; k++) {
+                    float scale = q.scales()[axis == 0 ? i : axis == 1 ? j : k];
+                    ASSERT_NEAR((back[Ind { i, j, k }]), (tensor[Ind { i, j, k }]), scale / 2 + 1e-6f);
+                }
+    }
+}
+
+TEST(QuantizedTensorTest, DynamicCoversRange)
+{
+    auto tensor = float_tensor({ 64 }, pattern(0.1f));
+    auto q = QuantizedTensor::quantize_dynamic(tensor);
+
+    auto back = q.dequantize();
+    for (size_t i = 0; i < 64; i++)
+        ASSERT_NEAR((back[Ind { i }]), (tensor[Ind { i }]), q.scale() / 2 + 1e-6f);
+}
+
+TEST(QuantizedTensorTest, InvalidParameters)
+{
+    auto tensor = float_tensor({ 2, 3 }, pattern(1.0f));
+
+    EXPECT_THROW(QuantizedTensor::quantize(tensor, 0.0f, 0), std::invalid_argument);
+    EXPECT_THROW(QuantizedTensor::quantize_per_channel(tensor, { 1.0f, 1.0f }, { 0, 0 }, 1), std::invalid_argument);
+    EXPECT_THROW(QuantizedTensor::quantize_per_channel(tensor, { 1.0f }, { 0 }, 2), std::invalid_argument);
+    EXPECT_THROW(QuantizedTensor::quantize_dynamic(Tensor<float>()), std::invalid_argument);
+    EXPECT_THROW(QuantizedTensor::quantize_dynamic(Tensor<float>::empty({ 0, 3 })), std::invalid_argument);
+
+    // -128 is outside the symmetric range the int8 GEMM relies on.
+    auto* values = new int8_t[4] { 1, -127, 127, -128 };
+    EXPECT_THROW(QuantizedTensor(Tensor<int8_t>(values, { 2, 2 }), { 1.0f }, { 0 }), std::invalid_argument);
+    auto* in_range = new int8_t[4] { 1, -127, 127, 0 };
+    EXPECT_NO_THROW(QuantizedTensor(Tensor<int8_t>(in_range, { 2, 2 }), { 1.0f }, { 0 }));
+}
+
+static void check_matmul(const QuantizedTensor& a, const QuantizedTensor& b)
+{
+    auto a_real = a.dequantize(), b_real = b.dequantize();
+    auto result = Tensile::quantized_matmul(a, b);
+    size_t m = a.shape()[0], k = a.shape()[1], n = b.shape()[1];
+
+    ASSERT_EQ(result.shape()[0], m);
+    ASSERT_EQ(result.shape()[1], n);
+    for (size_t i = 0; i < m; i++)
+        for (size_t j = 0; j < n; j++) {
+            double expected = 0;
+            for (size_t p = 0; p < k; p++)
+                expected += (double)a_real[Ind { i, p }] * (double)b_real[Ind { p, j }];
+            ASSERT_NEAR((result[Ind { i, j }]), expected, 1e-3 * (1 + std::abs(expected)));
+        }
+}
+
+TEST(QuantizedMatmulTest, PerTensor)
+{
+    auto a = QuantizedTensor::quantize(float_tensor({ 7, 70 }, pattern(0.5f)), 0.5f, 4);
+    auto b = QuantizedTensor::quantize(float_tensor({ 70, 11 }, pattern(0.25f), 5), 0.25f, -2);
+
+    check_matmul(a, b);
+}
+
+TEST(QuantizedMatmulTest, PerChannel)
+{
+    auto a = QuantizedTensor::quantize_symmetric_per_channel(float_tensor({ 6, 33 }, pattern(0.3f)), 0);
+    auto b = QuantizedTensor::quantize_symmetric_per_channel(float_tensor({ 33, 9 }, pattern(0.7f), 3), 1);
+
+    check_matmul(a, b);
+}
+
+TEST(QuantizedMatmulTest, ExtremeValuesDoNotSaturate)
+{
+    auto* a_data = new float[2 * 64];
+    auto* b_data = new float[64 * 2];
+    for (size_t i = 0; i < 128; i++) {
+        a_data[i] = i % 2 == 0 ? 127.0f : -127.0f;
+        b_data[i] = i % 3 == 0 ? -127.0f : 127.0f;
+    }
+    auto a = QuantizedTensor::quantize(Tensor<float>(a_data, { 2, 64 }), 1.0f, 0);
+    auto b = QuantizedTensor::quantize(Tensor<float>(b_data, { 64, 2 }), 1.0f, 0);
+
+    check_matmul(a, b);
+}
+
+TEST(QuantizedMatmulTest, Requantized)
+{
+    auto a = QuantizedTensor::quantize(float_tensor({ 4, 40 }, pattern(0.1f)), 0.1f, 0);
+    auto b = QuantizedTensor::quantize(float_tensor({ 40, 5 }, pattern(0.1f), 1), 0.1f, 0);
+
+    auto expected = Tensile::quantized_matmul(a, b);
+    auto result = Tensile::quantized_matmul(a, b, 0.05f, 1);
+
+    ASSERT_EQ(result.scale(), 0.05f);
+    auto back = result.dequantize();
+    for (size_t i = 0; i < 4; i++)
+        for (size_t j = 0; j < 5; j++) {
+            float clamped = std::clamp((expected[Ind { i, j }]), (-127 - 1) * 0.05f, (127 - 1) * 0.05f);
+            ASSERT_NEAR((back[Ind { i, j }]), clamped, 0.025f + 1e-5f);
+        }
+}
+
+TEST(QuantizedMatmulTest, RejectsUnfactorableAxes)
+{
+    auto a = QuantizedTensor::quantize_symmetric_per_channel(float_tensor({ 3, 4 }, pattern(1.0f)), 1);
+    auto b = QuantizedTensor::quantize(float_tensor({ 4, 2 }, pattern(1.0f)), 1.0f, 0);
+
+    EXPECT_THROW(Tensile::quantized_matmul(a, b), std::invalid_argument);
+}
@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <immintrin.h>
+#include <omp.h>
+#include <vector>
+
+#include "tensile/random.h"
+#include "tensile/simd_math.h"
+#include "tensile/tensor.h"
+
+using std::vector;
+using Tensile::Philox4x32;
+using Tensile::Tensor;
+
+// Known-answer vectors from the Random123 distribution (kat_vectors, philox4x32_10).
+TEST(RandomTests, PhiloxKnownAnswers)
+{
+    using Words = std::array<uint32_t, 4>;
+
+    EXPECT_EQ(Tensile::philox4x32_10({ 0, 0, 0, 0 }, { 0, 0 }),
+              (Words { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 }));
+    EXPECT_EQ(Tensile::philox4x32_10({ 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }, { 0xffffffff, 0xffffffff }),
+              (Words { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd }));
+    EXPECT_EQ(Tensile::philox4x32_10({ 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, { 0xa4093822, 0x299f31d0 }),
+              (Words { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 }));
+
+    EXPECT_EQ(Philox4x32(0).block(0), (Words { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 }));
+}
+
+// The vectorized fill must produce exactly the words of the scalar block function, in stream order, including
+// across a carry from the low into the high counter word.
+TEST(RandomTests, UniformMatchesScalarBlocks)
+{
+    for (uint64_t offset : { uint64_t(0), uint64_t(0xfffffffc) }) {
+        Philox4x32 gen(1234, offset);
+        vector<float> out(101);
+        gen.fill_uniform(out.data(), out.size());
+
+        Philox4x32 ref(1234);
+        for (size_t i = 0; i < out.size(); i++) {
+            uint32_t word = ref.block(offset + i / 4)[i % 4];
+            ASSERT_EQ(out[i], (float)(word >> 8) / 16777216.0f) << "offset " << offset << " i " << i;
+        }
+        EXPECT_EQ(gen.offset(), offset + 26);
+    }
+}
+
+// Double fills take one block per pair of elements: words (0, 1) for the even element, (2, 3) for the odd one.
+TEST(RandomTests, DoubleFillsMatchScalarBlocks)
+{
+    auto unit = [](uint32_t hi, uint32_t lo) {
+        return (double)((((uint64_t)hi << 32) | lo) >> 11) / 9007199254740992.0;
+    };
+
+    for (uint64_t offset : { uint64_t(0), uint64_t(0xfffffffa) }) {
+        Philox4x32 gen(99, offset);
+        vector<double> uniform(37), normal(37);
+        gen.fill_uniform(uniform.data(), uniform.size());
+        EXPECT_EQ(gen.offset(), offset + 19);
+        gen.fill_normal(normal.data(), normal.size(), 1.0, 3.0);
+
+        Philox4x32 ref(99);
+        for (size_t i = 0; i < uniform.size(); i++) {
+            auto words = ref.block(offset + i / 2);
+            size_t w = 2 * (i % 2);
+            ASSERT_EQ(uniform[i], unit(words[w], words[w + 1])) << "offset " << offset << " i " << i;
+
+            words = ref.block(offset + 19 + i / 2);
+            double radius = std::sqrt(-2 * std::log(unit(words[0], words[1]) + 1.0 / 9007199254740992.0));
+            double theta = 2 * M_PI * unit(words[2], words[3]);
+            double expected = 1.0 + 3.0 * radius * (i % 2 == 0 ? std::cos(theta) : std::sin(theta));
+            ASSERT_NEAR(normal[i], expected, 1e-12 * (1 + std::abs(expected))) << "offset " << offset << " i " << i;
+        }
+    }
+}
+
+TEST(RandomTests, FillIndependentOfThreadCount)
+{
+    const size_t n = (1 << 17) + 13;
+    vector<float> uniform_ref(n), normal_ref(n), uniform(n), normal(n);
+
+    int threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    Philox4x32 gen(42);
+    gen.fill_uniform(uniform_ref.data(), n);
+    gen.fill_normal(normal_ref.data(), n);
+    omp_set_num_threads(threads);
+
+    Philox4x32 gen2(42);
+    gen2.fill_uniform(uniform.data(), n);
+    gen2.fill_normal(normal.data(), n);
+
+    EXPECT_EQ(uniform, uniform_ref);
+    EXPECT_EQ(normal, normal_ref);
+}
+
+// Filling in two calls of whole blocks continues the same stream as one call.
+TEST(RandomTests, SplitFillContinuesStream)
+{
+    vector<float> whole(1000), split(1000);
+    Philox4x32 a(7), b(7);
+    a.fill_normal(whole.data(), whole.size());
+    b.fill_normal(split.data(), 324);
+    b.fill_normal(split.data() + 324, 676);
+
+    EXPECT_EQ(whole, split);
+    EXPECT_EQ(a.offset(), b.offset());
+}
+
+TEST(RandomTests, SeedsDiffer)
+{
+    vector<float> a(64), b(64);
+    Philox4x32(1).fill_uniform(a.data(), a.size());
+    Philox4x32(2).fill_uniform(b.data(), b.size());
+    EXPECT_NE(a, b);
+}
+
+template <typename T> static void expect_moments(const vector<T>& v, double mean, double stddev, double tol)
+{
+    double sum = 0, sq = 0;
+    for (T x : v) {
+        sum += x;
+        sq += (double)x * x;
+    }
+    double m = sum / (double)v.size();
+    EXPECT_NEAR(m, mean, tol);
+    EXPECT_NEAR(std::sqrt(sq / (double)v.size() - m * m), stddev, tol);
+}
+
+TEST(RandomTests, UniformRangeAndMoments)
+{
+    vector<float> f(1 << 18);
+    Philox4x32 gen(3);
+    gen.fill_uniform(f.data(), f.size(), -2.0f, 6.0f);
+    for (float x : f) {
+        ASSERT_GE(x, -2.0f);
+        ASSERT_LT(x, 6.0f);
+    }
+    expect_moments(f, 2.0, 8.0 / std::sqrt(12.0), 0.02);
+
+    vector<double> d(1 << 17);
+    gen.fill_uniform(d.data(), d.size());
+    for (double x : d) {
+        ASSERT_GE(x, 0.0);
+        ASSERT_LT(x, 1.0);
+    }
+    expect_moments(d, 0.5, 1 / std::sqrt(12.0), 0.005);
+}
+
+TEST(RandomTests, UniformExcludesHigh)
+{
+    // The range is two ulps wide, so low + u * (high - low) rounds up to `high` for about a quarter of the draws.
+    vector<float> f(1000);
+    Philox4x32 gen(11);
+    gen.fill_uniform(f.data(), f.size(), 16777216.0f, 16777220.0f);
+    for (float x : f)
+        ASSERT_LT(x, 16777220.0f);
+
+    vector<double> d(1000);
+    gen.fill_uniform(d.data(), d.size(), 9007199254740992.0, 9007199254740996.0);
+    for (double x : d)
+        ASSERT_LT(x, 9007199254740996.0);
+}
+
+TEST(RandomTests, NormalMoments)
+{
+    vector<float> f(1 << 18);
+    Philox4x32 gen(5);
+    gen.fill_normal(f.data(), f.size(), 1.5f, 2.0f);
+    for (float x : f)
+        ASSERT_TRUE(std::isfinite(x));
+    expect_moments(f, 1.5, 2.0, 0.02);
+
+    // Tail mass beyond two standard deviations is about 4.55%.
+    size_t tail = 0;
+    for (float x : f)
+        tail += std::abs(x - 1.5f) > 4.0f;
+    EXPECT_NEAR((double)tail / (double)f.size(), 0.0455, 0.003);
+
+    vector<double> d(1 << 17);
+    gen.fill_normal(d.data(), d.size());
+    expect_moments(d, 0.0, 1.0, 0.02);
+}
+
+TEST(RandomTests, VectorLogAndSinCos)
+{
+    alignas(32) float in[8], log_out[8], sin_out[8], cos_out[8];
+    for (int step = 0; step < 4096; step++) {
+        for (int j = 0; j < 8; j++)
+            in[j] = (float)(step * 8 + j + 1) / 32768.0f * 6.2831853f;
+
+        __m256 x = _mm256_load_ps(in), s, c;
+        _mm256_store_ps(log_out, Tensile::log_ps(x));
+        Tensile::sincos_ps(x, s, c);
+        _mm256_store_ps(sin_out, s);
+        _mm256_store_ps(cos_out, c);
+
+        for (int j = 0; j < 8; j++) {
+            ASSERT_NEAR(log_out[j], std::log((double)in[j]), 1e-6 * (1 + std::abs(std::log((double)in[j]))));
+            ASSERT_NEAR(sin_out[j], std::sin((double)in[j]), 2e-7);
+            ASSERT_NEAR(cos_out[j], std::cos((double)in[j]), 2e-7);
+        }
+    }
+}
+
+TEST(RandomTests, TensorFactories)
+{
+    Philox4x32 a(9), b(9);
+    auto t = Tensor<float>::randn({ 4, 5, 6 }, a);
+    vector<float> ref(120);
+    b.fill_normal(ref.data(), ref.size());
+
+    EXPECT_EQ(t.shape(), (std::array<size_t, 4> { 4, 5, 6, 0 }));
+    EXPECT_EQ(vector<float>(t.data(), t.data() + 120), ref);
+
+    auto u = Tensor<double>::uniform({ 3, 7 }, 10.0, 20.0, a);
+    for (size_t i = 0; i < 21; i++) {
+        EXPECT_GE(u.data()[i], 10.0);
+        EXPECT_LT(u.data()[i], 20.0);
+    }
+
+    auto r = Tensor<float>::rand({ 16 });
+    for (size_t i = 0; i < 16; i++) {
+        EXPECT_GE(r.data()[i], 0.0f);
+        EXPECT_LT(r.data()[i], 1.0f);
+    }
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include "tensile/tensor.h"
+#include "test_utils.h"
+
+using std::make_tuple;
+using std::tuple;
+using std::vector;
+using Tensile::Tensor;
+
+// Test fixture for tensor reshape tests. Takes in 2 parameters:
+// 1. The shape of the tensor (std::vector<size_t>).
+// 2. The shape to reshape the tensor to (std::vector<size_t>).
+
+class ReshapeTest : public ::testing::TestWithParam<tuple<vector<size_t>, vector<size_t>>> { };
+
+TEST_P(ReshapeTest, ContiguousReshapeIsView)
+{
+    auto [shape, new_shape] = GetParam();
+    auto tensor = create_tensor(shape);
+
+    auto reshaped = tensor.reshape(new_shape);
+
+    ASSERT_TRUE(reshaped.is_view());
+    ASSERT_TRUE(reshaped.shares_storage(tensor));
+    ASSERT_EQ(reshaped.n_dims(), new_shape.size());
+    for (size_t i = 0; i < new_shape.size(); i++)
+        ASSERT_EQ(reshaped.shape()[i], new_shape[i]);
+    ASSERT_EQ(reshaped.flat_string(), tensor.flat_string());
+}
+
+INSTANTIATE_TEST_SUITE_P(TensorReshapeTests, ReshapeTest,
+                         ::testing::Values(make_tuple(vector<size_t> { 6 }, vector<size_t> { 2, 3 }),
+                                           make_tuple(vector<size_t> { 2, 3 }, vector<size_t> { 6 }),
+                                           make_tuple(vector<size_t> { 2, 3 }, vector<size_t> { 3, 2 }),
+                                           make_tuple(vector<size_t> { 2, 3, 4 }, vector<size_t> { 6, 4 }),
+                                           make_tuple(vector<size_t> { 2, 3, 4 }, vector<size_t> { 2, 12 }),
+                                           make_tuple(vector<size_t> { 2, 3, 4 }, vector<size_t> { 1, 24, 1 }),
+                                           make_tuple(vector<size_t> { 2, 3, 4, 5 }, vector<size_t> { 2, 60 }),
+                                           make_tuple(vector<size_t> { 1, 1, 1 }, vector<size_t> { 1 })));
+
+TEST(TensorReshapeTest, SliceReshapeIsView)
+{
+    auto tensor = create_tensor({ 4, 2, 3 });
+    auto slice = tensor["1:3, 0:2, 0:3"];
+
+    auto reshaped = slice.reshape({ 12 });
+
+    ASSERT_TRUE(reshaped.shares_storage(tensor));
+    ASSERT_EQ(reshaped.flat_string(), "[6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, ]");
+}
+
+TEST(TensorReshapeTest, TransposedReshapeCopies)
+{
+    auto tensor = create_tensor({ 2, 3 });
+    auto transposed = tensor.transpose();
+
+    auto reshaped = transposed.reshape({ 6 });
+
+    ASSERT_FALSE(reshaped.is_view());
+    ASSERT_FALSE(reshaped.shares_storage(tensor));
+    ASSERT_TRUE(reshaped.is_contiguous());
+    ASSERT_EQ(reshaped.flat_string(), "[0, 3, 1, 4, 2, 5, ]");
+}
+
+TEST(TensorReshapeTest, TransposedSplitIsView)
+{
+    auto tensor = create_tensor({ 4, 3 });
+    auto transposed = tensor.transpose(); // [3, 4] with strides [1, 3]
+
+    auto reshaped = transposed.view({ 3, 2, 2 });
+
+    ASSERT_TRUE(reshaped.shares_storage(tensor));
+    ASSERT_EQ(reshaped.flat_string(), transposed.flat_string());
+}
+
+TEST(TensorReshapeTest, ViewThrowsWhenCopyNeeded)
+{
+    auto tensor = create_tensor({ 2, 3 });
+    auto transposed = tensor.transpose();
+
+    EXPECT_THROW(transposed.view({ 6 }), std::invalid_argument);
+}
+
+TEST(TensorReshapeTest, ReshapeThrowsOnSizeMismatch)
+{
+    auto tensor = create_tensor({ 2, 3 });
+
+    EXPECT_THROW(tensor.reshape({ 4 }), std::invalid_argument);
+    EXPECT_THROW(tensor.reshape({ 6, 0 }), std::invalid_argument);
+    EXPECT_THROW(tensor.reshape({ 1, 1, 1, 1, 6 }), std::invalid_argument);
+}
+
+TEST(TensorReshapeTest, Flatten)
+{
+    auto tensor = create_tensor({ 2, 3, 4, 5 });
+
+    auto flat = tensor.flatten();
+    ASSERT_EQ(flat.n_dims(), 1);
+    ASSERT_EQ(flat.shape()[0], 120);
+    ASSERT_TRUE(flat.shares_storage(tensor));
+
+    auto batched = tensor.flatten(1);
+    ASSERT_EQ(batched.n_dims(), 2);
+    ASSERT_EQ(batched.shape()[0], 2);
+    ASSERT_EQ(batched.shape()[1], 60);
+
+    auto middle = tensor.flatten(1, 2);
+    ASSERT_EQ(middle.n_dims(), 3);
+    ASSERT_EQ(middle.shape()[0], 2);
+    ASSERT_EQ(middle.shape()[1], 12);
+    ASSERT_EQ(middle.shape()[2], 5);
+}
+
+TEST(TensorReshapeTest, CopyOfSliceIsContiguous)
+{
+    auto tensor = create_tensor({ 3, 3 });
+    auto slice = tensor["1:3, 1:3"];
+
+    auto copied = slice.copy();
+
+    ASSERT_FALSE(copied.is_view());
+    ASSERT_TRUE(copied.is_contiguous());
+    ASSERT_EQ(copied.flat_string(), "[4, 5, 7, 8, ]");
+}
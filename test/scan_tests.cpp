@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "tensile/tensor.h"
+#include "test_utils.h"
+
+using std::vector;
+using Tensile::Tensor;
+
+static Tensor<float> wavy(const vector<size_t>& shape)
+{
+    return fill_tensor<float>(shape, [](size_t i) { return std::sin((float)i * 0.37f) + 0.25f; });
+}
+
+// Serial scan of a contiguous [outer, len, inner] array in double precision.
+static vector<double> reference_cumsum(const float* x, size_t outer, size_t len, size_t inner)
+{
+    vector<double> out(x, x + outer * len * inner);
+    for (size_t o = 0; o < outer; o++)
+        for (size_t j = 1; j < len; j++)
+            for (size_t k = 0; k < inner; k++)
+                out[(o * len + j) * inner + k] += out[(o * len + j - 1) * inner + k];
+    return out;
+}
+
+TEST(ScanTests, CumsumEveryAxis)
+{
+    vector<size_t> shape { 5, 19, 7 };
+    auto x = wavy(shape);
+    for (size_t axis = 0; axis < 3; axis++) {
+        size_t outer = 1, inner = 1;
+        for (size_t d = 0; d < axis; d++)
+            outer *= shape[d];
+        for (size_t d = axis + 1; d < 3; d++)
+            inner *= shape[d];
+
+        auto s = x.cumsum(axis);
+        auto expected = reference_cumsum(x.data(), outer, shape[axis], inner);
+        for (size_t i = 0; i < x.size(); i++)
+            ASSERT_NEAR(s.data()[i], expected[i], 1e-4) << axis;
+    }
+
+    auto ints = create_tensor({ 2, 4 });
+    EXPECT_EQ(ints.cumsum(1).flat_string(), "[0, 1, 3, 6, 4, 9, 15, 22, ]");
+    EXPECT_EQ(ints.cumsum(0).flat_string(), "[0, 1, 2, 3, 4, 6, 8, 10, ]");
+    EXPECT_THROW(ints.cumsum(2), std::invalid_argument);
+}
+
+// One long line takes the blocked path: eight blocks scanned in parallel, then fixed up with their carries.
+TEST(ScanTests, LongLine)
+{
+    const size_t n = (1 << 18) + 13;
+    auto x = wavy({ n });
+    auto s = x.cumsum(0);
+    auto expected = reference_cumsum(x.data(), 1, n, 1);
+    for (size_t i = 0; i < n; i++)
+        ASSERT_NEAR(s.data()[i], expected[i], 1e-5 * std::max(1.0, std::abs(expected[i]))) << i;
+
+    // Repeated runs give identical bits.
+    auto again = x.cumsum(0);
+    EXPECT_EQ(s, again);
+
+    auto m = x.cummax(0);
+    float running = -std::numeric_limits<float>::infinity();
+    for (size_t i = 0; i < n; i++) {
+        running = std::max(running, x.data()[i]);
+        ASSERT_EQ(m.data()[i], running) << i;
+    }
+}
+
+TEST(ScanTests, CumprodAndCummin)
+{
+    auto x = Tensor<float>(new float[10] { 1, 2, 0.5f, 3, -1, 2, 2, 2, 2, 2 }, { 10 });
+    auto p = x.cumprod(0);
+    vector<float> expected_p { 1, 2, 1, 3, -3, -6, -12, -24, -48, -96 };
+    EXPECT_EQ(vector<float>(p.data(), p.data() + 10), expected_p);
+
+    auto m = x.cummin(0);
+    vector<float> expected_m { 1, 1, 0.5f, 0.5f, -1, -1, -1, -1, -1, -1 };
+    EXPECT_EQ(vector<float>(m.data(), m.data() + 10), expected_m);
+
+    auto d = Tensor<double>(new double[4] { 3, 1, 4, 1 }, { 2, 2 });
+    EXPECT_EQ(d.cumprod(0).flat_string({ .precision = 0 }), "[3, 1, 12, 1, ]");
+}
+
+TEST(ScanTests, CummaxPropagatesNaN)
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    // Long enough for the vector path, with the NaN in the middle of a vector.
+    vector<float> values { 1, 5, 2, 7, 3, nan, 9, 1, 2, 3, 4 };
+    auto x = Tensor<float>(new float[11], { 11 });
+    std::copy(values.begin(), values.end(), x.data());
+
+    for (auto m : { x.cummax(0), x.cummin(0) }) {
+        for (size_t i = 0; i < 5; i++)
+            EXPECT_FALSE(std::isnan(m.data()[i]));
+        for (size_t i = 5; i < 11; i++)
+            EXPECT_TRUE(std::isnan(m.data()[i])) << i;
+    }
+
+    auto d = Tensor<double>(new double[3] { 1, std::nan(""), 2 }, { 3 });
+    EXPECT_TRUE(std::isnan(d.cummax(0).data()[2]));
+}
+
+TEST(ScanTests, InPlaceOnViews)
+{
+    auto storage = wavy({ 6, 40 });
+    auto expected = storage.cumsum(1);
+
+    // Axis 0 of the transpose runs along the rows of the storage.
+    auto t = storage.transpose();
+    t.cumsum_inplace(0);
+    for (size_t i = 0; i < storage.size(); i++)
+        ASSERT_NEAR(storage.data()[i], expected.data()[i], 1e-5);
+
+    auto ints = create_tensor({ 3, 3 });
+    ints.cummax_inplace(1).cumsum_inplace(0);
+    EXPECT_EQ(ints.flat_string(), "[0, 1, 2, 3, 5, 7, 9, 12, 15, ]");
+
+    // Inner-axis scan of a contiguous float tensor in place.
+    auto rows = wavy({ 4, 3, 100 });
+    auto scanned = rows.cumsum(1);
+    rows.cumsum_inplace(1);
+    EXPECT_EQ(rows, scanned);
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "tensile/tensor.h"
+#include "test_utils.h"
+
+using Tensile::Tensor;
+
+// Names are per process so that concurrent test runs on one host do not collide.
+static std::string shared_name(const std::string& name) { return "test_" + std::to_string(getpid()) + "_" + name; }
+
+static bool is_listed(const std::string& name)
+{
+    auto names = Tensile::shared_names();
+    return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+TEST(SharedTests, ShareAndAttach)
+{
+    std::string name = shared_name("weights");
+    auto source = fill_tensor<float>({ 4, 6 }, [](size_t i) { return i; });
+    {
+        auto owner = source.transpose().share(name);
+        EXPECT_TRUE(owner.is_contiguous());
+        EXPECT_EQ(owner, source.transpose());
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(owner.data()) % 4096, 0u);
+        EXPECT_TRUE(is_listed(name));
+        EXPECT_EQ(Tensile::shared_references(owner.data()), 1u);
+
+        {
+            auto attached = Tensor<float>::attach_shared(name);
+            EXPECT_EQ(attached, owner);
+            EXPECT_EQ(Tensile::shared_references(owner.data()), 2u);
+
+            // Views borrow the reference of the tensor they come from.
+            auto view = attached["1:4, 2:4"];
+            EXPECT_EQ(Tensile::shared_references(owner.data()), 2u);
+            EXPECT_EQ(view, owner["1:4, 2:4"]);
+
+            // A writable attachment sees the same memory.
+            auto writable = Tensor<float>::attach_shared(name, true);
+            writable.data()[0] = -1;
+            EXPECT_EQ(owner.data()[0], -1.0f);
+            EXPECT_EQ(attached.data()[0], -1.0f);
+            EXPECT_EQ(Tensile::shared_references(owner.data()), 3u);
+        }
+        EXPECT_EQ(Tensile::shared_references(owner.data()), 1u);
+
+        EXPECT_THROW(source.share(name), std::runtime_error);
+        EXPECT_THROW(Tensor<int32_t>::attach_shared(name), std::runtime_error);
+    }
+
+    // The last reference removed the name.
+    EXPECT_FALSE(is_listed(name));
+    EXPECT_THROW(Tensor<float>::attach_shared(name), std::runtime_error);
+
+    EXPECT_THROW(source.share(""), std::invalid_argument);
+    EXPECT_THROW(source.share("a/b"), std::invalid_argument);
+    EXPECT_THROW(Tensor<float>().share(shared_name("empty")), std::invalid_argument);
+}
+
+TEST(SharedTests, AttachFromOtherProcess)
+{
+    std::string name = shared_name("cross");
+    auto owner = fill_tensor<int32_t>({ 1000 }, [](size_t i) { return i; }).share(name);
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        // The child checks what it sees and reports through its exit status.
+        bool ok = true;
+        {
+            auto weights = Tensor<int32_t>::attach_shared(name);
+            for (int32_t i = 0; i < 1000; i++)
+                ok = ok && weights.data()[i] == i;
+            ok = ok && Tensile::shared_references(weights.data()) == 2;
+            auto scratch = Tensor<int32_t>::attach_shared(name, true);
+            scratch.data()[999] = -7;
+        }
+        _exit(ok ? 0 : 1);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    EXPECT_EQ(owner.data()[999], -7);
+    EXPECT_EQ(Tensile::shared_references(owner.data()), 1u);
+}
+
+TEST(SharedTests, RemoveLeaked)
+{
+    std::string name = shared_name("leaked");
+    auto replacement = Tensor<double>::empty({ 2 });
+    {
+        auto owner = Tensor<double>::full({ 3 }, 2.5).share(name);
+
+        // Unlinking a name leaves current mappings valid, and frees the name for a new tensor.
+        EXPECT_TRUE(Tensile::remove_shared(name));
+        EXPECT_FALSE(Tensile::remove_shared(name));
+        EXPECT_FALSE(is_listed(name));
+        EXPECT_EQ(owner.data()[2], 2.5);
+
+        replacement = Tensor<double>::full({ 2 }, 1.0).share(name);
+    }
+
+    // Releasing the old tensor did not unlink the new one.
+    EXPECT_TRUE(is_listed(name));
+    EXPECT_EQ(Tensor<double>::attach_shared(name).size(), 2u);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include "tensile/small_tensor.h"
+#include "test_utils.h"
+
+using Tensile::Mat4;
+using Tensile::SmallTensor;
+using Tensile::Vec3;
+using Tensile::Vec4;
+
+static_assert(std::is_trivially_copyable_v<Mat4<float>>);
+static_assert(sizeof(Mat4<float>) == 16 * sizeof(float));
+static_assert(sizeof(Vec3<double>) == 3 * sizeof(double));
+static_assert(sizeof(SmallTensor<int>) == sizeof(int));
+
+TEST(SmallTensorTest, Construction)
+{
+    SmallTensor<int, 2, 3> t { 0, 1, 2, 3, 4, 5 };
+
+    ASSERT_EQ(t.n_dims(), 2);
+    ASSERT_EQ(t.size(), 6);
+    ASSERT_EQ(t.shape()[0], 2);
+    ASSERT_EQ(t.shape()[1], 3);
+    ASSERT_EQ(t(1, 2), 5);
+    ASSERT_EQ((SmallTensor<int, 2, 3>::zeros()(1, 1)), 0);
+    ASSERT_EQ((SmallTensor<int, 2, 3>::full(7)(0, 2)), 7);
+    EXPECT_THROW((SmallTensor<int, 2> { 1, 2, 3 }), std::invalid_argument);
+    EXPECT_THROW(t(2, 0), std::out_of_range);
+}
+
+TEST(SmallTensorTest, Scalar)
+{
+    SmallTensor<float> s { 2.5f };
+
+    ASSERT_EQ(s.n_dims(), 0);
+    ASSERT_FLOAT_EQ((s + s).item(), 5.0f);
+
+    // Scalars cross over to Tensor as [1] tensors.
+    auto t = s.to_tensor();
+    ASSERT_EQ(t.n_dims(), 1);
+    ASSERT_EQ(t.size(), 1);
+    ASSERT_FLOAT_EQ(t.data()[0], 2.5f);
+    ASSERT_EQ(SmallTensor<float>::from_tensor(t), s);
+    EXPECT_THROW(SmallTensor<float>::from_tensor(Tensile::Tensor<float>::zeros({ 2 })), std::invalid_argument);
+}
+
+TEST(SmallTensorTest, CopyIsIndependent)
+{
+    Vec3<int> a { 1, 2, 3 };
+    Vec3<int> b = a;
+    b(0) = 10;
+
+    ASSERT_EQ(a(0), 1);
+    ASSERT_EQ(b(0), 10);
+}
+
+TEST(SmallTensorTest, ElementwiseOps)
+{
+    Vec4<int> a { 1, 2, 3, 4 };
+    Vec4<int> b { 4, 3, 2, 1 };
+
+    ASSERT_EQ(a + b, Vec4<int>::full(5));
+    ASSERT_EQ(a - b, (Vec4<int> { -3, -1, 1, 3 }));
+    ASSERT_EQ(a.elementwise_mul(b), (Vec4<int> { 4, 6, 6, 4 }));
+    ASSERT_EQ(a * 2, (Vec4<int> { 2, 4, 6, 8 }));
+    ASSERT_EQ(-a, (Vec4<int> { -1, -2, -3, -4 }));
+    ASSERT_EQ(a.sum(), 10);
+    ASSERT_EQ(a.dot(b), 20);
+}
+
+TEST(SmallTensorTest, Cross)
+{
+    Vec3<int> x { 1, 0, 0 };
+    Vec3<int> y { 0, 1, 0 };
+
+    ASSERT_EQ(x.cross(y), (Vec3<int> { 0, 0, 1 }));
+}
+
+TEST(SmallTensorTest, Matmul)
+{
+    SmallTensor<int, 2, 3> a { 0, 1, 2, 3, 4, 5 };
+    SmallTensor<int, 3, 2> b { 0, 1, 2, 3, 4, 5 };
+
+    auto c = a * b;
+
+    ASSERT_EQ(c, (SmallTensor<int, 2, 2> { 10, 13, 28, 40 }));
+    ASSERT_EQ(a.transpose(), (SmallTensor<int, 3, 2> { 0, 3, 1, 4, 2, 5 }));
+    ASSERT_EQ((Mat4<int>::identity() * Vec4<int> { 1, 2, 3, 4 }), (Vec4<int> { 1, 2, 3, 4 }));
+}
+
+TEST(SmallTensorTest, ConstexprMatmul)
+{
+    constexpr auto m = Mat4<int>::identity() * Mat4<int>::full(3);
+    static_assert(m(3, 3) == 3);
+}
+
+TEST(SmallTensorTest, TensorRoundTrip)
+{
+    auto tensor = create_tensor({ 2, 3 });
+    auto small = SmallTensor<int, 2, 3>::from_tensor(tensor);
+
+    ASSERT_EQ(small(1, 0), 3);
+    ASSERT_EQ(small.to_tensor().flat_string(), tensor.flat_string());
+    ASSERT_EQ((SmallTensor<int, 3, 2>::from_tensor(tensor.transpose())), small.transpose());
+    EXPECT_THROW((SmallTensor<int, 3, 2>::from_tensor(tensor)), std::invalid_argument);
+}
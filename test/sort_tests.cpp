@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "tensile/tensor.h"
+#include "test_utils.h"
+
+using std::vector;
+using Tensile::Tensor;
+
+// Scores with many repeated values, so ties are exercised.
+static Tensor<float> scores(const vector<size_t>& shape, size_t seed = 0)
+{
+    return fill_tensor<float>(shape,
+                              [=](size_t i) { return (float)((i * 2654435761u + seed) % 1009) * 0.25f - 100.0f; });
+}
+
+// Stable reference argsort of a strided line.
+static vector<int64_t> reference_order(const float* line, size_t len, size_t stride, bool descending)
+{
+    vector<int64_t> order(len);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+        float x = line[a * stride], y = line[b * stride];
+        return descending ? x > y : x < y;
+    });
+    return order;
+}
+
+TEST(SortTests, SortAndArgsortEveryAxis)
+{
+    auto x = scores({ 5, 37, 6 });
+    auto s = x.strides();
+    for (size_t axis = 0; axis < 3; axis++) {
+        for (bool descending : { false, true }) {
+            auto sorted = x.sort(axis, descending);
+            auto order = x.argsort(axis, descending);
+
+            size_t len = x.shape()[axis];
+            for (size_t i = 0; i < x.size() / len; i++) {
+                // Line i: decompose over the other two dimensions in row-major order.
+                size_t pos[3] = { 0, 0, 0 };
+                for (size_t d = 3, rem = i; d-- > 0;) {
+                    if (d == axis)
+                        continue;
+                    pos[d] = rem % x.shape()[d];
+                    rem /= x.shape()[d];
+                }
+                size_t start = pos[0] * s[0] + pos[1] * s[1] + pos[2] * s[2];
+                auto expected = reference_order(x.data() + start, len, s[axis], descending);
+                for (size_t j = 0; j < len; j++) {
+                    ASSERT_EQ(order.data()[start + j * s[axis]], expected[j]) << axis << " " << i;
+                    ASSERT_EQ(sorted.data()[start + j * s[axis]], x.data()[start + expected[j] * s[axis]]);
+                }
+            }
+        }
+    }
+}
+
+TEST(SortTests, StridedInputAndNaN)
+{
+    float nan = std::numeric_limits<float>::quiet_NaN();
+    auto storage = Tensor<float>(new float[6] { 3, nan, 1, 2, -1, 5 }, { 2, 3 });
+    auto t = storage.transpose();
+
+    // Columns of the storage are the rows of t: {3, 2}, {nan, -1}, {1, 5}.
+    auto order = t.argsort(1);
+    EXPECT_EQ(order.flat_string(), "[1, 0, 1, 0, 0, 1, ]");
+    auto desc = t.argsort(1, true);
+    EXPECT_EQ(desc.flat_string(), "[0, 1, 0, 1, 1, 0, ]");
+
+    auto ints = create_tensor({ 2, 4 });
+    EXPECT_EQ(ints.sort(1, true).flat_string(), "[3, 2, 1, 0, 7, 6, 5, 4, ]");
+    EXPECT_EQ(ints.argsort(0, true).flat_string(), "[1, 1, 1, 1, 0, 0, 0, 0, ]");
+}
+
+// A single long row goes through the parallel merge sort.
+TEST(SortTests, LongRow)
+{
+    auto x = scores({ 1, 300001 }, 7);
+    auto order = x.argsort(1);
+    auto expected = reference_order(x.data(), x.size(), 1, false);
+    EXPECT_EQ(vector<int64_t>(order.data(), order.data() + order.size()), expected);
+}
+
+TEST(SortTests, TopK)
+{
+    for (auto shape : { vector<size_t> { 16, 1000 }, vector<size_t> { 2, 400000 } }) {
+        auto x = scores(shape, 3);
+        size_t len = shape[1];
+        for (bool largest : { true, false }) {
+            auto [values, indices] = x.topk(10, 1, largest);
+            ASSERT_EQ(values.shape()[1], 10);
+            for (size_t r = 0; r < shape[0]; r++) {
+                auto expected = reference_order(x.data() + r * len, len, 1, largest);
+                for (size_t i = 0; i < 10; i++) {
+                    ASSERT_EQ(indices.data()[r * 10 + i], expected[i]) << r << " " << i;
+                    ASSERT_EQ(values.data()[r * 10 + i], x.data()[r * len + expected[i]]);
+                }
+            }
+        }
+    }
+}
+
+TEST(SortTests, TopKAlongLeadingAxis)
+{
+    auto x = scores({ 50, 3 });
+    auto [values, indices] = x.topk(4, 0);
+    ASSERT_EQ(values.shape()[0], 4);
+    ASSERT_EQ(values.shape()[1], 3);
+    for (size_t c = 0; c < 3; c++) {
+        auto expected = reference_order(x.data() + c, 50, 3, true);
+        for (size_t i = 0; i < 4; i++)
+            EXPECT_EQ(indices.data()[i * 3 + c], expected[i]);
+    }
+
+    EXPECT_THROW(x.topk(0, 0), std::invalid_argument);
+    EXPECT_THROW(x.topk(4, 1), std::invalid_argument);
+    EXPECT_THROW(x.sort(2), std::invalid_argument);
+}
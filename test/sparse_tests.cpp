@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "tensile/sparse.h"
+#include "test_utils.h"
+
+using std::vector;
+using Ind = std::vector<size_t>;
+using Tensile::CooTensor;
+using Tensile::CsrTensor;
+using Tensile::Tensor;
+
+// 4x5 matrix with an empty row:
+// [[0, 1, 0, 0, 2],
+//  [0, 0, 0, 0, 0],
+//  [3, 0, 0, 4, 0],
+//  [0, 0, 5, 0, 0]]
+static Tensor<int> sparse_matrix()
+{
+    auto* data = new int[20] { 0, 1, 0, 0, 2, 0, 0, 0, 0, 0, 3, 0, 0, 4, 0, 0, 0, 5, 0, 0 };
+    return Tensor<int>(data, { 4, 5 });
+}
+
+TEST(SparseTest, CsrFromDense)
+{
+    auto csr = CsrTensor<int>::from_dense(sparse_matrix());
+
+    ASSERT_EQ(csr.nnz(), 5);
+    ASSERT_EQ(csr.row_ptr(), (vector<size_t> { 0, 2, 2, 4, 5 }));
+    ASSERT_EQ(csr.col_idx(), (vector<size_t> { 1, 4, 0, 3, 2 }));
+    ASSERT_EQ(csr.values(), (vector<int> { 1, 2, 3, 4, 5 }));
+    ASSERT_TRUE(csr.to_dense() == sparse_matrix());
+}
+
+TEST(SparseTest, CsrRejectsInvalidArrays)
+{
+    EXPECT_THROW(CsrTensor<int>(2, 2, { 0, 1 }, { 0 }, { 1 }), std::invalid_argument);
+    EXPECT_THROW(CsrTensor<int>(2, 2, { 0, 1, 1 }, { 2 }, { 1 }), std::invalid_argument);
+    EXPECT_THROW(CsrTensor<int>(1, 3, { 0, 2 }, { 2, 1 }, { 1, 1 }), std::invalid_argument);
+}
+
+TEST(SparseTest, CooRoundTrip)
+{
+    auto dense = create_tensor({ 2, 3, 4 });
+    auto coo = CooTensor<int>::from_dense(dense);
+
+    ASSERT_EQ(coo.nnz(), 23); // element 0 is zero
+    ASSERT_EQ(coo.n_dims(), 3);
+    ASSERT_TRUE(coo.to_dense() == dense);
+}
+
+TEST(SparseTest, CooCoalesceAndToCsr)
+{
+    CooTensor<int> coo({ 3, 3 });
+    coo.insert({ 2, 1 }, 4);
+    coo.insert({ 0, 2 }, 1);
+    coo.insert({ 2, 1 }, 3);
+    coo.insert({ 0, 0 }, 5);
+    EXPECT_THROW(coo.insert({ 3, 0 }, 1), std::out_of_range);
+
+    auto csr = coo.to_csr();
+
+    ASSERT_EQ(csr.row_ptr(), (vector<size_t> { 0, 2, 2, 3 }));
+    ASSERT_EQ(csr.col_idx(), (vector<size_t> { 0, 2, 1 }));
+    ASSERT_EQ(csr.values(), (vector<int> { 5, 1, 7 }));
+    ASSERT_TRUE(csr.to_coo().to_dense() == coo.to_dense());
+}
+
+TEST(SparseTest, SpMM)
+{
+    auto csr = CsrTensor<int>::from_dense(sparse_matrix());
+    auto dense = create_tensor({ 5, 3 });
+
+    auto result = csr * dense;
+
+    auto expected = sparse_matrix() * dense;
+    ASSERT_TRUE(result == expected);
+}
+
+TEST(SparseTest, SpMMFloatStridedOperand)
+{
+    auto* a_data = new float[6] { 0, 1.5f, 0, -2, 0, 0 };
+    auto* b_data = new float[6] { 1, 2, 3, 4, 5, 6 };
+    Tensor<float> a(a_data, { 2, 3 });
+    Tensor<float> b(b_data, { 2, 3 });
+
+    auto result = CsrTensor<float>::from_dense(a).matmul(b.transpose());
+
+    ASSERT_FLOAT_EQ((result[Ind { 0, 0 }]), 3.0f);
+    ASSERT_FLOAT_EQ((result[Ind { 0, 1 }]), 7.5f);
+    ASSERT_FLOAT_EQ((result[Ind { 1, 0 }]), -2.0f);
+    ASSERT_FLOAT_EQ((result[Ind { 1, 1 }]), -8.0f);
+}
+
+TEST(SparseTest, SpMV)
+{
+    auto csr = CsrTensor<int>::from_dense(sparse_matrix());
+    auto vec = create_tensor({ 5 });
+
+    auto result = csr * vec;
+
+    ASSERT_EQ(result.n_dims(), 1);
+    ASSERT_EQ(result.flat_string(), "[9, 0, 12, 10, ]");
+    EXPECT_THROW(csr.matvec(create_tensor({ 4 })), std::invalid_argument);
+}
+
+TEST(SparseTest, ElementwiseMulKeepsPattern)
+{
+    auto csr = CsrTensor<int>::from_dense(sparse_matrix());
+    auto dense = create_tensor({ 4, 5 });
+
+    auto result = csr.elementwise_mul(dense);
+
+    ASSERT_EQ(result.col_idx(), csr.col_idx());
+    ASSERT_TRUE(result.to_dense() == sparse_matrix().elementwise_mul(dense));
+
+    auto row = create_tensor({ 1, 5 });
+    ASSERT_TRUE(csr.elementwise_mul(row).to_dense() == sparse_matrix().elementwise_mul(row));
+}
+
+TEST(SparseTest, CooElementwiseMul)
+{
+    auto matrix = sparse_matrix();
+    auto flat = matrix.reshape({ 20 });
+    auto coo = CooTensor<int>::from_dense(flat);
+    auto other = create_tensor({ 20 });
+
+    ASSERT_TRUE(coo.elementwise_mul(other).to_dense() == flat.elementwise_mul(other));
+    EXPECT_THROW(coo.elementwise_mul(create_tensor({ 2, 10 })), std::invalid_argument);
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "tensile/gemm.h"
+#include "tensile/stream.h"
+#include "test_utils.h"
+
+using std::vector;
+using Tensile::ReduceOp;
+using Tensile::StreamOptions;
+using Tensile::Tensor;
+
+static std::string temp_path(const std::string& name) { return ::testing::TempDir() + "tensile_stream_" + name; }
+
+// Writes a file-backed [rows, cols] matrix with a repeating pattern and returns it mapped.
+static Tensor<float> file_matrix(const std::string& path, size_t rows, size_t cols, size_t seed)
+{
+    auto t = Tensor<float>::create_file(path, { rows, cols });
+    float_tensor({ rows, cols }, seed).copy_to(t.data());
+    return t;
+}
+
+TEST(StreamTests, MapFile)
+{
+    std::string path = temp_path("map.bin");
+    {
+        vector<float> values { 1, 2, 3, 4, 5, 6 };
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+    }
+
+    // Private mappings can be written without changing the file; writable ones write through.
+    {
+        auto t = Tensor<float>::map_file(path, { 2, 3 });
+        EXPECT_EQ(t.flat_string(), "[1.000000, 2.000000, 3.000000, 4.000000, 5.000000, 6.000000, ]");
+        t.data()[0] = 100;
+    }
+    {
+        auto t = Tensor<float>::map_file(path, { 3, 2 }, true);
+        EXPECT_EQ(t.data()[0], 1.0f);
+        t.data()[5] = -6;
+    }
+    EXPECT_EQ(Tensor<float>::map_file(path, { 6 }).data()[5], -6.0f);
+
+    EXPECT_THROW(Tensor<float>::map_file(path, { 7 }), std::runtime_error);
+    EXPECT_THROW(Tensor<float>::map_file(temp_path("missing.bin"), { 1 }), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(StreamTests, MatmulWithinBudget)
+{
+    const size_t m = 70, k = 130, n = 90;
+    auto a = file_matrix(temp_path("a.bin"), m, k, 1);
+    auto b = file_matrix(temp_path("b.bin"), k, n, 2);
+    auto expected = Tensile::matmul_fused(a, b);
+
+    // From a budget that holds everything down to one that forces a few rows per block and narrow panels of B.
+    for (size_t budget : { size_t(1) << 30, size_t(64) << 10, size_t(4) << 10 }) {
+        auto c = Tensor<float>::create_file(temp_path("c.bin"), { m, n });
+        Tensile::matmul_streamed(a, b, c, StreamOptions { .memory_budget = budget });
+        for (size_t i = 0; i < m * n; i++)
+            ASSERT_NEAR(c.data()[i], expected.data()[i], 1e-4) << budget;
+    }
+
+    // The result reached the file.
+    auto written = Tensor<float>::map_file(temp_path("c.bin"), { m, n });
+    for (size_t i = 0; i < m * n; i++)
+        ASSERT_NEAR(written.data()[i], expected.data()[i], 1e-4);
+
+    auto c = Tensor<float>::empty({ m, n });
+    EXPECT_THROW(Tensile::matmul_streamed(a, a, c), std::invalid_argument);
+    EXPECT_THROW(Tensile::matmul_streamed(b.transpose(), a.transpose(), c), std::invalid_argument);
+
+    for (auto name : { "a.bin", "b.bin", "c.bin" })
+        std::remove(temp_path(name).c_str());
+}
+
+TEST(StreamTests, Reductions)
+{
+    const size_t rows = 300, cols = 2500;
+    auto x = file_matrix(temp_path("x.bin"), rows, cols, 3);
+    x.data()[7 * cols + 11] = 9.0f;
+    x.data()[123 * cols + 2000] = -9.0f;
+
+    vector<double> row_sums(rows), col_sums(cols);
+    for (size_t r = 0; r < rows; r++)
+        for (size_t c = 0; c < cols; c++) {
+            row_sums[r] += x.data()[r * cols + c];
+            col_sums[c] += x.data()[r * cols + c];
+        }
+
+    StreamOptions small { .memory_budget = 100 << 10 };
+    for (size_t axis : { 0, 1 }) {
+        auto sum = Tensile::reduce_streamed(x, axis, ReduceOp::SUM, small);
+        const auto& expected = axis == 0 ? col_sums : row_sums;
+        ASSERT_EQ(sum.size(), expected.size());
+        for (size_t i = 0; i < sum.size(); i++)
+            ASSERT_NEAR(sum.data()[i], expected[i], 1e-3);
+
+        auto mean = Tensile::reduce_streamed(x, axis, ReduceOp::MEAN, small);
+        EXPECT_NEAR(mean.data()[3], expected[3] / (double)(axis == 0 ? rows : cols), 1e-5);
+    }
+
+    EXPECT_EQ(Tensile::reduce_streamed(x, 0, ReduceOp::MAX, small).data()[11], 9.0f);
+    EXPECT_EQ(Tensile::reduce_streamed(x, 1, ReduceOp::MAX, small).data()[7], 9.0f);
+    EXPECT_EQ(Tensile::reduce_streamed(x, 0, ReduceOp::MIN, small).data()[2000], -9.0f);
+    EXPECT_EQ(Tensile::reduce_streamed(x, 1, ReduceOp::MIN, small).data()[123], -9.0f);
+
+    // A single long line is split over the threads.
+    auto flat = x.view({ rows * cols });
+    auto total = Tensile::reduce_streamed(flat, 0, ReduceOp::SUM, small);
+    ASSERT_EQ(total.n_dims(), 1);
+    double expected = 0;
+    for (size_t i = 0; i < rows * cols; i++)
+        expected += x.data()[i];
+    EXPECT_NEAR(total.data()[0], expected, 1e-2);
+
+    x.data()[5] = std::numeric_limits<float>::quiet_NaN();
+    EXPECT_TRUE(std::isnan(Tensile::reduce_streamed(x, 1, ReduceOp::MAX, small).data()[0]));
+    EXPECT_THROW(Tensile::reduce_streamed(x, 2, ReduceOp::SUM), std::invalid_argument);
+    EXPECT_THROW(Tensile::reduce_streamed(x.transpose(), 0, ReduceOp::SUM), std::invalid_argument);
+
+    std::remove(temp_path("x.bin").c_str());
+}
+
+TEST(StreamTests, ReductionsAreRepeatable)
+{
+    // One long line is split into parts per tile; their partial sums must be merged in a fixed order.
+    auto x = Tensor<float>::empty({ 1 << 20 });
+    for (size_t i = 0; i < x.size(); i++)
+        x.data()[i] = 0.1f * (float)((int)(i * 7 % 17) - 8) + 1e-3f * (float)(i % 1001);
+
+    StreamOptions small { .memory_budget = 1 << 20 };
+    float first = Tensile::reduce_streamed(x, 0, ReduceOp::SUM, small).data()[0];
+    for (int run = 0; run < 20; run++)
+        ASSERT_EQ(Tensile::reduce_streamed(x, 0, ReduceOp::SUM, small).data()[0], first) << run;
+}
@@ -1,5 +1,7 @@
 #include "test_utils.h"
 
+#include <cmath>
+#include <gtest/gtest.h>
 #include <numeric>
 
 size_t flat_size(const std::vector<size_t>& shape)
@@ -16,4 +18,38 @@ Tensile::Tensor<int> create_tensor(const std::vector<size_t>& shape)
         data[i] = i;
 
     return Tensile::Tensor<int>(data, shape);
-}
\ No newline at end of file
+}
+
+Tensile::Tensor<float> float_tensor(const std::vector<size_t>& shape, FloatPattern pattern, size_t seed)
+{
+    size_t len = flat_size(shape);
+    float* data = new float[len];
+
+    int half = (int)(pattern.modulus / 2);
+    for (size_t i = 0; i < len; i++)
+        data[i] = pattern.scale * (float)((int)((i * pattern.step + seed) % pattern.modulus) - half);
+
+    return Tensile::Tensor<float>(data, shape);
+}
+
+Tensile::Tensor<float> float_tensor(const std::vector<size_t>& shape, size_t seed)
+{
+    return float_tensor(shape, FloatPattern {}, seed);
+}
+
+void expect_near(const Tensile::Tensor<float>& actual, const std::vector<float>& expected, float tol)
+{
+    auto contiguous = actual.contiguous();
+    ASSERT_EQ(contiguous.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++)
+        ASSERT_NEAR(contiguous.data()[i], expected[i], tol * (1 + std::abs(expected[i]))) << "at " << i;
+}
+
+void expect_near(const Tensile::Tensor<float>& actual, const Tensile::Tensor<float>& expected, float tol)
+{
+    ASSERT_EQ(actual.n_dims(), expected.n_dims());
+    ASSERT_EQ(actual.shape(), expected.shape());
+
+    auto e = expected.contiguous();
+    expect_near(actual, std::vector<float>(e.data(), e.data() + e.size()), tol);
+}
@@ -6,4 +6,31 @@
 #include "tensile/tensor.h"
 
 size_t flat_size(const std::vector<size_t>& shape);
-Tensile::Tensor<int> create_tensor(const std::vector<size_t>& shape);
\ No newline at end of file
+Tensile::Tensor<int> create_tensor(const std::vector<size_t>& shape);
+
+// Tensor whose element i, in row-major order, is fn(i).
+template <typename T, typename Fn> Tensile::Tensor<T> fill_tensor(const std::vector<size_t>& shape, Fn fn)
+{
+    size_t len = flat_size(shape);
+    T* data = new T[len];
+
+    for (size_t i = 0; i < len; i++)
+        data[i] = (T)fn(i);
+
+    return Tensile::Tensor<T>(data, shape);
+}
+
+// Parameters of float_tensor(): element i is scale * ((i * step + seed) % modulus - modulus / 2), a repeating pattern
+// of small values that reaches every vector lane position without depending on a random generator.
+struct FloatPattern {
+    float scale = 0.05f;
+    size_t modulus = 17;
+    size_t step = 7;
+};
+
+Tensile::Tensor<float> float_tensor(const std::vector<size_t>& shape, FloatPattern pattern, size_t seed = 0);
+Tensile::Tensor<float> float_tensor(const std::vector<size_t>& shape, size_t seed = 0);
+
+// Asserts |actual - expected| <= tol * (1 + |expected|) for every element, taking `actual` in row-major order.
+void expect_near(const Tensile::Tensor<float>& actual, const std::vector<float>& expected, float tol = 1e-4f);
+void expect_near(const Tensile::Tensor<float>& actual, const Tensile::Tensor<float>& expected, float tol = 1e-4f);